@@ -0,0 +1,200 @@
+// Arena.cpp
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// An Arena hands out memory from large blocks by moving a pointer forward,
+// so each allocation is a few instructions and needs no matching delete.
+// Everything allocated from an Arena is released together when the Arena is
+// released or destructed, without visiting the individual allocations. The
+// objects placed in an Arena must therefore not need their destructors run.
+// Blocks start small and double in size up to the block size limit, and the
+// Arena keeps counts of what it has handed out so the limit can be tuned.
+// Characters, which need no alignment, are handed out from the other end
+// of the current block, so they are packed without padding and what is
+// allocated from the front stays aligned.
+// 
+// Inputs: 
+// -- Requests for a number of bytes
+//
+// Outputs:
+// -- Pointers to memory aligned for any type
+// -- Stats on the memory allocated and reserved
+//
+// Assumptions:
+// -- Objects allocated are trivially destructible or do not need destructing
+// 
+// Major algorithms & key variables:
+// Algorithms: Bump pointer allocation
+// Key Variables: Block* blocks; char* next, limit; size_t maxBlockSize
+
+#include "Arena.h"
+#include <iostream>
+#include <cstdlib>
+
+//--------------------------------------------------------------------------
+// Arena();
+// Constructor for Arena
+// Preconditions: None
+// Postconditions: Arena exists with no blocks
+// Return value: None
+// Functions called: None
+Arena::Arena() {
+   blocks = nullptr;
+   next = nullptr;
+   limit = nullptr;
+   nextBlockSize = FIRST_BLOCK_SIZE;
+   maxBlockSize = DEFAULT_MAX_BLOCK_SIZE;
+   bytesAllocated = 0;
+   bytesReserved = 0;
+   numAllocations = 0;
+   numBlocks = 0;
+}
+
+//--------------------------------------------------------------------------
+// ~Arena();
+// Destructor for Arena
+// Preconditions: Arena exists
+// Postconditions: All memory allocated from the Arena is released
+// Return value: None
+// Functions called: release
+Arena::~Arena() {
+   release();
+}
+
+//--------------------------------------------------------------------------
+// void newBlock(size_t atLeast);
+// Allocates a new block of at least atLeast bytes to allocate from
+// Preconditions: Memory available
+// Postconditions: next and limit refer to the new block
+// Return value: None -- will quit if out of memory
+// Functions called: None
+void Arena::newBlock(size_t atLeast) {
+   // the Block header takes the first ALIGNMENT bytes so that what follows
+   // stays aligned
+   size_t header = (sizeof(Block) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+   size_t size = nextBlockSize;
+   if (size < atLeast + header) {
+      size = atLeast + header;
+   }
+   char* memory = static_cast<char*>(malloc(size));
+   if (memory == nullptr) {
+      cout << "You are out of memory.\n";
+      exit(0);
+   }
+   Block* block = reinterpret_cast<Block*>(memory);
+   block->previous = blocks;
+   block->size = size;
+   blocks = block;
+   next = memory + header;
+   limit = memory + size;
+   bytesReserved += size;
+   numBlocks++;
+   if (nextBlockSize < maxBlockSize) {
+      nextBlockSize *= 2;
+      if (nextBlockSize > maxBlockSize) {
+         nextBlockSize = maxBlockSize;
+      }
+   }
+}
+
+//--------------------------------------------------------------------------
+// void release();
+// Frees every block, and with them everything allocated from the Arena
+// Preconditions: Arena exists
+// Postconditions: Arena has no blocks, stats reset
+// Return value: None
+// Functions called: None
+void Arena::release() {
+   while (blocks != nullptr) {
+      Block* toFree = blocks;
+      blocks = blocks->previous;
+      free(toFree);
+   }
+   next = nullptr;
+   limit = nullptr;
+   nextBlockSize = FIRST_BLOCK_SIZE;
+   bytesAllocated = 0;
+   bytesReserved = 0;
+   numAllocations = 0;
+   numBlocks = 0;
+}
+
+//--------------------------------------------------------------------------
+// void adopt(Arena& other);
+// Takes ownership of other's blocks so that what was allocated from other
+// lives as long as this Arena.
+// Preconditions: Both Arenas exist
+// Postconditions: other has no blocks, stats moved to this Arena
+// Return value: None
+// Functions called: None
+void Arena::adopt(Arena& other) {
+   if (&other == this || other.blocks == nullptr) {
+      return;
+   }
+   // the list of blocks is only walked to free them, so other's blocks can
+   // go on the front while allocation carries on from the current block
+   Block* oldest = other.blocks;
+   while (oldest->previous != nullptr) {
+      oldest = oldest->previous;
+   }
+   oldest->previous = blocks;
+   blocks = other.blocks;
+   if (next == nullptr) {
+      next = other.next;
+      limit = other.limit;
+   }
+   bytesAllocated += other.bytesAllocated;
+   bytesReserved += other.bytesReserved;
+   numAllocations += other.numAllocations;
+   numBlocks += other.numBlocks;
+
+   other.blocks = nullptr;
+   other.next = nullptr;
+   other.limit = nullptr;
+   other.nextBlockSize = FIRST_BLOCK_SIZE;
+   other.bytesAllocated = 0;
+   other.bytesReserved = 0;
+   other.numAllocations = 0;
+   other.numBlocks = 0;
+}
+
+//--------------------------------------------------------------------------
+// void setMaxBlockSize(size_t bytes);
+// Sets the largest block the Arena will grow to
+// Preconditions: Arena exists
+// Postconditions: Blocks allocated from now on are at most bytes large,
+//                 unless a single allocation needs more
+// Return value: None
+// Functions called: None
+void Arena::setMaxBlockSize(size_t bytes) {
+   maxBlockSize = bytes;
+   if (nextBlockSize > maxBlockSize) {
+      nextBlockSize = maxBlockSize;
+   }
+}
+
+//--------------------------------------------------------------------------
+// size_t getMaxBlockSize() const;
+// Preconditions: Arena exists
+// Postconditions: Arena unchanged
+// Return value: The largest block the Arena will grow to
+// Functions called: None
+size_t Arena::getMaxBlockSize() const {
+   return maxBlockSize;
+}
+
+//--------------------------------------------------------------------------
+// Stats getStats() const;
+// Preconditions: Arena exists
+// Postconditions: Arena unchanged
+// Return value: Bytes handed out, bytes held in blocks, number of
+//               allocations and number of blocks
+// Functions called: None
+Arena::Stats Arena::getStats() const {
+   Stats toReturn;
+   toReturn.bytesAllocated = bytesAllocated;
+   toReturn.bytesReserved = bytesReserved;
+   toReturn.numAllocations = numAllocations;
+   toReturn.numBlocks = numBlocks;
+   return toReturn;
+}
@@ -0,0 +1,192 @@
+// Arena.h
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// An Arena hands out memory from large blocks by moving a pointer forward,
+// so each allocation is a few instructions and needs no matching delete.
+// Everything allocated from an Arena is released together when the Arena is
+// released or destructed, without visiting the individual allocations. The
+// objects placed in an Arena must therefore not need their destructors run.
+// Blocks start small and double in size up to the block size limit, and the
+// Arena keeps counts of what it has handed out so the limit can be tuned.
+// Characters, which need no alignment, are handed out from the other end
+// of the current block, so they are packed without padding and what is
+// allocated from the front stays aligned.
+// 
+// Inputs: 
+// -- Requests for a number of bytes
+//
+// Outputs:
+// -- Pointers to memory aligned for any type
+// -- Stats on the memory allocated and reserved
+//
+// Assumptions:
+// -- Objects allocated are trivially destructible or do not need destructing
+// 
+// Major algorithms & key variables:
+// Algorithms: Bump pointer allocation
+// Key Variables: Block* blocks; char* next, limit; size_t maxBlockSize
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+using namespace std;
+
+class Arena {
+
+private:
+   struct Block {
+      Block* previous;
+      size_t size;
+   };
+   Block* blocks;
+   char* next;
+   char* limit;
+   size_t nextBlockSize;
+   size_t maxBlockSize;
+   size_t bytesAllocated;
+   size_t bytesReserved;
+   size_t numAllocations;
+   size_t numBlocks;
+
+   static const size_t FIRST_BLOCK_SIZE = 16 * 1024;
+   static const size_t ALIGNMENT = alignof(max_align_t);
+
+   //--------------------------------------------------------------------------
+   // void newBlock(size_t atLeast);
+   // Allocates a new block of at least atLeast bytes to allocate from
+   // Preconditions: Memory available
+   // Postconditions: next and limit refer to the new block
+   // Return value: None -- will quit if out of memory
+   // Functions called: None
+   void newBlock(size_t atLeast);
+
+   // an Arena owns its blocks and is never copied
+   Arena(const Arena&);
+   Arena& operator=(const Arena&);
+
+public:
+   struct Stats {
+      size_t bytesAllocated;
+      size_t bytesReserved;
+      size_t numAllocations;
+      size_t numBlocks;
+   };
+
+   static const size_t DEFAULT_MAX_BLOCK_SIZE = 1024 * 1024;
+
+   //--------------------------------------------------------------------------
+   // Arena();
+   // Constructor for Arena
+   // Preconditions: None
+   // Postconditions: Arena exists with no blocks
+   // Return value: None
+   // Functions called: None
+   Arena();
+
+   //--------------------------------------------------------------------------
+   // ~Arena();
+   // Destructor for Arena
+   // Preconditions: Arena exists
+   // Postconditions: All memory allocated from the Arena is released
+   // Return value: None
+   // Functions called: release
+   ~Arena();
+
+   //--------------------------------------------------------------------------
+   // void* allocate(size_t bytes);
+   // Allocates bytes from the current block, starting a new block if the
+   // current one does not have room.
+   // Preconditions: Arena exists
+   // Postconditions: bytes reserved until the Arena is released
+   // Return value: Pointer aligned for any type (will quit if out of memory)
+   // Functions called: newBlock
+   void* allocate(size_t bytes) {
+      size_t rounded = (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+      if (size_t(limit - next) < rounded) {
+         newBlock(rounded);
+      }
+      void* toReturn = next;
+      next += rounded;
+      bytesAllocated += bytes;
+      numAllocations++;
+      return toReturn;
+   }
+
+   //--------------------------------------------------------------------------
+   // char* allocateBytes(size_t bytes);
+   // Allocates bytes with no alignment from the end of the current block,
+   // starting a new block if the current one does not have room.
+   // Preconditions: Arena exists
+   // Postconditions: bytes reserved until the Arena is released
+   // Return value: Pointer to the bytes (will quit if out of memory)
+   // Functions called: newBlock
+   char* allocateBytes(size_t bytes) {
+      if (size_t(limit - next) < bytes) {
+         newBlock(bytes);
+      }
+      limit -= bytes;
+      bytesAllocated += bytes;
+      numAllocations++;
+      return limit;
+   }
+
+   //--------------------------------------------------------------------------
+   // template <typename Type> Type* make();
+   // Allocates and default constructs a Type in the Arena
+   // Preconditions: Arena exists
+   // Postconditions: Type constructed, will not be destructed
+   // Return value: Type* (will quit if out of memory)
+   // Functions called: allocate
+   template <typename Type>
+   Type* make() {
+      return new (allocate(sizeof(Type))) Type();
+   }
+
+   //--------------------------------------------------------------------------
+   // void release();
+   // Frees every block, and with them everything allocated from the Arena
+   // Preconditions: Arena exists
+   // Postconditions: Arena has no blocks, stats reset
+   // Return value: None
+   // Functions called: None
+   void release();
+
+   //--------------------------------------------------------------------------
+   // void adopt(Arena& other);
+   // Takes ownership of other's blocks so that what was allocated from other
+   // lives as long as this Arena.
+   // Preconditions: Both Arenas exist
+   // Postconditions: other has no blocks, stats moved to this Arena
+   // Return value: None
+   // Functions called: None
+   void adopt(Arena& other);
+
+   //--------------------------------------------------------------------------
+   // void setMaxBlockSize(size_t bytes);
+   // Sets the largest block the Arena will grow to
+   // Preconditions: Arena exists
+   // Postconditions: Blocks allocated from now on are at most bytes large,
+   //                 unless a single allocation needs more
+   // Return value: None
+   // Functions called: None
+   void setMaxBlockSize(size_t bytes);
+
+   //--------------------------------------------------------------------------
+   // size_t getMaxBlockSize() const;
+   // Preconditions: Arena exists
+   // Postconditions: Arena unchanged
+   // Return value: The largest block the Arena will grow to
+   // Functions called: None
+   size_t getMaxBlockSize() const;
+
+   //--------------------------------------------------------------------------
+   // Stats getStats() const;
+   // Preconditions: Arena exists
+   // Postconditions: Arena unchanged
+   // Return value: Bytes handed out, bytes held in blocks, number of
+   //               allocations and number of blocks
+   // Functions called: None
+   Stats getStats() const;
+};
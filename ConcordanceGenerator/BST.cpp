@@ -3,31 +3,51 @@
 // Date: 
 // Description:
 // This binary search tree is composed of BSTNodes that have a string keyword, 
-// a LinkedList<PrePost> where PrePost contain the concordance in the form
-// of two strings, and a left and a right pointer to subtrees. The parts of 
-// this produce a concordance, whereby a reader may know the preceeding and 
-// subsequent words around a keyword. Displaying the keyword will be
-// truncated to size KEYWORD_WIDTH and preKey and postKey concordance
-// will be truncated to size CONCORD_WIDTH.
+// Postings locating each occurrence of the keyword by the offset of the
+// word in the source text, and a left and a right pointer to subtrees.
+// The parts of this produce a concordance, whereby a
+// reader may know the preceeding and subsequent words around a keyword. The
+// words either side of an occurrence are only read from the
+// source text when it is displayed, so the tree never holds copies of them.
+// Each occurrence is displayed as a row by a ConcordWriter. An Iterator
+// walks the keywords in order from any starting word with a stack of the
+// BSTNodes still to visit, so a query for one keyword, a prefix or a range
+// visits only the BSTNodes it displays and the path down to them. BSTNodes,
+// their keywords and the Chunks of their Postings are all allocated from the
+// BST's Arena, so adding is a pointer bump and destructing the BST releases
+// the Arena's blocks without visiting each BSTNode. The tree is kept balanced
+// as an AVL tree: every BSTNode records the height of its subtree and any
+// insert that leaves two sibling subtrees differing in height by more than one
+// is fixed with a rotation, so inserts and searches are always O(log n) even
+// when the keywords arrive in sorted order. A BST can instead be built in
+// one pass from the Records of a KeywordSorter, already sorted, linking the
+// BSTNodes into a balanced tree as they are made without one comparison.
 // 
 // Inputs: 
-// -- PrePost objects of preKey and postKeys
-// -- BSTNodes containing a string, LinkedList<PrePost>, and two BSTNode*
+// -- The Corpus the keywords were read from
+// -- The offset of each keyword in the Corpus
+// -- BSTNodes containing a string, Postings, and two BSTNode*
 //
 // Outputs:
 // -- Displaying the entire tree including each BSTNode and for each the 
-//    corresponding LinkedList<PrePost>.
+//    corresponding Postings.
 //
 // Assumptions:
 // -- BSTNodes have correct data input
 // 
 // Major algorithms & key variables:
-// Algorithms: searching a binary search tree
-// Key Variables: string keyword, preKey, postKey; LinkedList<PrePost> concord,
-// CONCORD_WITDH
+// Algorithms: searching a binary search tree, AVL rotations, in-order 
+// iteration with an explicit stack
+// Key Variables: const char* keyword; size_t offset; Postings concord,
+// Arena arena
 
 #include "BST.h"
-#include <iomanip>
+#include "ConcordWriter.h"
+#include "RunStats.h"
+#include "KeywordQuery.h"
+#include "KeywordSorter.h"
+#include <vector>
+#include <cstring>
 
 //--------------------------------------------------------------------------
 // BST();
@@ -38,187 +58,555 @@
 // Functions called: None
 BST::BST() {
    root = nullptr;
+   corpus = nullptr;
+   showSources = false;
+   numNodes = 0;
+   numComparisons = 0;
 }
 
 //--------------------------------------------------------------------------
 // ~BST();
 // Destructs BST
 // Preconditions: BST exists
-// Postconditions: BST does not exist
+// Postconditions: BST does not exist, Arena released
 // Return value: None
-// Functions called: destroyTree()
+// Functions called: release()
 BST::~BST() {
-   if (isEmpty()) { return; }
-   destroyTree(root);
+   root = nullptr;
+   arena.release();
+}
+
+//--------------------------------------------------------------------------
+// static int compareKey(const char* key, size_t length, 
+//                       const BSTNode* node);
+// Compares key to node's keyword in the same order as string::compare
+// Preconditions: node exists
+// Postconditions: None
+// Return value: Negative if key comes first, 0 if equal, positive if after
+// Functions called: None
+int BST::compareKey(const char* key, size_t length, const BSTNode* node) {
+   size_t shorter = length;
+   if (node->keyLength < shorter) {
+      shorter = node->keyLength;
+   }
+   int compared = memcmp(key, node->keyword, shorter);
+   if (compared != 0) {
+      return compared;
+   }
+   if (length < node->keyLength) {
+      return -1;
+   }
+   if (length > node->keyLength) {
+      return 1;
+   }
+   return 0;
 }
 
 //--------------------------------------------------------------------------
-// void destroyTree(BSTNode* subTreePtr);
-// Taken from Carrano et al.: method used to destruct a BST
+// void setCorpus(const Corpus* theCorpus);
+// Sets the Corpus that keyword offsets refer into
+// Preconditions: BST exists, theCorpus stays open while displayed
+// Postconditions: Concordances are read from theCorpus
+// Return value: None
+// Functions called: None
+void BST::setCorpus(const Corpus* theCorpus) {
+   corpus = theCorpus;
+}
+
+//--------------------------------------------------------------------------
+// void setShowSources(bool show);
+// Sets whether each concordance is followed by the name of its document
+// and the position of the keyword in that document
 // Preconditions: BST exists
-// Postconditions: BST is destructed
+// Postconditions: Concordances displayed from now on show their source
+//                 if show
 // Return value: None
-// Functions called: Recursive call to itself
-void BST::destroyTree(BSTNode* subTreePtr) {
-   if (subTreePtr != nullptr)
-   {
-      destroyTree(subTreePtr->left);
-      destroyTree(subTreePtr->right);
-      delete subTreePtr;
-   }
-} 
+// Functions called: None
+void BST::setShowSources(bool show) {
+   showSources = show;
+}
+
+//--------------------------------------------------------------------------
+// void setLayout(const ConcordWriter::Layout& newLayout);
+// Sets how many words are shown either side of each keyword and how wide
+// the concordances and keyword are
+// Preconditions: Every number of newLayout is at least 1
+// Postconditions: Concordances displayed from now on follow newLayout
+// Return value: None
+// Functions called: None
+void BST::setLayout(const ConcordWriter::Layout& newLayout) {
+   layout = newLayout;
+}
 
 //--------------------------------------------------------------------------
 // void displayTree();
-// Display all the BST's key with all concordances within the 
-// LinkedList<PrePost>
+// Display all the BST's key with all concordances within the Postings
 // Preconditions: BST exists
 // Postconditions: BST unchanged
 // Return value: Outputs the entire 
-// Functions called: display()
+// Functions called: next(), displayNode()
 void BST::displayTree() {
-   display(root);
+   ConcordWriter writer(cout);
+   writer.setCorpus(corpus);
+   writer.setShowSources(showSources);
+   writer.setLayout(layout);
+   for (Iterator at(*this); at.isValid(); at.next()) {
+      displayNode(at.node(), writer);
+   }
 }
 
 //--------------------------------------------------------------------------
-// void display(BSTNode* root);
-// Display the key with all concordances within the LinkedList<PrePost>
-// Preconditions: BST exists
+// static void displayNode(const BSTNode* top, ConcordWriter& writer);
+// Display the key with all concordances within the Postings
+// Preconditions: top exists
 // Postconditions: BST unchanged
-// Return value: Outputs the entire 
-// Functions called: Recursive call to itself
-void BST::display (const BSTNode* top) {
-   if (top != nullptr) {
-      display(top->left);
-      //display the linked list with the key in the middle
-      string keyToPrint = top->keyword;  
-      // Must cast the length as a signed int, as .length() returns an 
-      // unsigned int (size_t) and C++ makes the assumption that 
-      // resulting int of the subtraction is unsigned and then allows 
-      // bit shift on unsigned ints. This causes a drop of the signed 
-      // bit and thus incredibly high, positive numSpaces which will 
-      // then attempt to add billions of spaces in the next for loop. 
-      // Therefore, MUST CAST.
-      int numSpaces = (KEYWORD_WIDTH - int(top->keyword.length())) / 2;
-      // for centering purposes, append the end of the string with half of 
-      // the difference in length between this and output.
-      for (int i = 0; i < numSpaces; i++) {
-         keyToPrint.append(" ");
-      }
-      // if the keyword won't fit into the width, then truncate
-      if (top->keyword.length() > KEYWORD_WIDTH) {
-         keyToPrint = top->keyword.substr(0, KEYWORD_WIDTH-1);
+// Return value: None
+// Functions called: setKeyword, writeConcord
+void BST::displayNode(const BSTNode* top, ConcordWriter& writer) {
+   //display the Postings with the key in the middle
+   writer.setKeyword(top->keyword, top->keyLength);
+   // go through the entire Postings that are the concordances and print
+   // all concordances for that key
+   for (Postings::Iterator at(top->concord); at.isValid(); at.next()) {
+      writer.writeConcord(at.offset());
+   }
+}
+
+//--------------------------------------------------------------------------
+// size_t displayQuery(const KeywordQuery& query, string& next);
+// Display the concordances of the keywords matching query, visiting only
+// those keywords, up to the query's limit
+// Preconditions: BST exists
+// Postconditions: BST unchanged, next is the first matching keyword left
+//                 undisplayed by the limit, or empty if there is none
+// Return value: Number of keywords displayed
+// Functions called: seek, isPastEnd, next, displayNode
+size_t BST::displayQuery(const KeywordQuery& query, string& next) {
+   ConcordWriter writer(cout);
+   writer.setCorpus(corpus);
+   writer.setShowSources(showSources);
+   writer.setLayout(layout);
+   size_t displayed = 0;
+   next.clear();
+   Iterator at(*this);
+   at.seek(query.start().data(), query.start().length());
+   while (at.isValid() && !query.isPastEnd(at.keyword(), at.keyLength())) {
+      if (displayed == query.getLimit()) {
+         next.assign(at.keyword(), at.keyLength());
+         break;
       }
+      displayNode(at.node(), writer);
+      displayed++;
+      at.next();
+   }
+   return displayed;
+}
 
-      //display the pre and post key as first CONCORD_WIDTH characters
-      LinkedList<PrePost>::Node* current;
-      current = top->concord.head;
-      string preConcord;
-      string postConcord;
-      // go through the entire LinkedList that is concordance and print
-      // all concordances for that key
-      while (current!=nullptr) {
-         preConcord = current->data->preKey;
-         postConcord = current->data->postKey;
-         if (preConcord.length() > CONCORD_WIDTH) {
-            preConcord = preConcord.substr(0, CONCORD_WIDTH - 1);
-         }
-         if (postConcord.length() > CONCORD_WIDTH) {
-            postConcord = postConcord.substr(0, CONCORD_WIDTH - 1);
-         }
-         cout << "|" << right << setw(CONCORD_WIDTH) << preConcord;
-         cout << "|" << setw(KEYWORD_WIDTH) << keyToPrint;
-         cout << "|" << left << setw(CONCORD_WIDTH) << postConcord;
-         cout << "|" << endl;
-         current = current->next;
+//--------------------------------------------------------------------------
+// Iterator(const BST& theTree);
+// Constructor for an Iterator at the first keyword of theTree
+// Preconditions: theTree exists and is not changed while iterating
+// Postconditions: Iterator at the least keyword
+// Return value: None
+// Functions called: pushLeft
+BST::Iterator::Iterator(const BST& theTree) {
+   tree = &theTree;
+   depth = 0;
+   pushLeft(theTree.root);
+}
+
+//--------------------------------------------------------------------------
+// void pushLeft(BSTNode* top);
+// Pushes top and every left child below it onto the stack
+// Preconditions: Iterator exists
+// Postconditions: The least BSTNode under top is on top of the stack
+// Return value: None
+// Functions called: None
+void BST::Iterator::pushLeft(BSTNode* top) {
+   while (top != nullptr) {
+      stack[depth++] = top;
+      top = top->left;
+   }
+}
+
+//--------------------------------------------------------------------------
+// void seek(const char* key, size_t length);
+// Moves to the first keyword that is not less than key. Every BSTNode the
+// search goes left from is not less than key, and those are exactly the
+// BSTNodes an in-order walk from there still has to visit.
+// Preconditions: Iterator exists
+// Postconditions: Iterator at that keyword, or past the end
+// Return value: None
+// Functions called: compareKey
+void BST::Iterator::seek(const char* key, size_t length) {
+   depth = 0;
+   BSTNode* current = tree->root;
+   while (current != nullptr) {
+      int compared = compareKey(key, length, current);
+      if (compared == 0) {
+         stack[depth++] = current;
+         return;
+      }
+      if (compared < 0) {
+         stack[depth++] = current;
+         current = current->left;
+      }
+      else {
+         current = current->right;
       }
-      display(top->right);
    }
 }
 
 //--------------------------------------------------------------------------
-// bool addBSTNode(string toAdd, string pre, string post);
-// Adds BSTNode to the tree
+// bool isValid() const;
+// Preconditions: Iterator exists
+// Postconditions: Iterator unchanged
+// Return value: True if at a keyword, false if past the last keyword
+// Functions called: None
+bool BST::Iterator::isValid() const {
+   return depth > 0;
+}
+
+//--------------------------------------------------------------------------
+// void next();
+// Moves to the following keyword in sorted order
+// Preconditions: isValid()
+// Postconditions: Iterator at the next keyword, or past the end
+// Return value: None
+// Functions called: pushLeft
+void BST::Iterator::next() {
+   BSTNode* done = stack[--depth];
+   pushLeft(done->right);
+}
+
+//--------------------------------------------------------------------------
+// BSTNode* node() const;
+// Preconditions: isValid()
+// Postconditions: Iterator unchanged
+// Return value: The current BSTNode
+// Functions called: None
+BST::BSTNode* BST::Iterator::node() const {
+   return stack[depth - 1];
+}
+
+//--------------------------------------------------------------------------
+// const char* keyword() const;
+// Preconditions: isValid()
+// Postconditions: Iterator unchanged
+// Return value: The characters of the current keyword
+// Functions called: None
+const char* BST::Iterator::keyword() const {
+   return stack[depth - 1]->keyword;
+}
+
+//--------------------------------------------------------------------------
+// size_t keyLength() const;
+// Preconditions: isValid()
+// Postconditions: Iterator unchanged
+// Return value: The length of the current keyword
+// Functions called: None
+size_t BST::Iterator::keyLength() const {
+   return stack[depth - 1]->keyLength;
+}
+
+//--------------------------------------------------------------------------
+// void addKeyword(const string& toAdd, size_t offset);
+// Adds BSTNode to the tree, or adds the concordance to the existing 
+// BSTNode for the keyword. The tree is rebalanced on the way back up.
 // Preconditions: BST exists
-// Postconditions: One BSTNode has been added
-// Return value: None -- will break if out of memory
-// Functions called: newBSTNode()
-void BST::addBSTNode(string toAdd, string pre, string post) {
-   PrePost* newData = new PrePost;
-   newData->preKey = pre;
-   newData->postKey = post;
-   if (isEmpty()) {
-      BSTNode* newNode = newBSTNode(toAdd, newData);
-      root = newNode;
-   } 
-   else {
-      BSTNode* toInsert = searchBST(root, toAdd);
+// Postconditions: One BSTNode has been added, tree balanced
+// Return value: None -- will quit if out of memory (based on newBSTNode())
+// Functions called: findOrAddBSTNode()
+void BST::addKeyword(const string& toAdd, size_t offset) {
+   findOrAddBSTNode(toAdd.data(), toAdd.length())->concord.add(offset, arena);
+}
+
+//--------------------------------------------------------------------------
+// BSTNode* findOrAddBSTNode(const char* toAdd, size_t length);
+// Finds the BSTNode for the keyword, adding a BSTNode with no concordances
+// if there is none. The tree is rebalanced on the way back up.
+// Preconditions: BST exists
+// Postconditions: A BSTNode for toAdd exists, tree balanced
+// Return value: BSTNode* for toAdd (will quit if out of memory)
+// Functions called: compareKey(), newBSTNode(), rebalance()
+BST::BSTNode* BST::findOrAddBSTNode(const char* toAdd, size_t length) {
+   // remember each link followed from the root so that the path can be
+   // rebalanced from the bottom up once the new BSTNode is in place
+   BSTNode** path[MAX_HEIGHT];
+   int depth = 0;
+   BSTNode** link = &root;
+   while (*link != nullptr) {
+      BSTNode* current = *link;
+      int compared = compareKey(toAdd, length, current);
       //check to see if node already there
-      if (toAdd == toInsert->keyword) {
-         toInsert->concord.addLast(newData);
+      if (compared == 0) {
+         numComparisons += size_t(depth) + 1;
+         return current;
       }
-      //check if less than, left insert
-      else if (toAdd < toInsert->keyword) {
-         BSTNode* newNode = newBSTNode(toAdd, newData);
-         toInsert->left = newNode;
+      path[depth] = link;
+      depth++;
+      //check if less than, left insert, otherwise right insert
+      if (compared < 0) {
+         link = &current->left;
       }
-      //otherwise, right insert
       else {
-         BSTNode* newNode = newBSTNode(toAdd, newData);
-         toInsert->right = newNode;
+         link = &current->right;
+      }
+   }
+   numComparisons += size_t(depth);
+   BSTNode* newNode = newBSTNode(toAdd, length);
+   *link = newNode;
+   numNodes++;
+   // once a subtree's height is unchanged nothing above it can change.
+   // Rotations move the links around newNode but never newNode itself.
+   while (depth > 0) {
+      depth--;
+      BSTNode*& subTree = *path[depth];
+      int oldHeight = subTree->height;
+      rebalance(subTree);
+      if (subTree->height == oldHeight) {
+         break;
       }
    }
+   return newNode;
+}
+
+//--------------------------------------------------------------------------
+// void mergeTree(BST& other);
+// Moves every concordance in other into this BST. For keywords in both, 
+// other's concordances are placed after this BST's, so merging the trees
+// built from consecutive parts of a text in order gives the same tree as
+// building from the whole text.
+// Preconditions: Both BSTs exist and refer to the same Corpus
+// Postconditions: other is empty, this BST holds all concordances
+// Return value: None
+// Functions called: moveConcords(), adopt()
+void BST::mergeTree(BST& other) {
+   if (&other == this) {
+      return;
+   }
+   moveConcords(other);
+   numComparisons += other.numComparisons;
+   other.root = nullptr;
+   other.numNodes = 0;
+   other.numComparisons = 0;
+   // the moved Postings Chunks still live in other's Arena
+   arena.adopt(other.arena);
 }
 
 //--------------------------------------------------------------------------
-// BSTNode* searchBST(BSTNode* BSTRoot, const string keyword);
-// Searches the BSTNode BSTRoot to determine if a keyword exists. If it 
-// exists, then return a pointer to that node. However, if it doesn't exist,
-// return a pointer to the parent. Thus, must check while exiting which 
-// node is being returned.
+// void addSorted(const KeywordSorter& sorted);
+// Builds the BST from sorted Records in one pass: each keyword's Records
+// become a BSTNode with their offsets as its concordances, and the
+// BSTNodes, made in sorted order, are linked into a balanced tree
+// without comparing keywords.
+// Preconditions: BST is empty, sorted has been sorted
+// Postconditions: BST holds the same concordances as if each keyword
+//                 had been added in order of offset
+// Return value: None -- will quit if out of memory
+// Functions called: newBSTNode(), sameKeyword(), add(), linkBalanced()
+void BST::addSorted(const KeywordSorter& sorted) {
+   const KeywordSorter::Record* records = sorted.records();
+   size_t numRecords = sorted.size();
+   vector<BSTNode*> nodes;
+   size_t first = 0;
+   while (first < numRecords) {
+      BSTNode* top = newBSTNode(records[first].keyword,
+                                records[first].length);
+      size_t each = first;
+      do {
+         top->concord.add(records[each].offset, arena);
+         each++;
+      } while (each < numRecords &&
+               KeywordSorter::sameKeyword(records[each], records[first]));
+      nodes.push_back(top);
+      first = each;
+   }
+   numNodes += nodes.size();
+   root = linkBalanced(nodes.data(), nodes.size());
+}
+
+//--------------------------------------------------------------------------
+// void setArenaBlockSize(size_t bytes);
+// Sets the largest block the BST's Arena will grow to
 // Preconditions: BST exists
-// Postconditions: BST is unchanged
-// Return value: BSTNode
-// Functions called: Recursively calls itself
-BST::BSTNode* BST::searchBST( BSTNode* BSTroot, string keyword) {
-   // base case
-   if (isEmpty()) { 
-      return BSTroot; 
-   }
-   //base case 2: if equal, will also return.
-   else if (keyword == BSTroot->keyword){
-      return BSTroot;
-   }
-   //recursive left calls
-   else if (keyword < BSTroot->keyword) {
-      if (BSTroot->left == nullptr) { 
-         return BSTroot; 
-      }
-      return searchBST(BSTroot->left, keyword);
+// Postconditions: Arena blocks allocated from now on are at most bytes
+// Return value: None
+// Functions called: setMaxBlockSize()
+void BST::setArenaBlockSize(size_t bytes) {
+   arena.setMaxBlockSize(bytes);
+}
+
+//--------------------------------------------------------------------------
+// size_t getArenaBlockSize() const;
+// Preconditions: BST exists
+// Postconditions: BST unchanged
+// Return value: The largest block the BST's Arena will grow to
+// Functions called: getMaxBlockSize()
+size_t BST::getArenaBlockSize() const {
+   return arena.getMaxBlockSize();
+}
+
+//--------------------------------------------------------------------------
+// void copySettings(const BST& from);
+// Gives this BST the Arena block size of from, so that a BST built
+// from part of a text is built as from is
+// Preconditions: BST exists
+// Postconditions: Arena block size the same as from
+// Return value: None
+// Functions called: setArenaBlockSize(), getArenaBlockSize()
+void BST::copySettings(const BST& from) {
+   setArenaBlockSize(from.getArenaBlockSize());
+}
+
+//--------------------------------------------------------------------------
+// Arena::Stats getArenaStats() const;
+// Preconditions: BST exists
+// Postconditions: BST unchanged
+// Return value: Stats of the Arena holding the BST's BSTNodes
+// Functions called: getStats()
+Arena::Stats BST::getArenaStats() const {
+   return arena.getStats();
+}
+
+//--------------------------------------------------------------------------
+// void addStats(RunStats& stats) const;
+// Adds the number of BSTNodes, the height of the BST, the keyword
+// comparisons made building it, its occurrences, the bytes their
+// Postings take and what its Arena allocated to stats
+// Preconditions: BST exists
+// Postconditions: BST unchanged
+// Return value: None
+// Functions called: addCount, getStats, height, size, numBytes
+void BST::addStats(RunStats& stats) const {
+   Arena::Stats arenaStats = arena.getStats();
+   size_t numOccurrences = 0;
+   size_t postingBytes = 0;
+   for (Iterator at(*this); at.isValid(); at.next()) {
+      const BSTNode* top = at.node();
+      numOccurrences += top->concord.size();
+      postingBytes += top->concord.numBytes();
+   }
+   stats.addCount("tree nodes", numNodes);
+   stats.addCount("tree height", size_t(height(root)));
+   stats.addCount("key comparisons", numComparisons);
+   stats.addCount("occurrences", numOccurrences);
+   stats.addCount("posting bytes", postingBytes);
+   stats.addCount("arena allocations", arenaStats.numAllocations);
+   stats.addCount("arena bytes allocated", arenaStats.bytesAllocated);
+   stats.addCount("arena bytes reserved", arenaStats.bytesReserved);
+   stats.addCount("arena blocks", arenaStats.numBlocks);
+}
+
+//--------------------------------------------------------------------------
+// void moveConcords(const BST& other);
+// Moves the concordances of every BSTNode in other, in order, to the
+// BSTNode for the same keyword in this BST.
+// Preconditions: other is another BST
+// Postconditions: BSTNodes in other have empty concordances
+// Return value: None
+// Functions called: findOrAddBSTNode(), append(), next()
+void BST::moveConcords(const BST& other) {
+   for (Iterator at(other); at.isValid(); at.next()) {
+      BSTNode* top = at.node();
+      findOrAddBSTNode(top->keyword, top->keyLength)->concord.append(
+         top->concord);
+   }
+}
+
+//--------------------------------------------------------------------------
+// static int height(const BSTNode* subTree);
+// Preconditions: None
+// Postconditions: None
+// Return value: Height of subTree, 0 if subTree is nullptr
+// Functions called: None
+int BST::height(const BSTNode* subTree) {
+   if (subTree == nullptr) {
+      return 0;
+   }
+   return subTree->height;
+}
+
+//--------------------------------------------------------------------------
+// static void updateHeight(BSTNode* subTree);
+// Recomputes the height of subTree from its children
+// Preconditions: subTree exists, children's heights are correct
+// Postconditions: subTree's height is correct
+// Return value: None
+// Functions called: height()
+void BST::updateHeight(BSTNode* subTree) {
+   int leftHeight = height(subTree->left);
+   int rightHeight = height(subTree->right);
+   if (leftHeight > rightHeight) {
+      subTree->height = leftHeight + 1;
    }
-   //recursive right calls
    else {
-      if (BSTroot->right == nullptr) { 
-         return BSTroot; 
-      }
-      return searchBST(BSTroot->right, keyword);
+      subTree->height = rightHeight + 1;
    }
-   return nullptr;
 }
 
 //--------------------------------------------------------------------------
-// bool searchBSTKey(const string keyword);
-// Searches the BST in-order to find the keyword.
-// Preconditions: BST exists 
-// Postconditions: BST unchanged
-// Return value: True if keyword is found, false if otherwise
-// Functions called: searchBST()
-bool BST::searchBSTKey(const string keyword) {
-   BSTNode* toCheck = searchBST(root, keyword);
-   if (toCheck->keyword == keyword){
-      return true;
+// static void rotateLeft(BSTNode*& subTree);
+// Makes subTree's right child the new root of the subtree
+// Preconditions: subTree and its right child exist
+// Postconditions: subTree refers to the new root, heights updated
+// Return value: None
+// Functions called: updateHeight()
+void BST::rotateLeft(BSTNode*& subTree) {
+   BSTNode* oldRoot = subTree;
+   BSTNode* newRoot = oldRoot->right;
+   oldRoot->right = newRoot->left;
+   newRoot->left = oldRoot;
+   updateHeight(oldRoot);
+   updateHeight(newRoot);
+   subTree = newRoot;
+}
+
+//--------------------------------------------------------------------------
+// static void rotateRight(BSTNode*& subTree);
+// Makes subTree's left child the new root of the subtree
+// Preconditions: subTree and its left child exist
+// Postconditions: subTree refers to the new root, heights updated
+// Return value: None
+// Functions called: updateHeight()
+void BST::rotateRight(BSTNode*& subTree) {
+   BSTNode* oldRoot = subTree;
+   BSTNode* newRoot = oldRoot->left;
+   oldRoot->left = newRoot->right;
+   newRoot->right = oldRoot;
+   updateHeight(oldRoot);
+   updateHeight(newRoot);
+   subTree = newRoot;
+}
+
+//--------------------------------------------------------------------------
+// static void rebalance(BSTNode*& subTree);
+// Updates subTree's height and, if its children differ in height by two,
+// rotates it back into balance.
+// Preconditions: subTree exists, both children are balanced
+// Postconditions: subTree refers to a balanced subtree
+// Return value: None
+// Functions called: height(), updateHeight(), rotateLeft(), rotateRight()
+void BST::rebalance(BSTNode*& subTree) {
+   int balance = height(subTree->left) - height(subTree->right);
+   // left heavy: a right rotation, after a left rotation of the left child
+   // if it leans the other way (left-right case)
+   if (balance > 1) {
+      if (height(subTree->left->left) < height(subTree->left->right)) {
+         rotateLeft(subTree->left);
+      }
+      rotateRight(subTree);
+   }
+   // right heavy: the mirror image
+   else if (balance < -1) {
+      if (height(subTree->right->right) < height(subTree->right->left)) {
+         rotateRight(subTree->right);
+      }
+      rotateLeft(subTree);
+   }
+   else {
+      updateHeight(subTree);
    }
-   return false;
 }
 
 //--------------------------------------------------------------------------
@@ -233,21 +621,39 @@ bool BST::isEmpty() {
 }
 
 //--------------------------------------------------------------------------
-// BSTNode* newBSTNode(string toAdd, PrePost* newData);
-// Creates a BSTNode with PrePost data
+// static BSTNode* linkBalanced(BSTNode** nodes, size_t count);
+// Links count BSTNodes, given in sorted order, into a balanced subtree by
+// making the middle one its root and linking either side of it the same
+// way
+// Preconditions: nodes holds count BSTNodes in sorted order
+// Postconditions: Subtree linked, heights correct
+// Return value: Root of the subtree, nullptr if count is 0
+// Functions called: linkBalanced(), updateHeight()
+BST::BSTNode* BST::linkBalanced(BSTNode** nodes, size_t count) {
+   if (count == 0) {
+      return nullptr;
+   }
+   size_t middle = count / 2;
+   BSTNode* top = nodes[middle];
+   top->left = linkBalanced(nodes, middle);
+   top->right = linkBalanced(nodes + middle + 1, count - middle - 1);
+   updateHeight(top);
+   return top;
+}
+
+//--------------------------------------------------------------------------
+// BSTNode* newBSTNode(const char* toAdd, size_t length);
+// Creates a BSTNode with no concordances in the Arena, with a copy of the
+// keyword also in the Arena
 // Preconditions: Memory available
 // Postconditions: BSTNode created
 // Return value: BSTNode* (will quit if out of memory)
-// Functions called: None
-BST::BSTNode* BST::newBSTNode(string toAdd, PrePost* newData) {
-   try {
-      BSTNode* newBSTNode = new BSTNode;
-      newBSTNode->keyword = toAdd;
-      newBSTNode->concord.addLast(newData);
-      return newBSTNode;
-   }
-   catch (...) {
-      cout << "You are out of memory.\n";
-      exit(0);
-   }
+// Functions called: allocate, make
+BST::BSTNode* BST::newBSTNode(const char* toAdd, size_t length) {
+   BSTNode* newBSTNode = arena.make<BSTNode>();
+   char* keyword = static_cast<char*>(arena.allocate(length));
+   memcpy(keyword, toAdd, length);
+   newBSTNode->keyword = keyword;
+   newBSTNode->keyLength = length;
+   return newBSTNode;
 }
@@ -3,83 +3,278 @@
 // Date: 
 // Description:
 // This binary search tree is composed of BSTNodes that have a string keyword, 
-// a LinkedList<PrePost> where PrePost contain the concordance in the form
-// of two strings, and a left and a right pointer to subtrees. The parts of 
-// this produce a concordance, whereby a reader may know the preceeding and 
-// subsequent words around a keyword. Displaying the keyword will be
-// truncated to size KEYWORD_WIDTH and preKey and postKey concordance
-// will be truncated to size CONCORD_WIDTH.
+// Postings locating each occurrence of the keyword by the offset of the
+// word in the source text, and a left and a right pointer to subtrees.
+// The parts of this produce a concordance, whereby a
+// reader may know the preceeding and subsequent words around a keyword. The
+// words either side of an occurrence are only read from the
+// source text when it is displayed, so the tree never holds copies of them.
+// Each occurrence is displayed as a row by a ConcordWriter. An Iterator
+// walks the keywords in order from any starting word with a stack of the
+// BSTNodes still to visit, so a query for one keyword, a prefix or a range
+// visits only the BSTNodes it displays and the path down to them. BSTNodes,
+// their keywords and the Chunks of their Postings are all allocated from the
+// BST's Arena, so adding is a pointer bump and destructing the BST releases
+// the Arena's blocks without visiting each BSTNode. The tree is kept balanced
+// as an AVL tree: every BSTNode records the height of its subtree and any
+// insert that leaves two sibling subtrees differing in height by more than one
+// is fixed with a rotation, so inserts and searches are always O(log n) even
+// when the keywords arrive in sorted order. A BST can instead be built in
+// one pass from the Records of a KeywordSorter, already sorted, linking the
+// BSTNodes into a balanced tree as they are made without one comparison.
 // 
 // Inputs: 
-// -- PrePost objects of preKey and postKeys
-// -- BSTNodes containing a string, LinkedList<PrePost>, and two BSTNode*
+// -- The Corpus the keywords were read from
+// -- The offset of each keyword in the Corpus
+// -- BSTNodes containing a string, Postings, and two BSTNode*
 //
 // Outputs:
 // -- Displaying the entire tree including each BSTNode and for each the 
-//    corresponding LinkedList<PrePost>.
+//    corresponding Postings.
 //
 // Assumptions:
 // -- BSTNodes have correct data input
 // 
 // Major algorithms & key variables:
-// Algorithms: searching a binary search tree
-// Key Variables: string keyword, preKey, postKey; LinkedList<PrePost> concord,
-// CONCORD_WITDH
+// Algorithms: searching a binary search tree, AVL rotations, in-order 
+// iteration with an explicit stack
+// Key Variables: const char* keyword; size_t offset; Postings concord,
+// Arena arena
 
 #pragma once
-#include "LinkedList.h"
+#include "Postings.h"
+#include "Arena.h"
+#include "ConcordWriter.h"
 #include <string>
 #include <iostream>
 #include <exception>
 using namespace std;
 
+class Corpus;
+class KeywordQuery;
+class KeywordSorter;
+class RunStats;
+
 class BST {
-   static const int CONCORD_WIDTH = 30;
-   static const int KEYWORD_WIDTH = 16;
+   friend class IndexFile;
+   friend class ShardedIndex;
 
 private:
-   struct PrePost {
-      string preKey;
-      string postKey;
-   };
    struct BSTNode {
-      string keyword;
-      LinkedList<PrePost> concord;
+      const char* keyword = nullptr;
+      size_t keyLength = 0;
+      Postings concord;
       BSTNode* right = nullptr;
       BSTNode* left = nullptr;
+      int height = 1;
    };
 
+   // An AVL tree of n nodes is never taller than 1.44 * log2(n + 2), which
+   // is under 93 for any number of nodes that can be addressed.
+   static const int MAX_HEIGHT = 96;
+
    BSTNode* root;
+   Arena arena;
+   const Corpus* corpus;
+   bool showSources;
+   ConcordWriter::Layout layout;
+   // kept as the BST is built, for addStats
+   size_t numNodes;
+   size_t numComparisons;
+
+   //--------------------------------------------------------------------------
+   // static int height(const BSTNode* subTree);
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: Height of subTree, 0 if subTree is nullptr
+   // Functions called: None
+   static int height(const BSTNode* subTree);
+
+   //--------------------------------------------------------------------------
+   // static void updateHeight(BSTNode* subTree);
+   // Recomputes the height of subTree from its children
+   // Preconditions: subTree exists, children's heights are correct
+   // Postconditions: subTree's height is correct
+   // Return value: None
+   // Functions called: height()
+   static void updateHeight(BSTNode* subTree);
+
+   //--------------------------------------------------------------------------
+   // static void rotateLeft(BSTNode*& subTree);
+   // Makes subTree's right child the new root of the subtree
+   // Preconditions: subTree and its right child exist
+   // Postconditions: subTree refers to the new root, heights updated
+   // Return value: None
+   // Functions called: updateHeight()
+   static void rotateLeft(BSTNode*& subTree);
+
+   //--------------------------------------------------------------------------
+   // static void rotateRight(BSTNode*& subTree);
+   // Makes subTree's left child the new root of the subtree
+   // Preconditions: subTree and its left child exist
+   // Postconditions: subTree refers to the new root, heights updated
+   // Return value: None
+   // Functions called: updateHeight()
+   static void rotateRight(BSTNode*& subTree);
+
+   //--------------------------------------------------------------------------
+   // static void rebalance(BSTNode*& subTree);
+   // Updates subTree's height and, if its children differ in height by two,
+   // rotates it back into balance.
+   // Preconditions: subTree exists, both children are balanced
+   // Postconditions: subTree refers to a balanced subtree
+   // Return value: None
+   // Functions called: height(), updateHeight(), rotateLeft(), rotateRight()
+   static void rebalance(BSTNode*& subTree);
+
+   //--------------------------------------------------------------------------
+   // static BSTNode* linkBalanced(BSTNode** nodes, size_t count);
+   // Links count BSTNodes, given in sorted order, into a balanced subtree by
+   // making the middle one its root and linking either side of it the same
+   // way
+   // Preconditions: nodes holds count BSTNodes in sorted order
+   // Postconditions: Subtree linked, heights correct
+   // Return value: Root of the subtree, nullptr if count is 0
+   // Functions called: linkBalanced(), updateHeight()
+   static BSTNode* linkBalanced(BSTNode** nodes, size_t count);
 
    //--------------------------------------------------------------------------
-   // BSTNode* newBSTNode(string toAdd, PrePost* newData);
-   // Creates a BSTNode with PrePost data
+   // BSTNode* newBSTNode(const char* toAdd, size_t length);
+   // Creates a BSTNode with no concordances in the Arena, with a copy of the
+   // keyword also in the Arena
    // Preconditions: Memory available
    // Postconditions: BSTNode created
    // Return value: BSTNode* (will quit if out of memory)
-   // Functions called: None
-   BSTNode* newBSTNode(string ToAdd, PrePost* newData);
+   // Functions called: allocate, make
+   BSTNode* newBSTNode(const char* toAdd, size_t length);
 
    //--------------------------------------------------------------------------
-   // void destroyTree(BSTNode* subTreePtr);
-   // Taken from Carrano et al.: method used to destruct a BST
+   // BSTNode* findOrAddBSTNode(const char* toAdd, size_t length);
+   // Finds the BSTNode for the keyword, adding a BSTNode with no concordances
+   // if there is none. The tree is rebalanced on the way back up.
    // Preconditions: BST exists
-   // Postconditions: BST is destructed
+   // Postconditions: A BSTNode for toAdd exists, tree balanced
+   // Return value: BSTNode* for toAdd (will quit if out of memory)
+   // Functions called: compareKey(), newBSTNode(), rebalance()
+   BSTNode* findOrAddBSTNode(const char* toAdd, size_t length);
+
+   //--------------------------------------------------------------------------
+   // void moveConcords(const BST& other);
+   // Moves the concordances of every BSTNode in other, in order, to the
+   // BSTNode for the same keyword in this BST.
+   // Preconditions: other is another BST
+   // Postconditions: BSTNodes in other have empty concordances
    // Return value: None
-   // Functions called: Recursive call to itself
-   void destroyTree(BSTNode* subTreePtr);
+   // Functions called: findOrAddBSTNode(), append(), next()
+   void moveConcords(const BST& other);
 
    //--------------------------------------------------------------------------
-   // void display(BSTNode* root);
-   // Display the key with all concordances within the LinkedList<PrePost>
-   // Preconditions: BST exists
+   // static void displayNode(const BSTNode* top, ConcordWriter& writer);
+   // Display the key with all concordances within the Postings
+   // Preconditions: top exists
    // Postconditions: BST unchanged
-   // Return value: Outputs the entire 
-   // Functions called: Recursive call to itself
-   void display (const BSTNode* top);
+   // Return value: None
+   // Functions called: setKeyword, writeConcord
+   static void displayNode(const BSTNode* top, ConcordWriter& writer);
+
+   //--------------------------------------------------------------------------
+   // static int compareKey(const char* key, size_t length, 
+   //                       const BSTNode* node);
+   // Compares key to node's keyword in the same order as string::compare
+   // Preconditions: node exists
+   // Postconditions: None
+   // Return value: Negative if key comes first, 0 if equal, positive if after
+   // Functions called: None
+   static int compareKey(const char* key, size_t length, const BSTNode* node);
 
 public:
 
+   // An Iterator visits the keywords of a BST in sorted order. It holds the
+   // BSTNodes above the current one that are still to be visited, which is
+   // never more than the height of the tree, so no traversal of a BST 
+   // recurses. An Iterator may be kept between calls to walk a BST a page
+   // at a time.
+   class Iterator {
+      friend class BST;
+      friend class IndexFile;
+      friend class ShardedIndex;
+
+   private:
+      const BST* tree;
+      BSTNode* stack[MAX_HEIGHT];
+      int depth;
+
+      //-----------------------------------------------------------------------
+      // BSTNode* node() const;
+      // Preconditions: isValid()
+      // Postconditions: Iterator unchanged
+      // Return value: The current BSTNode
+      // Functions called: None
+      BSTNode* node() const;
+
+      //-----------------------------------------------------------------------
+      // void pushLeft(BSTNode* top);
+      // Pushes top and every left child below it onto the stack
+      // Preconditions: Iterator exists
+      // Postconditions: The least BSTNode under top is on top of the stack
+      // Return value: None
+      // Functions called: None
+      void pushLeft(BSTNode* top);
+
+   public:
+
+      //-----------------------------------------------------------------------
+      // Iterator(const BST& theTree);
+      // Constructor for an Iterator at the first keyword of theTree
+      // Preconditions: theTree exists and is not changed while iterating
+      // Postconditions: Iterator at the least keyword
+      // Return value: None
+      // Functions called: pushLeft
+      Iterator(const BST& theTree);
+
+      //-----------------------------------------------------------------------
+      // void seek(const char* key, size_t length);
+      // Moves to the first keyword that is not less than key
+      // Preconditions: Iterator exists
+      // Postconditions: Iterator at that keyword, or past the end
+      // Return value: None
+      // Functions called: compareKey
+      void seek(const char* key, size_t length);
+
+      //-----------------------------------------------------------------------
+      // bool isValid() const;
+      // Preconditions: Iterator exists
+      // Postconditions: Iterator unchanged
+      // Return value: True if at a keyword, false if past the last keyword
+      // Functions called: None
+      bool isValid() const;
+
+      //-----------------------------------------------------------------------
+      // void next();
+      // Moves to the following keyword in sorted order
+      // Preconditions: isValid()
+      // Postconditions: Iterator at the next keyword, or past the end
+      // Return value: None
+      // Functions called: pushLeft
+      void next();
+
+      //-----------------------------------------------------------------------
+      // const char* keyword() const;
+      // Preconditions: isValid()
+      // Postconditions: Iterator unchanged
+      // Return value: The characters of the current keyword
+      // Functions called: None
+      const char* keyword() const;
+
+      //-----------------------------------------------------------------------
+      // size_t keyLength() const;
+      // Preconditions: isValid()
+      // Postconditions: Iterator unchanged
+      // Return value: The length of the current keyword
+      // Functions called: None
+      size_t keyLength() const;
+   };
+
    //--------------------------------------------------------------------------
    // BST();
    // BST constructor
@@ -93,19 +288,48 @@ public:
    // ~BST();
    // Destructs BST
    // Preconditions: BST exists
-   // Postconditions: BST does not exist
+   // Postconditions: BST does not exist, Arena released
    // Return value: None
-   // Functions called: destroyTree()
+   // Functions called: release()
    ~BST();
 
+   //--------------------------------------------------------------------------
+   // void setCorpus(const Corpus* theCorpus);
+   // Sets the Corpus that keyword offsets refer into
+   // Preconditions: BST exists, theCorpus stays open while displayed
+   // Postconditions: Concordances are read from theCorpus
+   // Return value: None
+   // Functions called: None
+   void setCorpus(const Corpus* theCorpus);
+
+   //--------------------------------------------------------------------------
+   // void setShowSources(bool show);
+   // Sets whether each concordance is followed by the name of its document
+   // and the position of the keyword in that document
+   // Preconditions: BST exists
+   // Postconditions: Concordances displayed from now on show their source
+   //                 if show
+   // Return value: None
+   // Functions called: None
+   void setShowSources(bool show);
+
+   //--------------------------------------------------------------------------
+   // void setLayout(const ConcordWriter::Layout& newLayout);
+   // Sets how many words are shown either side of each keyword and how wide
+   // the concordances and keyword are
+   // Preconditions: Every number of newLayout is at least 1
+   // Postconditions: Concordances displayed from now on follow newLayout
+   // Return value: None
+   // Functions called: None
+   void setLayout(const ConcordWriter::Layout& newLayout);
+
    //--------------------------------------------------------------------------
    // void displayTree();
-   // Display all the BST's key with all concordances within the 
-   // LinkedList<PrePost>
+   // Display all the BST's key with all concordances within the Postings
    // Preconditions: BST exists
    // Postconditions: BST unchanged
    // Return value: Outputs the entire 
-   // Functions called: display()
+   // Functions called: next(), displayNode()
    void displayTree();
 
    //--------------------------------------------------------------------------
@@ -118,33 +342,95 @@ public:
    bool isEmpty();
 
    //--------------------------------------------------------------------------
-   // bool addBSTNode(string toAdd, string pre, string post);
-   // Adds BSTNode to the tree
+   // void addKeyword(const string& toAdd, size_t offset);
+   // Adds BSTNode to the tree, or adds the concordance to the existing 
+   // BSTNode for the keyword. The tree is rebalanced on the way back up.
    // Preconditions: BST exists
-   // Postconditions: One BSTNode has been added
+   // Postconditions: One BSTNode has been added, tree balanced
    // Return value: None -- will quit if out of memory (based on newBSTNode())
-   // Functions called: newBSTNode()
-   void addBSTNode(string toAdd, string pre, string post);
+   // Functions called: findOrAddBSTNode()
+   void addKeyword(const string& toAdd, size_t offset);
+
+   //--------------------------------------------------------------------------
+   // void mergeTree(BST& other);
+   // Moves every concordance in other into this BST. For keywords in both, 
+   // other's concordances are placed after this BST's, so merging the trees
+   // built from consecutive parts of a text in order gives the same tree as
+   // building from the whole text.
+   // Preconditions: Both BSTs exist and refer to the same Corpus
+   // Postconditions: other is empty, this BST holds all concordances
+   // Return value: None
+   // Functions called: moveConcords(), adopt()
+   void mergeTree(BST& other);
+
+   //--------------------------------------------------------------------------
+   // void addSorted(const KeywordSorter& sorted);
+   // Builds the BST from sorted Records in one pass: each keyword's Records
+   // become a BSTNode with their offsets as its concordances, and the
+   // BSTNodes, made in sorted order, are linked into a balanced tree
+   // without comparing keywords.
+   // Preconditions: BST is empty, sorted has been sorted
+   // Postconditions: BST holds the same concordances as if each keyword
+   //                 had been added in order of offset
+   // Return value: None -- will quit if out of memory
+   // Functions called: newBSTNode(), sameKeyword(), add(), linkBalanced()
+   void addSorted(const KeywordSorter& sorted);
+
+   //--------------------------------------------------------------------------
+   // void setArenaBlockSize(size_t bytes);
+   // Sets the largest block the BST's Arena will grow to
+   // Preconditions: BST exists
+   // Postconditions: Arena blocks allocated from now on are at most bytes
+   // Return value: None
+   // Functions called: setMaxBlockSize()
+   void setArenaBlockSize(size_t bytes);
 
    //--------------------------------------------------------------------------
-   // bool searchBSTKey(const string keyword);
-   // Searches the BST in-order to find the keyword.
-   // Preconditions: BST exists 
+   // size_t getArenaBlockSize() const;
+   // Preconditions: BST exists
    // Postconditions: BST unchanged
-   // Return value: True if keyword is found, false if otherwise
-   // Functions called: searchBST()
-   bool searchBSTKey(const string keyword);
+   // Return value: The largest block the BST's Arena will grow to
+   // Functions called: getMaxBlockSize()
+   size_t getArenaBlockSize() const;
+
+   //--------------------------------------------------------------------------
+   // void copySettings(const BST& from);
+   // Gives this BST the Arena block size of from, so that a BST built
+   // from part of a text is built as from is
+   // Preconditions: BST exists
+   // Postconditions: Arena block size the same as from
+   // Return value: None
+   // Functions called: setArenaBlockSize(), getArenaBlockSize()
+   void copySettings(const BST& from);
+
+   //--------------------------------------------------------------------------
+   // Arena::Stats getArenaStats() const;
+   // Preconditions: BST exists
+   // Postconditions: BST unchanged
+   // Return value: Stats of the Arena holding the BST's BSTNodes
+   // Functions called: getStats()
+   Arena::Stats getArenaStats() const;
+
+   //--------------------------------------------------------------------------
+   // void addStats(RunStats& stats) const;
+   // Adds the number of BSTNodes, the height of the BST, the keyword
+   // comparisons made building it, its occurrences, the bytes their
+   // Postings take and what its Arena allocated to stats
+   // Preconditions: BST exists
+   // Postconditions: BST unchanged
+   // Return value: None
+   // Functions called: addCount, getStats, height, size, numBytes
+   void addStats(RunStats& stats) const;
 
    //--------------------------------------------------------------------------
-   // BSTNode* searchBST(BSTNode* BSTRoot, const string keyword);
-   // Searches the BSTNode BSTRoot to determine if a keyword exists. If it 
-   // exists, then return a pointer to that node. However, if it doesn't exist,
-   // return a pointer to the parent. Thus, must check while exiting which 
-   // node is being returned.
+   // size_t displayQuery(const KeywordQuery& query, string& next);
+   // Display the concordances of the keywords matching query, visiting only
+   // those keywords, up to the query's limit
    // Preconditions: BST exists
-   // Postconditions: BST is unchanged
-   // Return value: BSTNode
-   // Functions called: Recursively calls itself
-   BSTNode* searchBST( BSTNode* BSTRoot, const string keyword);
+   // Postconditions: BST unchanged, next is the first matching keyword left
+   //                 undisplayed by the limit, or empty if there is none
+   // Return value: Number of keywords displayed
+   // Functions called: seek, isPastEnd, next, displayNode
+   size_t displayQuery(const KeywordQuery& query, string& next);
 };
 
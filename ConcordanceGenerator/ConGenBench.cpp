@@ -0,0 +1,442 @@
+// ConGenBench.cpp
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// ConGenBench measures how each phase of the concordance generator scales.
+// It writes a synthetic text with a CorpusGenerator, or takes a text file
+// given to it, then times each phase of making its concordance on its own:
+// mapping the text, tokenizing and trimming every word, building the BST
+// (or RadixTree), and displaying the concordance to an output that is
+// counted and discarded. Each phase is run the number of times asked and
+// its fastest run is reported as MB of text per second and millions of
+// words per second, with the heap allocations it made, the blocks the
+// tree's Arena took (which come from malloc, so are not among the heap
+// allocations) and the peak memory of the process once it is done.
+// Reports are one line per phase in fixed columns, so runs can be kept and
+// compared as the generator changes.
+// ConGenBench is built in place of ConGenDriver.cpp, from the same files.
+//
+// Inputs:
+// -- Command line settings for the synthetic text: --vocabulary=N,
+//    --skew=S, --order=random|sorted, --size=BYTES and --seed=N, and where
+//    it is written with --corpus=file (removed afterward unless --keep)
+// -- Or a text file to measure instead, given as its name
+// -- --threads=N, --index=radix|bst, --build=tree|sort and --repeat=N for
+//    the runs
+//
+// Outputs:
+// -- A description of the text, then the time, throughput, heap
+//    allocations, Arena blocks and peak memory of each phase, and what the
+//    tree's Arena allocated
+//
+// Assumptions:
+// -- Peak memory is only reported on systems with getrusage
+// -- The text is not changed while it is measured
+//
+// Major algorithms & key variables:
+// Algorithms: Best of several timed runs of each phase
+// Key Variables: CorpusGenerator generator; Corpus corpus;
+// numHeapAllocations
+
+#include "BST.h"
+#include "RadixTree.h"
+#include "ReadIn.h"
+#include "KeywordSorter.h"
+#include "Corpus.h"
+#include "CorpusGenerator.h"
+#include "StopWords.h"
+#include "Tokenizer.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+// every heap allocation the process makes with new, from any thread; the
+// blocks of an Arena come from malloc and are counted from its Stats
+static atomic<size_t> numHeapAllocations(0);
+
+void* operator new(size_t size) {
+   numHeapAllocations++;
+   void* memory = malloc(size > 0 ? size : 1);
+   if (memory == nullptr) {
+      throw bad_alloc();
+   }
+   return memory;
+}
+
+void operator delete(void* memory) noexcept {
+   free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+   free(memory);
+}
+
+// A streambuf that counts what is written to it and keeps none of it, so
+// displaying is measured without the cost of a terminal or disk
+class CountingBuffer : public streambuf {
+
+private:
+   size_t count;
+
+protected:
+   streamsize xsputn(const char*, streamsize length) override {
+      count += size_t(length);
+      return length;
+   }
+
+   int_type overflow(int_type character) override {
+      if (!traits_type::eq_int_type(character, traits_type::eof())) {
+         count++;
+      }
+      return traits_type::not_eof(character);
+   }
+
+public:
+   CountingBuffer() : count(0) {
+   }
+
+   size_t written() const {
+      return count;
+   }
+};
+
+// the fastest run of one phase
+struct PhaseResult {
+   string name;
+   double seconds = 0;
+   size_t bytes = 0;
+   size_t tokens = 0;
+   size_t allocations = 0;
+   size_t arenaBlocks = 0;
+   long peakKiB = 0;
+   bool timed = false;
+};
+
+//--------------------------------------------------------------------------
+// double now();
+// Preconditions: None
+// Postconditions: None
+// Return value: Seconds on a clock that never goes backwards
+// Functions called: now
+double now() {
+   return chrono::duration<double>(
+      chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//--------------------------------------------------------------------------
+// long peakMemoryKiB();
+// Preconditions: None
+// Postconditions: None
+// Return value: Peak resident memory of the process in KiB, 0 if unknown
+// Functions called: getrusage
+long peakMemoryKiB() {
+#ifndef _WIN32
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+      return usage.ru_maxrss / 1024;
+#else
+      return usage.ru_maxrss;
+#endif
+   }
+#endif
+   return 0;
+}
+
+//--------------------------------------------------------------------------
+// void record(PhaseResult& result, double started, size_t allocsBefore,
+//             size_t bytes, size_t tokens, size_t arenaBlocks);
+// Keeps the run of a phase that started at started if it is the fastest,
+// along with the number of Arena blocks the phase took
+// Preconditions: The phase has just finished
+// Postconditions: result holds the fastest run so far
+// Return value: None
+// Functions called: now, peakMemoryKiB
+void record(PhaseResult& result, double started, size_t allocsBefore,
+            size_t bytes, size_t tokens, size_t arenaBlocks) {
+   double seconds = now() - started;
+   size_t allocations = numHeapAllocations - allocsBefore;
+   if (!result.timed || seconds < result.seconds) {
+      result.seconds = seconds;
+      result.bytes = bytes;
+      result.tokens = tokens;
+      result.allocations = allocations;
+      result.arenaBlocks = arenaBlocks;
+      result.timed = true;
+   }
+   result.peakKiB = peakMemoryKiB();
+}
+
+//--------------------------------------------------------------------------
+// void writeResult(const PhaseResult& result);
+// Preconditions: result.timed
+// Postconditions: One line for the phase written to cout
+// Return value: None
+// Functions called: None
+void writeResult(const PhaseResult& result) {
+   double seconds = result.seconds > 0 ? result.seconds : 1e-9;
+   cout << left << setw(10) << result.name << right << fixed
+        << setprecision(4) << setw(10) << result.seconds
+        << setprecision(1) << setw(10) << result.bytes / seconds / 1e6
+        << setprecision(2) << setw(10) << result.tokens / seconds / 1e6
+        << setw(14) << result.allocations
+        << setw(14) << result.arenaBlocks
+        << setw(12) << result.peakKiB << "\n";
+}
+
+//--------------------------------------------------------------------------
+// size_t countKeywords(const Corpus& corpus, const StopWords& stopWords,
+//                      size_t& numTokens);
+// Tokenizes and trims every word of the corpus as ReadIn does, without
+// adding any to a tree
+// Preconditions: corpus open
+// Postconditions: numTokens is the number of words
+// Return value: Number of words that are keywords
+// Functions called: nextToken, trimWord, isStopWord
+size_t countKeywords(const Corpus& corpus, const StopWords& stopWords,
+                     size_t& numTokens) {
+   ReadIn trimmer(stopWords);
+   string key;
+   size_t numKeywords = 0;
+   numTokens = 0;
+   for (size_t i = 0; i < corpus.numDocuments(); i++) {
+      Tokenizer words(corpus.begin(i), corpus.end(i));
+      Token word;
+      while (words.nextToken(word)) {
+         numTokens++;
+         trimmer.trimWord(word, key);
+         if (!stopWords.isStopWord(key)) {
+            numKeywords++;
+         }
+      }
+   }
+   return numKeywords;
+}
+
+//--------------------------------------------------------------------------
+// template <class Tree>
+// void buildIndex(ReadIn& toRead, const Corpus& corpus, Tree& theTree,
+//                 int numThreads, bool sortBuild);
+// void buildIndex(ReadIn& toRead, const Corpus& corpus, BST& theTree,
+//                 int numThreads, bool sortBuild);
+// Builds theTree from the corpus, a BST from sorted keywords if sortBuild
+// Preconditions: corpus open, theTree empty, sortBuild only for a BST
+// Postconditions: theTree built
+// Return value: None
+// Functions called: buildTree, sort, setCorpus, addSorted
+template <class Tree>
+void buildIndex(ReadIn& toRead, const Corpus& corpus, Tree& theTree,
+                int numThreads, bool) {
+   toRead.buildTree(corpus, theTree, numThreads);
+}
+
+void buildIndex(ReadIn& toRead, const Corpus& corpus, BST& theTree,
+                int numThreads, bool sortBuild) {
+   if (!sortBuild) {
+      toRead.buildTree(corpus, theTree, numThreads);
+      return;
+   }
+   KeywordSorter sorter;
+   toRead.buildTree(corpus, sorter, numThreads);
+   sorter.sort(numThreads);
+   theTree.setCorpus(&corpus);
+   theTree.addSorted(sorter);
+}
+
+//--------------------------------------------------------------------------
+// template <class Tree>
+// void runPhases(const string& textFile, const StopWords& stopWords,
+//                int numThreads, bool sortBuild, int repeat,
+//                vector<PhaseResult>& results);
+// Maps, tokenizes, builds and displays textFile repeat times, keeping the
+// fastest run of each phase
+// Preconditions: results holds the map, tokenize, build and display phases
+// Postconditions: results timed, the last tree's Arena stats written
+// Return value: None
+// Functions called: addDocuments, countKeywords, buildIndex, displayTree,
+//                   record
+template <class Tree>
+void runPhases(const string& textFile, const StopWords& stopWords,
+               int numThreads, bool sortBuild, int repeat,
+               vector<PhaseResult>& results) {
+   Arena::Stats stats = Arena::Stats();
+   for (int run = 0; run < repeat; run++) {
+      Corpus corpus;
+      double started = now();
+      size_t allocsBefore = numHeapAllocations;
+      corpus.addDocuments(vector<string>(1, textFile), numThreads);
+      record(results[0], started, allocsBefore, corpus.totalLength(), 0, 0);
+      size_t length = corpus.totalLength();
+
+      size_t numTokens = 0;
+      started = now();
+      allocsBefore = numHeapAllocations;
+      countKeywords(corpus, stopWords, numTokens);
+      record(results[1], started, allocsBefore, length, numTokens, 0);
+
+      Tree theTree;
+      ReadIn toRead(stopWords);
+      started = now();
+      allocsBefore = numHeapAllocations;
+      buildIndex(toRead, corpus, theTree, numThreads, sortBuild);
+      record(results[2], started, allocsBefore, length, numTokens,
+             theTree.getArenaStats().numBlocks);
+      size_t blocksBefore = theTree.getArenaStats().numBlocks;
+
+      CountingBuffer sink;
+      streambuf* console = cout.rdbuf(&sink);
+      started = now();
+      allocsBefore = numHeapAllocations;
+      theTree.displayTree();
+      cout.rdbuf(console);
+      record(results[3], started, allocsBefore, length, numTokens,
+             theTree.getArenaStats().numBlocks - blocksBefore);
+      stats = theTree.getArenaStats();
+      if (run == repeat - 1) {
+         cout << "Output: " << sink.written() << " bytes\n";
+      }
+   }
+   cout << "Arena: " << stats.numAllocations << " allocations, "
+        << stats.bytesAllocated << " bytes allocated, "
+        << stats.bytesReserved << " bytes reserved in "
+        << stats.numBlocks << " blocks\n";
+}
+
+int main(int argc, char* argv[]) {
+   CorpusGenerator generator;
+   size_t vocabulary = 10000;
+   double skew = 1.0;
+   bool sorted = false;
+   long size = 16 << 20;
+   long seed = 1;
+   string corpusFile = "bench-corpus.txt";
+   bool keep = false;
+   string textFile = "";
+   int numThreads = 1;
+   int repeat = 3;
+   bool useRadix = false;
+   bool sortBuild = false;
+   bool argsOk = true;
+   for (int i = 1; i < argc; i++) {
+      string arg = argv[i];
+      if (arg.compare(0, 13, "--vocabulary=") == 0) {
+         vocabulary = size_t(atol(arg.c_str() + 13));
+         argsOk = argsOk && vocabulary > 0;
+      }
+      else if (arg.compare(0, 7, "--skew=") == 0) {
+         skew = atof(arg.c_str() + 7);
+         argsOk = argsOk && skew >= 0;
+      }
+      else if (arg == "--order=random" || arg == "--order=sorted") {
+         sorted = arg == "--order=sorted";
+      }
+      else if (arg.compare(0, 7, "--size=") == 0) {
+         size = atol(arg.c_str() + 7);
+         argsOk = argsOk && size > 0;
+      }
+      else if (arg.compare(0, 7, "--seed=") == 0) {
+         seed = atol(arg.c_str() + 7);
+      }
+      else if (arg.compare(0, 9, "--corpus=") == 0) {
+         corpusFile = arg.substr(9);
+      }
+      else if (arg == "--keep") {
+         keep = true;
+      }
+      else if (arg.compare(0, 10, "--threads=") == 0) {
+         numThreads = atoi(arg.c_str() + 10);
+         argsOk = argsOk && numThreads > 0;
+      }
+      else if (arg.compare(0, 9, "--repeat=") == 0) {
+         repeat = atoi(arg.c_str() + 9);
+         argsOk = argsOk && repeat > 0;
+      }
+      else if (arg == "--index=radix" || arg == "--index=bst") {
+         useRadix = arg == "--index=radix";
+      }
+      else if (arg == "--build=sort" || arg == "--build=tree") {
+         sortBuild = arg == "--build=sort";
+      }
+      else if (arg.compare(0, 2, "--") != 0 && textFile == "") {
+         textFile = arg;
+      }
+      else {
+         argsOk = false;
+      }
+   }
+   // only a BST is built from sorted keywords
+   if (!argsOk || (sortBuild && useRadix)) {
+      cout << "Incorrect command line args, see ConGenBench.cpp.\n";
+      return 0;
+   }
+
+   vector<PhaseResult> results(4);
+   results[0].name = "map";
+   results[1].name = "tokenize";
+   results[2].name = "build";
+   results[3].name = "display";
+   PhaseResult generated;
+   generated.name = "generate";
+   if (textFile == "") {
+      generator.setVocabulary(vocabulary);
+      generator.setSkew(skew);
+      generator.setSorted(sorted);
+      generator.setLength(size_t(size));
+      generator.setSeed(uint64_t(seed));
+      double started = now();
+      size_t allocsBefore = numHeapAllocations;
+      if (!generator.write(corpusFile)) {
+         cout << "Could not write " << corpusFile << ".\n";
+         return 0;
+      }
+      record(generated, started, allocsBefore, size_t(size),
+             generator.numTokens(), 0);
+      textFile = corpusFile;
+      cout << "Text: " << vocabulary << " words, skew " << skew << ", "
+           << (sorted ? "sorted" : "random") << " order, seed " << seed
+           << ", " << generator.numTokens() << " tokens\n";
+   }
+   else {
+      cout << "Text: " << textFile << "\n";
+      keep = true;
+   }
+
+   StopWords stopWords;
+   stopWords.loadDefault();
+   if (useRadix) {
+      runPhases<RadixTree>(textFile, stopWords, numThreads, false, repeat,
+                           results);
+   }
+   else {
+      runPhases<BST>(textFile, stopWords, numThreads, sortBuild, repeat,
+                     results);
+   }
+   cout << "Index: " << (useRadix ? "radix" : "bst")
+        << (sortBuild ? " built from sorted keywords" : "") << ", threads "
+        << numThreads << ", best of " << repeat << "\n";
+   cout << left << setw(10) << "phase" << right << setw(10) << "seconds"
+        << setw(10) << "MB/s" << setw(10) << "Mwords/s"
+        << setw(14) << "heap allocs" << setw(14) << "arena blocks"
+        << setw(12) << "peak KiB" << "\n";
+   if (generated.timed) {
+      writeResult(generated);
+   }
+   for (size_t i = 0; i < results.size(); i++) {
+      writeResult(results[i]);
+   }
+   if (!keep) {
+      remove(corpusFile.c_str());
+   }
+   return 0;
+}
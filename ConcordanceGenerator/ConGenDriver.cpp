@@ -12,8 +12,9 @@
 // eliminated.
 //
 // Inputs: 
-// The program’s input data is any.txt file, and will be read as ASCII letters.
-// -- Delimiters can be spaces, tabs, or end lines.
+// The program’s input data is any.txt file, and will be read as UTF-8.
+// -- Delimiters can be spaces, tabs, or end lines, or Unicode spaces such as
+//    the no-break space.
 // -- Empty files will have no concordance data.
 // -- Files with only punctuation will also have no concordance data.
 // -- Capitalization will not cause words to be considered to be different, 
@@ -30,30 +31,528 @@
 // |    What does the |	fox |	say ? Ring ding ding ding |
 //
 // Assumptions:
-// -- ASCII characters only in file
-// -- stopWords.txt may or may not exists within the directory
-// -- File to utilize is accepted as a command line argument only
+// -- Files are UTF-8, of which ASCII is a part. Letters of the Latin, Greek,
+//    Cyrillic and Armenian alphabets are lowercased; other letters are kept
+//    as they are
+// -- stopWords.txt may or may not exists within the directory, when it does
+//    not the default stop words compiled into the program are used. Another
+//    stop word file may be given with --stopwords=file
+// -- The text may be read, and its files opened, by several threads at
+//    once with --threads=N
+// -- The largest block the BST allocates at once may be set with 
+//    --arena-block=BYTES, and --arena-stats writes what the BST allocated
+//    to cerr once the concordance is displayed
+// -- Several text files or directories of them may be given, and are read
+//    in order as one text whose concordance shows each word in the context
+//    of its own file. The files of a directory and those under it are read
+//    in order of their names. --sources follows each concordance with the
+//    name of its file and the position of the keyword in it
+// -- --window=N shows N words either side of each keyword instead of 5, and
+//    --concord-width=N and --keyword-width=N set how many characters wide
+//    the concordances and keyword are, 30 and 16 unless given
+// -- --format=jsonl, --format=csv or --format=binary writes a record for
+//    each occurrence instead of a row of the table, for other programs to
+//    read: the keyword, the name of its file, its position there and the
+//    words of the window either side, none of them truncated.
+//    --format=table is the table
+// -- --save=index saves the concordance of the text as an index file instead
+//    of displaying it. --load=index displays a saved index without the text
+//    being read again. --append=index adds the concordance of the text to a
+//    saved index, reading only the new text, and the index then displays
+//    the same as if every text had been saved at once
+// -- Either a concordance or a saved index displays only the keywords asked
+//    for with --keyword=word, --prefix=start, or --from=first and/or
+//    --to=last for every keyword in that range inclusive. Only one kind of
+//    query may be given at once
+// -- --index=radix reads the keywords into a RadixTree instead of a BST,
+//    which finds keywords and prefixes in time set by their length rather
+//    than the number of keywords. --index=sharded reads them into a
+//    ShardedIndex, a BST for each first letter that every thread adds to
+//    at once rather than reading into trees of its own to be merged.
+//    Only a BST can be saved
+// -- --build=sort builds the BST by writing down every keyword and where it
+//    occurs, sorting them on every thread, and then making the BST from the
+//    sorted keywords in one pass, instead of adding each keyword to the BST
+//    as it is read. The concordance is the same either way
+// -- --pipeline reads the text in stages on threads of their own, one
+//    reading the files from disk, N from --threads=N finding the keywords,
+//    and one adding them to the tree in order, so that reading from disk
+//    overlaps the rest. The concordance is the same either way
+// -- --limit=N displays at most N keywords, then writes to cerr the keyword
+//    the next page would start from, which --from= can be given to continue
+// -- --stats writes to cerr, once the run is done, how long each phase took
+//    and what was counted: words, stop words, keyword comparisons, tree
+//    nodes and height, and what the tree allocated. --stats=json writes
+//    the same as one JSON object
+// -- --top=N displays only the N most frequent keywords of the text and how
+//    often each occurs, and --counts every keyword by how often it occurs,
+//    counted as the text is read without building a concordance.
+//    --approximate=N counts them in N counters of fixed memory however
+//    large the text, each count followed by the count the keyword is sure
+//    to have reached
+// -- Files to utilize are accepted as command line arguments only
 // 
 // Major algorithms & key variables:
-// Algorithms: Recursive binary tree search
-// Key Variables: ifstream inFile, ReadIn toRead, BST theTree
+// Algorithms: AVL balanced binary search tree, radix tree, sharding by
+// first letter, Space-Saving, parallel merge sort, pipeline of threads
+// joined by ring queues
+// Key Variables: Corpus corpus, ReadIn toRead, BST theTree
 
 
-#include "LinkedList.h"
 #include "BST.h"
+#include "RadixTree.h"
+#include "ShardedIndex.h"
 #include "ReadIn.h"
-#include <fstream>
+#include "Corpus.h"
+#include "StopWords.h"
+#include "IndexFile.h"
+#include "KeywordQuery.h"
+#include "RunStats.h"
+#include "Tokenizer.h"
 #include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
 
 using namespace std;
 
-int main(int argc, char* argv[]) {
-   if (argc == 2) {
-      ifstream inFile(argv[1]);
-      ReadIn toRead;
-      BST theTree;
-      toRead.buildTree(inFile, theTree);
+//--------------------------------------------------------------------------
+// string lowerCase(string word);
+// Preconditions: None
+// Postconditions: None
+// Return value: word with every letter lowercase, as keywords are stored
+// Functions called: lowerCase
+string lowerCase(string word) {
+   if (!word.empty()) {
+      Tokenizer::lowerCase(&word[0], word.data(), word.length());
+   }
+   return word;
+}
+
+//--------------------------------------------------------------------------
+// template <class Tree>
+// void displayTree(Tree& theTree, bool queryGiven, const KeywordQuery& query,
+//                  string& next);
+// Displays the concordances of theTree matching query, or every 
+// concordance if no query was given
+// Preconditions: theTree built
+// Postconditions: next is the keyword a following page would start from
+// Return value: None
+// Functions called: displayQuery, displayTree
+template <class Tree>
+void displayTree(Tree& theTree, bool queryGiven, const KeywordQuery& query,
+                 string& next) {
+   if (queryGiven) {
+      theTree.displayQuery(query, next);
+   }
+   else {
       theTree.displayTree();
+   }
+}
+
+//--------------------------------------------------------------------------
+// void writeArenaStats(const Arena::Stats& stats);
+// Preconditions: None
+// Postconditions: stats written to cerr
+// Return value: None
+// Functions called: None
+void writeArenaStats(const Arena::Stats& stats) {
+   cerr << "Arena: " << stats.numAllocations << " allocations, "
+        << stats.bytesAllocated << " bytes allocated, "
+        << stats.bytesReserved << " bytes reserved in "
+        << stats.numBlocks << " blocks\n";
+}
+
+//--------------------------------------------------------------------------
+// void writeRunStats(const RunStats& runStats, bool asJson);
+// Preconditions: None
+// Postconditions: runStats written to cerr, as JSON if asJson
+// Return value: None
+// Functions called: writeJson, writeSummary
+void writeRunStats(const RunStats& runStats, bool asJson) {
+   if (asJson) {
+      runStats.writeJson(cerr);
+   }
+   else {
+      runStats.writeSummary(cerr);
+   }
+}
+
+int main(int argc, char* argv[]) {
+   string stopWordFile = "stopwords.txt";
+   bool stopWordFileGiven = false;
+   vector<string> textFiles;
+   int numThreads = 1;
+   long arenaBlock = 0;
+   bool arenaStats = false;
+   string saveFile = "";
+   string loadFile = "";
+   string appendFile = "";
+   KeywordQuery query;
+   bool queryGiven = false;
+   string rangeFrom = "";
+   string rangeTo = "";
+   bool fromGiven = false;
+   bool toGiven = false;
+   long limit = 0;
+   bool useRadix = false;
+   bool useSharded = false;
+   bool sortBuild = false;
+   bool pipelined = false;
+   bool showSources = false;
+   ConcordWriter::Layout layout;
+   // keywords displayed by frequency, 0 for all, or -1 for a concordance
+   long top = -1;
+   long numCounters = 0;
+   RunStats runStats;
+   bool statsJson = false;
+   string next = "";
+   bool argsOk = true;
+   for (int i = 1; i < argc; i++) {
+      string arg = argv[i];
+      if (arg.compare(0, 12, "--stopwords=") == 0) {
+         stopWordFile = arg.substr(12);
+         stopWordFileGiven = true;
+      }
+      else if (arg.compare(0, 10, "--threads=") == 0) {
+         numThreads = atoi(arg.c_str() + 10);
+         if (numThreads < 1) {
+            argsOk = false;
+         }
+      }
+      else if (arg.compare(0, 14, "--arena-block=") == 0) {
+         arenaBlock = atol(arg.c_str() + 14);
+         if (arenaBlock < 1) {
+            argsOk = false;
+         }
+      }
+      else if (arg == "--arena-stats") {
+         arenaStats = true;
+      }
+      else if (arg.compare(0, 9, "--window=") == 0) {
+         layout.wordsInConcord = atoi(arg.c_str() + 9);
+         if (layout.wordsInConcord < 1) {
+            argsOk = false;
+         }
+      }
+      else if (arg.compare(0, 16, "--concord-width=") == 0) {
+         layout.concordWidth = atoi(arg.c_str() + 16);
+         if (layout.concordWidth < 1) {
+            argsOk = false;
+         }
+      }
+      else if (arg.compare(0, 16, "--keyword-width=") == 0) {
+         layout.keywordWidth = atoi(arg.c_str() + 16);
+         if (layout.keywordWidth < 1) {
+            argsOk = false;
+         }
+      }
+      else if (arg == "--format=table") {
+         layout.format = ConcordWriter::TABLE;
+      }
+      else if (arg == "--format=jsonl") {
+         layout.format = ConcordWriter::JSON_LINES;
+      }
+      else if (arg == "--format=csv") {
+         layout.format = ConcordWriter::CSV;
+      }
+      else if (arg == "--format=binary") {
+         layout.format = ConcordWriter::BINARY;
+      }
+      else if (arg.compare(0, 6, "--top=") == 0) {
+         top = atol(arg.c_str() + 6);
+         if (top < 1) {
+            argsOk = false;
+         }
+      }
+      else if (arg == "--counts") {
+         top = 0;
+      }
+      else if (arg.compare(0, 14, "--approximate=") == 0) {
+         numCounters = atol(arg.c_str() + 14);
+         if (numCounters < 1) {
+            argsOk = false;
+         }
+      }
+      else if (arg == "--sources") {
+         showSources = true;
+      }
+      else if (arg == "--stats" || arg == "--stats=json") {
+         runStats.setEnabled(true);
+         statsJson = arg == "--stats=json";
+      }
+      else if (arg.compare(0, 7, "--save=") == 0) {
+         saveFile = arg.substr(7);
+      }
+      else if (arg.compare(0, 7, "--load=") == 0) {
+         loadFile = arg.substr(7);
+      }
+      else if (arg.compare(0, 9, "--append=") == 0) {
+         appendFile = arg.substr(9);
+      }
+      else if (arg.compare(0, 10, "--keyword=") == 0) {
+         argsOk = argsOk && !queryGiven;
+         query = KeywordQuery::keyword(lowerCase(arg.substr(10)));
+         queryGiven = true;
+      }
+      else if (arg.compare(0, 9, "--prefix=") == 0) {
+         argsOk = argsOk && !queryGiven;
+         query = KeywordQuery::prefix(lowerCase(arg.substr(9)));
+         queryGiven = true;
+      }
+      else if (arg.compare(0, 7, "--from=") == 0) {
+         rangeFrom = lowerCase(arg.substr(7));
+         fromGiven = true;
+      }
+      else if (arg.compare(0, 5, "--to=") == 0) {
+         rangeTo = lowerCase(arg.substr(5));
+         toGiven = true;
+      }
+      else if (arg == "--index=radix" || arg == "--index=bst" || 
+               arg == "--index=sharded") {
+         useRadix = arg == "--index=radix";
+         useSharded = arg == "--index=sharded";
+      }
+      else if (arg == "--build=sort" || arg == "--build=tree") {
+         sortBuild = arg == "--build=sort";
+      }
+      else if (arg == "--pipeline") {
+         pipelined = true;
+      }
+      else if (arg.compare(0, 8, "--limit=") == 0) {
+         limit = atol(arg.c_str() + 8);
+         if (limit < 1) {
+            argsOk = false;
+         }
+      }
+      else if (arg.compare(0, 2, "--") == 0) {
+         argsOk = false;
+      }
+      else {
+         textFiles.push_back(arg);
+      }
+   }
+   if (fromGiven || toGiven) {
+      argsOk = argsOk && !queryGiven;
+      query = KeywordQuery::range(rangeFrom, rangeTo, toGiven);
+      queryGiven = true;
+   }
+   if (limit > 0) {
+      query.setLimit(size_t(limit));
+      queryGiven = true;
+   }
+   // a concordance is saved to one index, and only a BST can be saved
+   string indexFile = saveFile != "" ? saveFile : appendFile;
+   if (saveFile != "" && appendFile != "") {
+      argsOk = false;
+   }
+   // keywords are only counted from a text, never saved or queried
+   if (numCounters > 0 && top < 0) {
+      top = 0;
+   }
+   if (top >= 0 && (queryGiven || indexFile != "" || loadFile != "" || 
+                    layout.format != ConcordWriter::TABLE)) {
+      argsOk = false;
+   }
+   // only a BST is built from sorted keywords
+   if (sortBuild && (useRadix || useSharded || top >= 0)) {
+      argsOk = false;
+   }
+   // a ShardedIndex is read into by its own pool of threads
+   if (useSharded && pipelined) {
+      argsOk = false;
+   }
+   if (argsOk && loadFile != "" && textFiles.empty() && indexFile == "") {
+      // a saved index is mapped as it is, nothing is read or rebuilt
+      IndexFile index;
+      runStats.startPhase("open index");
+      if (!index.open(loadFile)) {
+         cout << "Could not load index: " << index.getProblem() << ".\n";
+         return 0;
+      }
+      runStats.endPhase();
+      index.setShowSources(showSources);
+      index.setLayout(layout);
+      runStats.startPhase("display");
+      if (queryGiven) {
+         runStats.addCount("keywords displayed", 
+                           index.displayQuery(query, next));
+      }
+      else {
+         index.displayIndex();
+      }
+      runStats.endPhase();
+      if (index.getProblem() != "") {
+         cout << "Could not display index: " << index.getProblem() << ".\n";
+         return 0;
+      }
+      if (next != "") {
+         cerr << "More keywords from " << next << "\n";
+      }
+      if (runStats.isEnabled()) {
+         index.addStats(runStats);
+         writeRunStats(runStats, statsJson);
+      }
+      return 0;
+   }
+   else if (argsOk && !textFiles.empty() && loadFile == "" && 
+            !((queryGiven || useRadix || useSharded) && indexFile != "")) {
+      if (appendFile != "") {
+         // only append to an index whose segments are whole, checked by
+         // their headers so the documents already saved are not mapped
+         IndexFile index;
+         runStats.startPhase("check index");
+         if (!index.check(appendFile)) {
+            cout << "Could not load index: " << index.getProblem() << ".\n";
+            return 0;
+         }
+         runStats.endPhase();
+      }
+      // stop words are loaded once, before any text is read
+      StopWords stopWords;
+      runStats.startPhase("stop words");
+      if (!stopWords.loadFile(stopWordFile)) {
+         if (stopWordFileGiven) {
+            cout << "Could not open stop word file " << stopWordFile << ".\n";
+            return 0;
+         }
+         stopWords.loadDefault();
+      }
+      runStats.endPhase();
+      runStats.startPhase("map text");
+      vector<string> documents;
+      for (size_t i = 0; i < textFiles.size(); i++) {
+         if (!Corpus::listDocuments(textFiles[i], documents)) {
+            cout << "Could not read directory " << textFiles[i] << ".\n";
+            return 0;
+         }
+      }
+      Corpus corpus;
+      if (!corpus.addDocuments(documents, numThreads)) {
+         for (size_t i = 0; i < corpus.numDocuments(); i++) {
+            if (!corpus.isOpen(i)) {
+               cout << "Could not open " << corpus.getName(i) << ".\n";
+               return 0;
+            }
+         }
+      }
+      runStats.endPhase();
+      runStats.addCount("documents", corpus.numDocuments());
+      runStats.addCount("text bytes", corpus.totalLength());
+      ReadIn toRead(stopWords);
+      toRead.setPipelined(pipelined);
+      Arena::Stats stats;
+      if (top >= 0) {
+         KeywordCounter counter;
+         counter.setCapacity(size_t(numCounters));
+         runStats.startPhase("count");
+         toRead.buildTree(corpus, counter, numThreads);
+         runStats.endPhase();
+         runStats.startPhase("display");
+         counter.displayTop(size_t(top));
+         runStats.endPhase();
+         if (runStats.isEnabled()) {
+            toRead.addStats(runStats);
+            counter.addStats(runStats);
+            writeRunStats(runStats, statsJson);
+         }
+         return 0;
+      }
+      if (useSharded) {
+         ShardedIndex theIndex;
+         if (arenaBlock > 0) {
+            theIndex.setArenaBlockSize(size_t(arenaBlock));
+         }
+         runStats.startPhase("build");
+         toRead.buildSharded(corpus, theIndex, numThreads);
+         runStats.endPhase();
+         theIndex.setShowSources(showSources);
+         theIndex.setLayout(layout);
+         runStats.startPhase("display");
+         displayTree(theIndex, queryGiven, query, next);
+         runStats.endPhase();
+         stats = theIndex.getArenaStats();
+         if (runStats.isEnabled()) {
+            toRead.addStats(runStats);
+            theIndex.addStats(runStats);
+         }
+      }
+      else if (useRadix) {
+         RadixTree theTree;
+         if (arenaBlock > 0) {
+            theTree.setArenaBlockSize(size_t(arenaBlock));
+         }
+         runStats.startPhase("build");
+         toRead.buildTree(corpus, theTree, numThreads);
+         runStats.endPhase();
+         theTree.setShowSources(showSources);
+         theTree.setLayout(layout);
+         runStats.startPhase("display");
+         displayTree(theTree, queryGiven, query, next);
+         runStats.endPhase();
+         stats = theTree.getArenaStats();
+         if (runStats.isEnabled()) {
+            toRead.addStats(runStats);
+            theTree.addStats(runStats);
+         }
+      }
+      else {
+         BST theTree;
+         if (arenaBlock > 0) {
+            theTree.setArenaBlockSize(size_t(arenaBlock));
+         }
+         if (sortBuild) {
+            // the Records are released once the BST is built from them
+            KeywordSorter sorter;
+            runStats.startPhase("read");
+            toRead.buildTree(corpus, sorter, numThreads);
+            runStats.endPhase();
+            runStats.startPhase("sort");
+            sorter.sort(numThreads);
+            runStats.endPhase();
+            runStats.startPhase("build");
+            theTree.setCorpus(&corpus);
+            theTree.addSorted(sorter);
+            runStats.endPhase();
+            if (runStats.isEnabled()) {
+               sorter.addStats(runStats);
+            }
+         }
+         else {
+            runStats.startPhase("build");
+            toRead.buildTree(corpus, theTree, numThreads);
+            runStats.endPhase();
+         }
+         if (indexFile != "") {
+            runStats.startPhase("save");
+            if (!IndexFile::save(indexFile, theTree, corpus, 
+                                 appendFile != "")) {
+               cout << "Could not save index file " << indexFile << ".\n";
+            }
+            runStats.endPhase();
+         }
+         else {
+            theTree.setShowSources(showSources);
+            theTree.setLayout(layout);
+            runStats.startPhase("display");
+            displayTree(theTree, queryGiven, query, next);
+            runStats.endPhase();
+         }
+         stats = theTree.getArenaStats();
+         if (runStats.isEnabled()) {
+            toRead.addStats(runStats);
+            theTree.addStats(runStats);
+         }
+      }
+      if (next != "") {
+         cerr << "More keywords from " << next << "\n";
+      }
+      if (arenaStats) {
+         writeArenaStats(stats);
+      }
+      if (runStats.isEnabled()) {
+         writeRunStats(runStats, statsJson);
+      }
       return 0;
    }
    else {
@@ -61,4 +560,3 @@ int main(int argc, char* argv[]) {
    }
    return 0;
 }
-
@@ -0,0 +1,694 @@
+// ConcordWriter.cpp
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// ConcordWriter displays concordances in Key Word in Context (KWIC) form.
+// It is given the Corpus the keywords were read from, then for each
+// keyword the offset of every occurrence of it in the Corpus. The words
+// either side of the occurrence are read from the document holding it and
+// written as one row, with the keyword truncated to the keyword width and
+// the preKey and postKey concordance truncated to the concord width:
+// |  The quick brown | fox | jumps over the lazy dog    |
+// How many words are read either side and both widths are set by a Layout,
+// which is WORDS_IN_CONCORD, KEYWORD_WIDTH and CONCORD_WIDTH unless
+// another is given. The words are found into Token arrays made once for
+// the Layout: the words before the keyword are found nearest first, so
+// they fill their array from the back and are used from wherever the
+// farthest one landed, with nothing moved or allocated for any row however
+// wide the window. Widths are counted in UTF-8 characters rather than
+// bytes, so rows of any text line up and nothing is cut inside a
+// character. No row of a Layout takes more than four bytes for each
+// character of its width, so each is formatted in place at the end of an
+// output buffer, padding and truncating without building any strings, and
+// the buffer is written to the output stream in blocks of BUFFER_SIZE
+// bytes rather than one row at a time. Rows may also be followed by the
+// name of the document holding the occurrence and its position in that
+// document, so that a concordance of many documents can be traced back to
+// them.
+// A Layout may instead ask for a Format read by other programs rather
+// than people: a JSON object on a line of its own for each occurrence, a
+// CSV row, or binary records. Each holds the keyword, the name of its
+// document, its position there and every word of the window either side,
+// none of them truncated, and is written from the Tokens straight into
+// the same buffer, escaping as it copies, so no string is built for it.
+// Binary records are a tag byte followed by lengths and numbers as
+// varints: 'K' and the keyword, written once for each keyword, 'D' and the
+// name of a document, written when the occurrences move to another one,
+// and 'O' for an occurrence, its position and each word before and after
+// it, each count of words and each word preceded by its length.
+// 
+// Inputs: 
+// -- The Corpus the keywords were read from
+// -- The Layout of the rows
+// -- A keyword and the offsets where it occurs in the Corpus
+//
+// Outputs:
+// -- One row or record for each occurrence, to the given output stream
+//    once the buffer fills, flush() is called, or the ConcordWriter is
+//    destructed
+//
+// Assumptions:
+// -- Offsets are the start of a word in the Corpus, and a keyword's offsets
+//    are mostly in one document after another
+// 
+// Major algorithms & key variables:
+// Algorithms: Counting UTF-8 characters, JSON and CSV escaping, varint
+// (LEB128) encoding
+// Key Variables: vector<char> buffer; string keyToPrint; Layout layout;
+// vector<Token> before, after
+
+#include "ConcordWriter.h"
+#include <cstring>
+#include <cstdio>
+
+//--------------------------------------------------------------------------
+// ConcordWriter(ostream& output);
+// Constructor for ConcordWriter
+// Preconditions: output is open
+// Postconditions: Rows will be written to output, in the default Layout
+// Return value: None
+// Functions called: setLayout
+ConcordWriter::ConcordWriter(ostream& output) : out(output), 
+                                                buffer(BUFFER_SIZE) {
+   corpus = nullptr;
+   sourceBegin = nullptr;
+   sourceEnd = nullptr;
+   sourceBase = 0;
+   sourceLimit = 0;
+   showSources = false;
+   sourceWritten = false;
+   used = 0;
+   setLayout(Layout());
+}
+
+//--------------------------------------------------------------------------
+// ~ConcordWriter();
+// Destructor for ConcordWriter
+// Preconditions: ConcordWriter exists
+// Postconditions: Every row has been written to the output
+// Return value: None
+// Functions called: flush
+ConcordWriter::~ConcordWriter() {
+   flush();
+}
+
+//--------------------------------------------------------------------------
+// void flush();
+// Writes the buffered rows to the output
+// Preconditions: ConcordWriter exists
+// Postconditions: Buffer empty, output flushed
+// Return value: None
+// Functions called: write, flush
+void ConcordWriter::flush() {
+   out.write(buffer.data(), streamsize(used));
+   out.flush();
+   used = 0;
+}
+
+//--------------------------------------------------------------------------
+// void setCorpus(const Corpus* theCorpus);
+// Sets the Corpus that offsets refer into
+// Preconditions: theCorpus stays open while rows are written
+// Postconditions: Concordances are read from theCorpus
+// Return value: None
+// Functions called: None
+void ConcordWriter::setCorpus(const Corpus* theCorpus) {
+   corpus = theCorpus;
+   sourceBase = 0;
+   sourceLimit = 0;
+}
+
+//--------------------------------------------------------------------------
+// void findSource(size_t offset);
+// Moves to the document of the Corpus holding offset
+// Preconditions: Corpus set, offset < totalLength()
+// Postconditions: sourceBase <= offset < sourceLimit
+// Return value: None
+// Functions called: findDocument
+void ConcordWriter::findSource(size_t offset) {
+   size_t document = corpus->findDocument(offset);
+   sourceBegin = corpus->begin(document);
+   sourceEnd = corpus->end(document);
+   sourceBase = corpus->base(document);
+   sourceLimit = sourceBase + corpus->length(document);
+   sourceName = corpus->getName(document);
+   sourceLabel = " " + sourceName + ":";
+   sourceWritten = false;
+}
+
+//--------------------------------------------------------------------------
+// void setShowSources(bool show);
+// Sets whether each row is followed by the name of its document and the
+// position of the occurrence in that document
+// Preconditions: None
+// Postconditions: Rows written from now on show their source if show
+// Return value: None
+// Functions called: None
+void ConcordWriter::setShowSources(bool show) {
+   showSources = show;
+}
+
+//--------------------------------------------------------------------------
+// void setLayout(const Layout& newLayout);
+// Sets how many words are shown either side of each keyword and how
+// wide the concordances and keyword are
+// Preconditions: Every number of newLayout is at least 1
+// Postconditions: Rows written from now on follow newLayout, keyword
+//                 must be set again
+// Return value: None
+// Functions called: flush
+void ConcordWriter::setLayout(const Layout& newLayout) {
+   layout = newLayout;
+   // a character is at most four bytes
+   rowLength = (size_t(layout.concordWidth) * 2 + 
+                size_t(layout.keywordWidth)) * 4 + 5;
+   before.assign(size_t(layout.wordsInConcord), Token());
+   after.assign(size_t(layout.wordsInConcord), Token());
+   if (buffer.size() < rowLength) {
+      flush();
+      buffer.resize(rowLength);
+   }
+   keyToPrint.assign(size_t(layout.keywordWidth), ' ');
+}
+
+//--------------------------------------------------------------------------
+// void setKeyword(const char* keyword, size_t length);
+// Sets the keyword written in the middle of the following rows, centered
+// within the keyword width or truncated to fit. Every other Format
+// keeps the whole keyword, and binary records write it now.
+// Preconditions: keyword has length bytes
+// Postconditions: keyToPrint holds the keyword as displayed
+// Return value: None
+// Functions called: countCharacters, prefixLength, append, appendVarint
+void ConcordWriter::setKeyword(const char* keyword, size_t length) {
+   if (layout.format != TABLE) {
+      wholeKeyword.assign(keyword, length);
+      if (layout.format == BINARY) {
+         append("K", 1);
+         appendVarint(length);
+         append(keyword, length);
+      }
+      return;
+   }
+   keyToPrint.assign(keyword, length);
+   // Must cast the length as a signed int, as .length() returns an 
+   // unsigned int (size_t) and C++ makes the assumption that 
+   // resulting int of the subtraction is unsigned and then allows 
+   // bit shift on unsigned ints. This causes a drop of the signed 
+   // bit and thus incredibly high, positive numSpaces which will 
+   // then attempt to add billions of spaces in the next for loop. 
+   // Therefore, MUST CAST.
+   int keywordWidth = layout.keywordWidth;
+   int numCharacters = int(countCharacters(keyword, length));
+   int numSpaces = (keywordWidth - numCharacters) / 2;
+   // for centering purposes, append the end of the string with half of 
+   // the difference in length between this and output.
+   for (int i = 0; i < numSpaces; i++) {
+      keyToPrint.append(" ");
+   }
+   numCharacters += numSpaces;
+   // if the keyword won't fit into the width, then truncate, leaving a
+   // space before it unless the width is only wide enough for one character
+   if (numCharacters > keywordWidth) {
+      numCharacters = keywordWidth > 1 ? keywordWidth - 1 : keywordWidth;
+      keyToPrint.assign(keyword, prefixLength(keyword, length, 
+                                              size_t(numCharacters)));
+   }
+   // right align, so every row has the whole width
+   keyToPrint.insert(size_t(0), size_t(keywordWidth - numCharacters), ' ');
+}
+
+//--------------------------------------------------------------------------
+// void writeConcord(size_t offset);
+// Writes one row, or one record of the Format, for the occurrence of the
+// keyword at offset
+// Preconditions: Corpus and keyword set
+// Postconditions: Row added to the buffer
+// Return value: None
+// Functions called: findSource, assembleCon, writeRecord, concordLength,
+//                   copyConcord, flush, writeSource
+void ConcordWriter::writeConcord(size_t offset) {
+   int numBefore = 0;
+   int numAfter = 0;
+   int numPads = 0;
+   if (offset < sourceBase || offset >= sourceLimit) {
+      findSource(offset);
+   }
+   assembleCon(offset - sourceBase, numBefore, numAfter, numPads);
+   // the words found before the keyword end the before array
+   const Token* preWords = before.data() + before.size() - numBefore;
+   if (layout.format != TABLE) {
+      writeRecord(offset - sourceBase, preWords, numBefore, numAfter);
+      return;
+   }
+   // the window is one run of the document, and when all of it is ASCII
+   // every character is a byte and need not be counted
+   const char* windowBegin = sourceBegin + (offset - sourceBase);
+   const char* windowEnd = windowBegin;
+   if (numBefore > 0) {
+      windowBegin = preWords[0].start;
+   }
+   if (numAfter > 0) {
+      windowEnd = after[numAfter - 1].start + after[numAfter - 1].length;
+   }
+   bool ascii = isAscii(windowBegin, windowEnd);
+   //display the pre and post key as first concordWidth characters
+   size_t concordWidth = size_t(layout.concordWidth);
+   size_t preLength = concordLength(numPads, preWords, numBefore, ascii);
+   if (preLength > concordWidth) {
+      preLength = concordWidth - 1;
+   }
+   size_t postLength = concordLength(0, after.data(), numAfter, ascii);
+   if (postLength > concordWidth) {
+      postLength = concordWidth - 1;
+   }
+   if (buffer.size() - used < rowLength) {
+      flush();
+   }
+   // |preConcord right aligned|keyToPrint|postConcord left aligned|, the
+   // lengths above in characters and the row written in bytes
+   char* row = buffer.data() + used;
+   *row++ = '|';
+   memset(row, ' ', concordWidth - preLength);
+   row += concordWidth - preLength;
+   row += copyConcord(row, preLength, numPads, preWords, numBefore, ascii);
+   *row++ = '|';
+   memcpy(row, keyToPrint.data(), keyToPrint.length());
+   row += keyToPrint.length();
+   *row++ = '|';
+   row += copyConcord(row, postLength, 0, after.data(), numAfter, ascii);
+   memset(row, ' ', concordWidth - postLength);
+   row += concordWidth - postLength;
+   *row++ = '|';
+   *row++ = '\n';
+   used = size_t(row - buffer.data());
+   if (showSources) {
+      writeSource(offset - sourceBase);
+   }
+}
+
+//--------------------------------------------------------------------------
+// void writeSource(size_t position);
+// Ends the last row with the name of the current document and position
+// Preconditions: A row was just added to the buffer
+// Postconditions: The row's newline follows the name and position
+// Return value: None
+// Functions called: flush, write
+void ConcordWriter::writeSource(size_t position) {
+   char digits[24];
+   int numDigits = snprintf(digits, sizeof(digits), "%zu\n", position);
+   // the row's newline is overwritten and written again after the source
+   used--;
+   size_t length = sourceLabel.length() + size_t(numDigits);
+   if (buffer.size() - used < length) {
+      flush();
+   }
+   if (buffer.size() < length) {
+      // too long a name to buffer, so it goes straight to the output
+      out.write(sourceLabel.data(), streamsize(sourceLabel.length()));
+      out.write(digits, numDigits);
+      return;
+   }
+   memcpy(buffer.data() + used, sourceLabel.data(), sourceLabel.length());
+   used += sourceLabel.length();
+   memcpy(buffer.data() + used, digits, size_t(numDigits));
+   used += size_t(numDigits);
+}
+
+//--------------------------------------------------------------------------
+// void appendNumber(size_t number);
+// Adds number to the buffer in decimal
+// Preconditions: None
+// Postconditions: number's digits follow everything written before them
+// Return value: None
+// Functions called: append
+void ConcordWriter::appendNumber(size_t number) {
+   char digits[24];
+   size_t at = sizeof(digits);
+   do {
+      digits[--at] = char('0' + number % 10);
+      number /= 10;
+   } while (number > 0);
+   append(digits + at, sizeof(digits) - at);
+}
+
+//--------------------------------------------------------------------------
+// void appendVarint(size_t number);
+// Adds number to the buffer as a varint, seven bits to a byte, low bits
+// first, with the top bit set on every byte but the last
+// Preconditions: None
+// Postconditions: number's bytes follow everything written before them
+// Return value: None
+// Functions called: append
+void ConcordWriter::appendVarint(size_t number) {
+   char encoded[10];
+   size_t length = 0;
+   while (number >= 0x80) {
+      encoded[length++] = char(number | 0x80);
+      number >>= 7;
+   }
+   encoded[length++] = char(number);
+   append(encoded, length);
+}
+
+//--------------------------------------------------------------------------
+// void appendJson(const char* text, size_t length);
+// Adds text to the buffer escaped for a JSON string, without quotes.
+// Runs of characters needing no escape are copied at once. Bytes that
+// are not well formed UTF-8 are written as the replacement character,
+// so the line is always valid JSON.
+// Preconditions: None
+// Postconditions: Escaped text follows everything written before it
+// Return value: None
+// Functions called: append, decodeCharacter
+void ConcordWriter::appendJson(const char* text, size_t length) {
+   const char* hex = "0123456789abcdef";
+   const char* end = text + length;
+   // the start of the run of characters not yet written
+   const char* run = text;
+   const char* at = text;
+   while (at < end) {
+      unsigned char character = (unsigned char)*at;
+      if (character >= 0x20 && character < 0x80 && character != '"' &&
+          character != '\\') {
+         at++;
+         continue;
+      }
+      if (character >= 0x80) {
+         uint32_t codePoint;
+         size_t characterLength = Tokenizer::decodeCharacter(at, end, 
+                                                             codePoint);
+         if (characterLength > 0) {
+            at += characterLength;
+            continue;
+         }
+      }
+      append(run, size_t(at - run));
+      if (character >= 0x80) {
+         append("\\ufffd", 6);
+      }
+      else if (character == '"' || character == '\\') {
+         char escaped[2] = { '\\', char(character) };
+         append(escaped, 2);
+      }
+      else {
+         char escaped[6] = { '\\', 'u', '0', '0', hex[character >> 4], 
+                             hex[character & 15] };
+         append(escaped, 6);
+      }
+      at++;
+      run = at;
+   }
+   append(run, size_t(at - run));
+}
+
+//--------------------------------------------------------------------------
+// void appendCsv(const char* text, size_t length);
+// Adds text to the buffer escaped for a quoted CSV field, without the
+// quotes, by doubling every quote in it
+// Preconditions: None
+// Postconditions: Escaped text follows everything written before it
+// Return value: None
+// Functions called: append
+void ConcordWriter::appendCsv(const char* text, size_t length) {
+   const char* end = text + length;
+   const char* quote;
+   while ((quote = static_cast<const char*>(
+              memchr(text, '"', size_t(end - text)))) != nullptr) {
+      // the run up to and including the quote, then the quote again
+      append(text, size_t(quote - text) + 1);
+      append("\"", 1);
+      text = quote + 1;
+   }
+   append(text, size_t(end - text));
+}
+
+//--------------------------------------------------------------------------
+// void appendWords(const Token* words, int numWords);
+// Adds numWords words to the buffer separated by single spaces, escaped
+// for the Format
+// Preconditions: words holds numWords Tokens, Format is not the table
+// Postconditions: The words follow everything written before them
+// Return value: None
+// Functions called: appendJson, appendCsv, appendVarint, append
+void ConcordWriter::appendWords(const Token* words, int numWords) {
+   if (layout.format == BINARY) {
+      appendVarint(size_t(numWords));
+   }
+   for (int i = 0; i < numWords; i++) {
+      if (layout.format == BINARY) {
+         appendVarint(words[i].length);
+         append(words[i].start, words[i].length);
+         continue;
+      }
+      if (i > 0) {
+         append(" ", 1);
+      }
+      if (layout.format == JSON_LINES) {
+         appendJson(words[i].start, words[i].length);
+      }
+      else {
+         appendCsv(words[i].start, words[i].length);
+      }
+   }
+}
+
+//--------------------------------------------------------------------------
+// void writeRecord(size_t position, const Token* preWords, int numBefore,
+//                  int numAfter);
+// Writes the occurrence at position of the current document as a record
+// of the Format, with every word of its window
+// Preconditions: Keyword set, Format is not the table, the window was
+//                just assembled
+// Postconditions: Record added to the buffer
+// Return value: None
+// Functions called: append, appendJson, appendCsv, appendNumber,
+//                   appendVarint, appendWords
+void ConcordWriter::writeRecord(size_t position, const Token* preWords, 
+                                int numBefore, int numAfter) {
+   if (layout.format == JSON_LINES) {
+      // {"keyword":"","source":"","position":0,"before":"","after":""}
+      append("{\"keyword\":\"", 12);
+      appendJson(wholeKeyword.data(), wholeKeyword.length());
+      append("\",\"source\":\"", 12);
+      appendJson(sourceName.data(), sourceName.length());
+      append("\",\"position\":", 13);
+      appendNumber(position);
+      append(",\"before\":\"", 11);
+      appendWords(preWords, numBefore);
+      append("\",\"after\":\"", 11);
+      appendWords(after.data(), numAfter);
+      append("\"}\n", 3);
+   }
+   else if (layout.format == CSV) {
+      // "keyword","source",position,"before","after"
+      append("\"", 1);
+      appendCsv(wholeKeyword.data(), wholeKeyword.length());
+      append("\",\"", 3);
+      appendCsv(sourceName.data(), sourceName.length());
+      append("\",", 2);
+      appendNumber(position);
+      append(",\"", 2);
+      appendWords(preWords, numBefore);
+      append("\",\"", 3);
+      appendWords(after.data(), numAfter);
+      append("\"\r\n", 3);
+   }
+   else {
+      if (!sourceWritten) {
+         append("D", 1);
+         appendVarint(sourceName.length());
+         append(sourceName.data(), sourceName.length());
+         sourceWritten = true;
+      }
+      append("O", 1);
+      appendVarint(position);
+      appendWords(preWords, numBefore);
+      appendWords(after.data(), numAfter);
+   }
+}
+
+//--------------------------------------------------------------------------
+// static size_t concordLength(int numPads, const Token* words, 
+//                             int numWords, bool ascii);
+// Preconditions: words holds numWords Tokens, ascii if they are all ASCII
+// Postconditions: None
+// Return value: Number of characters in numPads spaces followed by each
+//               of the words and a space
+// Functions called: countCharacters
+size_t ConcordWriter::concordLength(int numPads, const Token* words, 
+                                   int numWords, bool ascii) {
+   size_t length = size_t(numPads);
+   for (int i = 0; i < numWords; i++) {
+      if (ascii) {
+         length += words[i].length + 1;
+      }
+      else {
+         length += countCharacters(words[i].start, words[i].length) + 1;
+      }
+   }
+   return length;
+}
+
+//--------------------------------------------------------------------------
+// static bool isAscii(const char* begin, const char* end);
+// Checks eight bytes at a time for any byte that is not ASCII
+// Preconditions: begin <= end
+// Postconditions: None
+// Return value: True if every byte from begin to end is ASCII, false
+//               otherwise
+// Functions called: None
+bool ConcordWriter::isAscii(const char* begin, const char* end) {
+   uint64_t highBits = 0;
+   while (end - begin >= 8) {
+      uint64_t block;
+      memcpy(&block, begin, sizeof(block));
+      highBits |= block;
+      begin += 8;
+   }
+   while (begin < end) {
+      highBits |= (unsigned char)*begin;
+      begin++;
+   }
+   return (highBits & 0x8080808080808080ull) == 0;
+}
+
+//--------------------------------------------------------------------------
+// static size_t characterLength(const char* at, const char* end);
+// Preconditions: at < end
+// Postconditions: None
+// Return value: Number of bytes of the UTF-8 character starting at at, 1
+//               if the byte at at does not start a well formed one
+// Functions called: decodeCharacter
+size_t ConcordWriter::characterLength(const char* at, const char* end) {
+   if ((unsigned char)*at < 0x80) {
+      return 1;
+   }
+   uint32_t codePoint;
+   size_t length = Tokenizer::decodeCharacter(at, end, codePoint);
+   return length > 0 ? length : 1;
+}
+
+//--------------------------------------------------------------------------
+// static size_t countCharacters(const char* text, size_t length);
+// Preconditions: text has length bytes
+// Postconditions: None
+// Return value: Number of UTF-8 characters in text, each byte that is not
+//               part of a well formed character counted as one
+// Functions called: characterLength
+size_t ConcordWriter::countCharacters(const char* text, size_t length) {
+   const char* end = text + length;
+   size_t numCharacters = 0;
+   while (text < end) {
+      text += characterLength(text, end);
+      numCharacters++;
+   }
+   return numCharacters;
+}
+
+//--------------------------------------------------------------------------
+// static size_t prefixLength(const char* text, size_t length,
+//                            size_t numCharacters);
+// Preconditions: text has length bytes
+// Postconditions: None
+// Return value: Number of bytes of the first numCharacters characters of
+//               text, or length if it has no more than that
+// Functions called: characterLength
+size_t ConcordWriter::prefixLength(const char* text, size_t length,
+                                  size_t numCharacters) {
+   const char* end = text + length;
+   const char* at = text;
+   while (at < end && numCharacters > 0) {
+      at += characterLength(at, end);
+      numCharacters--;
+   }
+   return size_t(at - text);
+}
+
+//--------------------------------------------------------------------------
+// static size_t copyConcord(char* to, size_t numCharacters, int numPads,
+//                           const Token* words, int numWords, bool ascii);
+// Copies the first numCharacters characters of numPads spaces followed by
+// each of the words and a space
+// Preconditions: numCharacters is at most concordLength(numPads, words,
+//                numWords, ascii), to has room for four bytes a
+//                character, ascii if the words are all ASCII
+// Postconditions: numCharacters characters written to to
+// Return value: Number of bytes written
+// Functions called: countCharacters, prefixLength
+size_t ConcordWriter::copyConcord(char* to, size_t numCharacters, 
+                                  int numPads, const Token* words, 
+                                  int numWords, bool ascii) {
+   char* start = to;
+   size_t pads = size_t(numPads);
+   if (pads > numCharacters) {
+      pads = numCharacters;
+   }
+   memset(to, ' ', pads);
+   to += pads;
+   numCharacters -= pads;
+   for (int i = 0; i < numWords && numCharacters > 0; i++) {
+      // a word cut short ends at a whole character
+      size_t toCopy = words[i].length;
+      size_t copied = toCopy;
+      if (!ascii) {
+         copied = countCharacters(words[i].start, toCopy);
+      }
+      if (copied > numCharacters) {
+         toCopy = ascii ? numCharacters : 
+                  prefixLength(words[i].start, toCopy, numCharacters);
+         copied = numCharacters;
+      }
+      memcpy(to, words[i].start, toCopy);
+      to += toCopy;
+      numCharacters -= copied;
+      if (numCharacters > 0) {
+         *to++ = ' ';
+         numCharacters--;
+      }
+   }
+   return size_t(to - start);
+}
+
+//--------------------------------------------------------------------------
+// void assembleCon(size_t offset, int& numBefore, int& numAfter, 
+//                  int& numPads);
+// Finds the words of the window before and after the keyword at offset
+// in the current document. The numBefore words before it end the before
+// array, in the order of the text, and the numAfter words after it begin
+// the after array. When there are fewer words before the keyword than
+// the concordance holds, the preConcord is padded with numPads spaces 
+// for the missing words.
+// Preconditions: offset is the start of a word in the current document
+// Postconditions: before and after hold the words found
+// Return value: None
+// Functions called: nextToken, previousToken
+void ConcordWriter::assembleCon(size_t offset, int& numBefore, int& numAfter, 
+                                int& numPads) {
+   const char* keyStart = sourceBegin + offset;
+   int wordsInConcord = layout.wordsInConcord;
+   Token word;
+   numBefore = 0;
+   numAfter = 0;
+   Tokenizer backward(sourceBegin, sourceEnd, keyStart);
+   while (numBefore < wordsInConcord && 
+          backward.previousToken(word)) {
+      // found nearest first, so fill from the end and leave them there
+      numBefore++;
+      before[size_t(wordsInConcord - numBefore)] = word;
+   }
+   Tokenizer forward(sourceBegin, sourceEnd, keyStart);
+   forward.nextToken(word); // the keyword itself
+   while (numAfter < wordsInConcord && 
+          forward.nextToken(after[size_t(numAfter)])) {
+      numAfter++;
+   }
+   // the concordance is as wide as the text allows, up to wordsInConcord.
+   // Only once the start of the text is reached can there be missing words
+   // before the keyword, and then every word in the text has been counted.
+   numPads = numBefore + 1 + numAfter;
+   if (numPads > wordsInConcord) {
+      numPads = wordsInConcord;
+   }
+   numPads -= numBefore;
+}
@@ -0,0 +1,381 @@
+// ConcordWriter.h
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// ConcordWriter displays concordances in Key Word in Context (KWIC) form.
+// It is given the Corpus the keywords were read from, then for each
+// keyword the offset of every occurrence of it in the Corpus. The words
+// either side of the occurrence are read from the document holding it and
+// written as one row, with the keyword truncated to the keyword width and
+// the preKey and postKey concordance truncated to the concord width:
+// |  The quick brown | fox | jumps over the lazy dog    |
+// How many words are read either side and both widths are set by a Layout,
+// which is WORDS_IN_CONCORD, KEYWORD_WIDTH and CONCORD_WIDTH unless
+// another is given. The words are found into Token arrays made once for
+// the Layout: the words before the keyword are found nearest first, so
+// they fill their array from the back and are used from wherever the
+// farthest one landed, with nothing moved or allocated for any row however
+// wide the window. Widths are counted in UTF-8 characters rather than
+// bytes, so rows of any text line up and nothing is cut inside a
+// character. No row of a Layout takes more than four bytes for each
+// character of its width, so each is formatted in place at the end of an
+// output buffer, padding and truncating without building any strings, and
+// the buffer is written to the output stream in blocks of BUFFER_SIZE
+// bytes rather than one row at a time. Rows may also be followed by the
+// name of the document holding the occurrence and its position in that
+// document, so that a concordance of many documents can be traced back to
+// them.
+// A Layout may instead ask for a Format read by other programs rather
+// than people: a JSON object on a line of its own for each occurrence, a
+// CSV row, or binary records. Each holds the keyword, the name of its
+// document, its position there and every word of the window either side,
+// none of them truncated, and is written from the Tokens straight into
+// the same buffer, escaping as it copies, so no string is built for it.
+// Binary records are a tag byte followed by lengths and numbers as
+// varints: 'K' and the keyword, written once for each keyword, 'D' and the
+// name of a document, written when the occurrences move to another one,
+// and 'O' for an occurrence, its position and each word before and after
+// it, each count of words and each word preceded by its length.
+// 
+// Inputs: 
+// -- The Corpus the keywords were read from
+// -- The Layout of the rows
+// -- A keyword and the offsets where it occurs in the Corpus
+//
+// Outputs:
+// -- One row or record for each occurrence, to the given output stream
+//    once the buffer fills, flush() is called, or the ConcordWriter is
+//    destructed
+//
+// Assumptions:
+// -- Offsets are the start of a word in the Corpus, and a keyword's offsets
+//    are mostly in one document after another
+// 
+// Major algorithms & key variables:
+// Algorithms: Counting UTF-8 characters, JSON and CSV escaping, varint
+// (LEB128) encoding
+// Key Variables: vector<char> buffer; string keyToPrint; Layout layout;
+// vector<Token> before, after
+
+#pragma once
+
+#include "Tokenizer.h"
+#include "Corpus.h"
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstring>
+using namespace std;
+
+class ConcordWriter {
+
+public:
+   static const int CONCORD_WIDTH = 30;
+   static const int KEYWORD_WIDTH = 16;
+   static const int WORDS_IN_CONCORD = 5;
+   static const size_t BUFFER_SIZE = 1 << 16;
+
+   // the KWIC table, or a record for each occurrence in JSON Lines, CSV
+   // or binary
+   enum Format { TABLE, JSON_LINES, CSV, BINARY };
+
+   // how many words either side of a keyword are shown, how wide the
+   // concordances and keyword are in a table, and the Format written
+   struct Layout {
+      int wordsInConcord = WORDS_IN_CONCORD;
+      int concordWidth = CONCORD_WIDTH;
+      int keywordWidth = KEYWORD_WIDTH;
+      Format format = TABLE;
+   };
+
+private:
+   ostream& out;
+   const Corpus* corpus;
+   // the document rows are being read from, and its offsets in the Corpus
+   const char* sourceBegin;
+   const char* sourceEnd;
+   size_t sourceBase;
+   size_t sourceLimit;
+   // written after each row when sources are shown: " name:"
+   bool showSources;
+   string sourceLabel;
+   // the name of the current document, and whether a binary record of it
+   // has been written
+   string sourceName;
+   bool sourceWritten;
+   vector<char> buffer;
+   size_t used;
+   string keyToPrint;
+   // the whole keyword, for every Format but the table
+   string wholeKeyword;
+   Layout layout;
+   // the most bytes of |preConcord|keyword|postConcord| and a newline
+   size_t rowLength;
+   // the words either side of the occurrence being written
+   vector<Token> before;
+   vector<Token> after;
+
+   //--------------------------------------------------------------------------
+   // void findSource(size_t offset);
+   // Moves to the document of the Corpus holding offset
+   // Preconditions: Corpus set, offset < totalLength()
+   // Postconditions: sourceBase <= offset < sourceLimit
+   // Return value: None
+   // Functions called: findDocument
+   void findSource(size_t offset);
+
+   //--------------------------------------------------------------------------
+   // void writeSource(size_t position);
+   // Ends the last row with the name of the current document and position
+   // Preconditions: A row was just added to the buffer
+   // Postconditions: The row's newline follows the name and position
+   // Return value: None
+   // Functions called: flush, write
+   void writeSource(size_t position);
+
+   //--------------------------------------------------------------------------
+   // void append(const char* text, size_t length);
+   // Adds text to the buffer, flushing it first if it has no room, and
+   // writes text straight to the output if it would not fit at all
+   // Preconditions: None
+   // Postconditions: text follows everything written before it
+   // Return value: None
+   // Functions called: flush, write
+   void append(const char* text, size_t length) {
+      if (buffer.size() - used < length) {
+         flush();
+         if (buffer.size() < length) {
+            out.write(text, streamsize(length));
+            return;
+         }
+      }
+      memcpy(buffer.data() + used, text, length);
+      used += length;
+   }
+
+   //--------------------------------------------------------------------------
+   // void appendNumber(size_t number);
+   // Adds number to the buffer in decimal
+   // Preconditions: None
+   // Postconditions: number's digits follow everything written before them
+   // Return value: None
+   // Functions called: append
+   void appendNumber(size_t number);
+
+   //--------------------------------------------------------------------------
+   // void appendVarint(size_t number);
+   // Adds number to the buffer as a varint, seven bits to a byte, low bits
+   // first, with the top bit set on every byte but the last
+   // Preconditions: None
+   // Postconditions: number's bytes follow everything written before them
+   // Return value: None
+   // Functions called: append
+   void appendVarint(size_t number);
+
+   //--------------------------------------------------------------------------
+   // void appendJson(const char* text, size_t length);
+   // Adds text to the buffer escaped for a JSON string, without quotes.
+   // Runs of characters needing no escape are copied at once. Bytes that
+   // are not well formed UTF-8 are written as the replacement character,
+   // so the line is always valid JSON.
+   // Preconditions: None
+   // Postconditions: Escaped text follows everything written before it
+   // Return value: None
+   // Functions called: append, decodeCharacter
+   void appendJson(const char* text, size_t length);
+
+   //--------------------------------------------------------------------------
+   // void appendCsv(const char* text, size_t length);
+   // Adds text to the buffer escaped for a quoted CSV field, without the
+   // quotes, by doubling every quote in it
+   // Preconditions: None
+   // Postconditions: Escaped text follows everything written before it
+   // Return value: None
+   // Functions called: append
+   void appendCsv(const char* text, size_t length);
+
+   //--------------------------------------------------------------------------
+   // void appendWords(const Token* words, int numWords);
+   // Adds numWords words to the buffer separated by single spaces, escaped
+   // for the Format
+   // Preconditions: words holds numWords Tokens, Format is not the table
+   // Postconditions: The words follow everything written before them
+   // Return value: None
+   // Functions called: appendJson, appendCsv, appendVarint, append
+   void appendWords(const Token* words, int numWords);
+
+   //--------------------------------------------------------------------------
+   // void writeRecord(size_t position, const Token* preWords, int numBefore,
+   //                  int numAfter);
+   // Writes the occurrence at position of the current document as a record
+   // of the Format, with every word of its window
+   // Preconditions: Keyword set, Format is not the table, the window was
+   //                just assembled
+   // Postconditions: Record added to the buffer
+   // Return value: None
+   // Functions called: append, appendJson, appendCsv, appendNumber,
+   //                   appendVarint, appendWords
+   void writeRecord(size_t position, const Token* preWords, int numBefore,
+                    int numAfter);
+
+   //--------------------------------------------------------------------------
+   // static size_t concordLength(int numPads, const Token* words, 
+   //                             int numWords, bool ascii);
+   // Preconditions: words holds numWords Tokens, ascii if they are all ASCII
+   // Postconditions: None
+   // Return value: Number of characters in numPads spaces followed by each
+   //               of the words and a space
+   // Functions called: countCharacters
+   static size_t concordLength(int numPads, const Token* words, int numWords,
+                               bool ascii);
+
+   //--------------------------------------------------------------------------
+   // static bool isAscii(const char* begin, const char* end);
+   // Checks eight bytes at a time for any byte that is not ASCII
+   // Preconditions: begin <= end
+   // Postconditions: None
+   // Return value: True if every byte from begin to end is ASCII, false
+   //               otherwise
+   // Functions called: None
+   static bool isAscii(const char* begin, const char* end);
+
+   //--------------------------------------------------------------------------
+   // static size_t characterLength(const char* at, const char* end);
+   // Preconditions: at < end
+   // Postconditions: None
+   // Return value: Number of bytes of the UTF-8 character starting at at, 1
+   //               if the byte at at does not start a well formed one
+   // Functions called: decodeCharacter
+   static size_t characterLength(const char* at, const char* end);
+
+   //--------------------------------------------------------------------------
+   // static size_t countCharacters(const char* text, size_t length);
+   // Preconditions: text has length bytes
+   // Postconditions: None
+   // Return value: Number of UTF-8 characters in text, each byte that is not
+   //               part of a well formed character counted as one
+   // Functions called: characterLength
+   static size_t countCharacters(const char* text, size_t length);
+
+   //--------------------------------------------------------------------------
+   // static size_t prefixLength(const char* text, size_t length,
+   //                            size_t numCharacters);
+   // Preconditions: text has length bytes
+   // Postconditions: None
+   // Return value: Number of bytes of the first numCharacters characters of
+   //               text, or length if it has no more than that
+   // Functions called: characterLength
+   static size_t prefixLength(const char* text, size_t length,
+                              size_t numCharacters);
+
+   //--------------------------------------------------------------------------
+   // static size_t copyConcord(char* to, size_t numCharacters, int numPads,
+   //                           const Token* words, int numWords, bool ascii);
+   // Copies the first numCharacters characters of numPads spaces followed by
+   // each of the words and a space
+   // Preconditions: numCharacters is at most concordLength(numPads, words,
+   //                numWords, ascii), to has room for four bytes a
+   //                character, ascii if the words are all ASCII
+   // Postconditions: numCharacters characters written to to
+   // Return value: Number of bytes written
+   // Functions called: countCharacters, prefixLength
+   static size_t copyConcord(char* to, size_t numCharacters, int numPads,
+                             const Token* words, int numWords, bool ascii);
+
+public:
+
+   //--------------------------------------------------------------------------
+   // ConcordWriter(ostream& output);
+   // Constructor for ConcordWriter
+   // Preconditions: output is open
+   // Postconditions: Rows will be written to output, in the default Layout
+   // Return value: None
+   // Functions called: setLayout
+   ConcordWriter(ostream& output);
+
+   //--------------------------------------------------------------------------
+   // ~ConcordWriter();
+   // Destructor for ConcordWriter
+   // Preconditions: ConcordWriter exists
+   // Postconditions: Every row has been written to the output
+   // Return value: None
+   // Functions called: flush
+   ~ConcordWriter();
+
+   //--------------------------------------------------------------------------
+   // void flush();
+   // Writes the buffered rows to the output
+   // Preconditions: ConcordWriter exists
+   // Postconditions: Buffer empty, output flushed
+   // Return value: None
+   // Functions called: write, flush
+   void flush();
+
+   //--------------------------------------------------------------------------
+   // void setCorpus(const Corpus* theCorpus);
+   // Sets the Corpus that offsets refer into
+   // Preconditions: theCorpus stays open while rows are written
+   // Postconditions: Concordances are read from theCorpus
+   // Return value: None
+   // Functions called: None
+   void setCorpus(const Corpus* theCorpus);
+
+   //--------------------------------------------------------------------------
+   // void setShowSources(bool show);
+   // Sets whether each row is followed by the name of its document and the
+   // position of the occurrence in that document
+   // Preconditions: None
+   // Postconditions: Rows written from now on show their source if show
+   // Return value: None
+   // Functions called: None
+   void setShowSources(bool show);
+
+   //--------------------------------------------------------------------------
+   // void setLayout(const Layout& newLayout);
+   // Sets how many words are shown either side of each keyword and how
+   // wide the concordances and keyword are
+   // Preconditions: Every number of newLayout is at least 1
+   // Postconditions: Rows written from now on follow newLayout, keyword
+   //                 must be set again
+   // Return value: None
+   // Functions called: flush
+   void setLayout(const Layout& newLayout);
+
+   //--------------------------------------------------------------------------
+   // void setKeyword(const char* keyword, size_t length);
+   // Sets the keyword written in the middle of the following rows, centered
+   // within the keyword width or truncated to fit. Every other Format
+   // keeps the whole keyword, and binary records write it now.
+   // Preconditions: keyword has length bytes
+   // Postconditions: keyToPrint holds the keyword as displayed
+   // Return value: None
+   // Functions called: countCharacters, prefixLength, append, appendVarint
+   void setKeyword(const char* keyword, size_t length);
+
+   //--------------------------------------------------------------------------
+   // void writeConcord(size_t offset);
+   // Writes one row, or one record of the Format, for the occurrence of the
+   // keyword at offset
+   // Preconditions: Corpus and keyword set
+   // Postconditions: Row added to the buffer
+   // Return value: None
+   // Functions called: findSource, assembleCon, writeRecord, concordLength,
+   //                   copyConcord, flush, writeSource
+   void writeConcord(size_t offset);
+
+   //--------------------------------------------------------------------------
+   // void assembleCon(size_t offset, int& numBefore, int& numAfter, 
+   //                  int& numPads);
+   // Finds the words of the window before and after the keyword at offset
+   // in the current document. The numBefore words before it end the before
+   // array, in the order of the text, and the numAfter words after it begin
+   // the after array. When there are fewer words before the keyword than
+   // the concordance holds, the preConcord is padded with numPads spaces 
+   // for the missing words.
+   // Preconditions: offset is the start of a word in the current document
+   // Postconditions: before and after hold the words found
+   // Return value: None
+   // Functions called: nextToken, previousToken
+   void assembleCon(size_t offset, int& numBefore, int& numAfter, 
+                    int& numPads);
+};
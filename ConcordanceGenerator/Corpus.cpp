@@ -0,0 +1,267 @@
+// Corpus.cpp
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// A Corpus is the list of documents a concordance is built from, each one
+// a MappedFile. The documents are numbered in the order they are added and
+// laid end to end in one range of offsets: a document's base is the total
+// length of the documents before it, so an offset names both a document and
+// a position within it. Concordances keep a single offset for each
+// occurrence, and the document it is in is found from the offset only when
+// it is displayed, as the document ID and the position within it. A
+// directory is listed as every file within it, and a list of documents is
+// mapped by a pool of threads so that a corpus of many small files does not
+// open them one at a time.
+// 
+// Inputs: 
+// -- The names of the documents or directories of them, in order
+//
+// Outputs:
+// -- The text of each document and the document an offset falls in
+//
+// Assumptions:
+// -- No document is modified while it is mapped
+// 
+// Major algorithms & key variables:
+// Algorithms: Binary search of the document bases, worker pool
+// Key Variables: vector<unique_ptr<MappedFile>> texts; vector<size_t> bases
+
+#include "Corpus.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <dirent.h>
+#endif
+
+//--------------------------------------------------------------------------
+// Corpus();
+// Constructor for Corpus
+// Preconditions: None
+// Postconditions: Corpus with no documents
+// Return value: None
+// Functions called: None
+Corpus::Corpus() {
+   total = 0;
+}
+
+//--------------------------------------------------------------------------
+// bool addDocument(const string& name);
+// Maps the document name as the next document of the Corpus. A document
+// that cannot be opened is still added, as an empty one.
+// Preconditions: None
+// Postconditions: numDocuments() increased by one
+// Return value: True if the document was opened, false otherwise
+// Functions called: open
+bool Corpus::addDocument(const string& name) {
+   unique_ptr<MappedFile> text(new MappedFile());
+   bool opened = text->open(name);
+   bases.push_back(total);
+   total += text->length();
+   names.push_back(name);
+   texts.push_back(move(text));
+   return opened;
+}
+
+//--------------------------------------------------------------------------
+// bool addDocuments(const vector<string>& toAdd, int numThreads);
+// Maps each of toAdd as the next documents of the Corpus, in order, with
+// numThreads threads taking the next unmapped document until none are
+// left. Documents that cannot be opened are added as empty ones.
+// Preconditions: numThreads >= 1
+// Postconditions: numDocuments() increased by the size of toAdd
+// Return value: True if every document was opened, false otherwise
+// Functions called: open
+bool Corpus::addDocuments(const vector<string>& toAdd, int numThreads) {
+   size_t first = texts.size();
+   for (size_t i = 0; i < toAdd.size(); i++) {
+      texts.push_back(unique_ptr<MappedFile>(new MappedFile()));
+      names.push_back(toAdd[i]);
+   }
+   // each document is mapped into its own slot, so the threads share
+   // nothing but the count of documents taken
+   atomic<size_t> nextDocument(first);
+   atomic<bool> allOpened(true);
+   vector<thread> workers;
+   for (int i = 0; i < numThreads && size_t(i) < toAdd.size(); i++) {
+      workers.push_back(thread([this, &nextDocument, &allOpened]() {
+         size_t document;
+         while ((document = nextDocument++) < texts.size()) {
+            if (!texts[document]->open(names[document])) {
+               allOpened = false;
+            }
+         }
+      }));
+   }
+   for (size_t i = 0; i < workers.size(); i++) {
+      workers[i].join();
+   }
+   // bases are laid out in order once every length is known
+   for (size_t i = first; i < texts.size(); i++) {
+      bases.push_back(total);
+      total += texts[i]->length();
+   }
+   return allOpened;
+}
+
+//--------------------------------------------------------------------------
+// static bool listDocuments(const string& path, vector<string>& names);
+// Adds path to names, or if path is a directory, every file within it
+// and the directories under it, in order of their paths
+// Preconditions: None
+// Postconditions: names has the documents of path at its end
+// Return value: False if path is a directory that could not be read,
+//               true otherwise
+// Functions called: listDocuments
+bool Corpus::listDocuments(const string& path, vector<string>& names) {
+#ifndef _WIN32
+   struct stat info;
+   if (stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+      DIR* directory = opendir(path.c_str());
+      if (directory == nullptr) {
+         return false;
+      }
+      vector<string> entries;
+      struct dirent* entry;
+      while ((entry = readdir(directory)) != nullptr) {
+         string entryName = entry->d_name;
+         // hidden files and the directory and its parent are passed over
+         if (entryName[0] != '.') {
+            entries.push_back(entryName);
+         }
+      }
+      closedir(directory);
+      sort(entries.begin(), entries.end());
+      string prefix = path;
+      if (prefix[prefix.length() - 1] != '/') {
+         prefix += '/';
+      }
+      bool listed = true;
+      for (size_t i = 0; i < entries.size(); i++) {
+         listed = listDocuments(prefix + entries[i], names) && listed;
+      }
+      return listed;
+   }
+#endif
+   names.push_back(path);
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// void clear();
+// Preconditions: None
+// Postconditions: Every document unmapped, Corpus has no documents
+// Return value: None
+// Functions called: None
+void Corpus::clear() {
+   texts.clear();
+   names.clear();
+   bases.clear();
+   total = 0;
+}
+
+//--------------------------------------------------------------------------
+// size_t numDocuments() const;
+// Preconditions: None
+// Postconditions: Corpus unchanged
+// Return value: Number of documents added
+// Functions called: None
+size_t Corpus::numDocuments() const {
+   return texts.size();
+}
+
+//--------------------------------------------------------------------------
+// size_t totalLength() const;
+// Preconditions: None
+// Postconditions: Corpus unchanged
+// Return value: Total length of every document
+// Functions called: None
+size_t Corpus::totalLength() const {
+   return total;
+}
+
+//--------------------------------------------------------------------------
+// const string& getName(size_t document) const;
+// Preconditions: document < numDocuments()
+// Postconditions: Corpus unchanged
+// Return value: The name the document was added with
+// Functions called: None
+const string& Corpus::getName(size_t document) const {
+   return names[document];
+}
+
+//--------------------------------------------------------------------------
+// bool isOpen(size_t document) const;
+// Preconditions: document < numDocuments()
+// Postconditions: Corpus unchanged
+// Return value: True if the document was opened, false if it was added
+//               as an empty one
+// Functions called: isOpen
+bool Corpus::isOpen(size_t document) const {
+   return texts[document]->isOpen();
+}
+
+//--------------------------------------------------------------------------
+// const char* begin(size_t document) const;
+// Preconditions: document < numDocuments()
+// Postconditions: Corpus unchanged
+// Return value: Pointer to the first byte of the document
+// Functions called: begin
+const char* Corpus::begin(size_t document) const {
+   return texts[document]->begin();
+}
+
+//--------------------------------------------------------------------------
+// const char* end(size_t document) const;
+// Preconditions: document < numDocuments()
+// Postconditions: Corpus unchanged
+// Return value: Pointer one past the last byte of the document
+// Functions called: end
+const char* Corpus::end(size_t document) const {
+   return texts[document]->end();
+}
+
+//--------------------------------------------------------------------------
+// size_t length(size_t document) const;
+// Preconditions: document < numDocuments()
+// Postconditions: Corpus unchanged
+// Return value: Number of bytes in the document
+// Functions called: length
+size_t Corpus::length(size_t document) const {
+   return texts[document]->length();
+}
+
+//--------------------------------------------------------------------------
+// size_t base(size_t document) const;
+// Preconditions: document < numDocuments()
+// Postconditions: Corpus unchanged
+// Return value: Offset of the document's first byte within the Corpus
+// Functions called: None
+size_t Corpus::base(size_t document) const {
+   return bases[document];
+}
+
+//--------------------------------------------------------------------------
+// size_t findDocument(size_t offset) const;
+// Binary searches the document bases for the document holding offset
+// Preconditions: offset < totalLength()
+// Postconditions: Corpus unchanged
+// Return value: The document whose bytes include offset
+// Functions called: None
+size_t Corpus::findDocument(size_t offset) const {
+   // the last document starting at or before offset; empty documents share
+   // their base with the document after them and are passed over
+   size_t low = 0;
+   size_t high = bases.size();
+   while (high - low > 1) {
+      size_t middle = low + (high - low) / 2;
+      if (bases[middle] <= offset) {
+         low = middle;
+      }
+      else {
+         high = middle;
+      }
+   }
+   return low;
+}
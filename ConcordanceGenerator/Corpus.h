@@ -0,0 +1,174 @@
+// Corpus.h
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// A Corpus is the list of documents a concordance is built from, each one
+// a MappedFile. The documents are numbered in the order they are added and
+// laid end to end in one range of offsets: a document's base is the total
+// length of the documents before it, so an offset names both a document and
+// a position within it. Concordances keep a single offset for each
+// occurrence, and the document it is in is found from the offset only when
+// it is displayed, as the document ID and the position within it. A
+// directory is listed as every file within it, and a list of documents is
+// mapped by a pool of threads so that a corpus of many small files does not
+// open them one at a time.
+// 
+// Inputs: 
+// -- The names of the documents or directories of them, in order
+//
+// Outputs:
+// -- The text of each document and the document an offset falls in
+//
+// Assumptions:
+// -- No document is modified while it is mapped
+// 
+// Major algorithms & key variables:
+// Algorithms: Binary search of the document bases, worker pool
+// Key Variables: vector<unique_ptr<MappedFile>> texts; vector<size_t> bases
+
+#pragma once
+
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+using namespace std;
+
+class Corpus {
+
+private:
+   vector<unique_ptr<MappedFile>> texts;
+   vector<string> names;
+   vector<size_t> bases;
+   size_t total;
+
+   // a Corpus owns its mappings and is never copied
+   Corpus(const Corpus&);
+   Corpus& operator=(const Corpus&);
+
+public:
+
+   //--------------------------------------------------------------------------
+   // Corpus();
+   // Constructor for Corpus
+   // Preconditions: None
+   // Postconditions: Corpus with no documents
+   // Return value: None
+   // Functions called: None
+   Corpus();
+
+   //--------------------------------------------------------------------------
+   // bool addDocument(const string& name);
+   // Maps the document name as the next document of the Corpus. A document
+   // that cannot be opened is still added, as an empty one.
+   // Preconditions: None
+   // Postconditions: numDocuments() increased by one
+   // Return value: True if the document was opened, false otherwise
+   // Functions called: open
+   bool addDocument(const string& name);
+
+   //--------------------------------------------------------------------------
+   // bool addDocuments(const vector<string>& toAdd, int numThreads);
+   // Maps each of toAdd as the next documents of the Corpus, in order, with
+   // numThreads threads taking the next unmapped document until none are
+   // left. Documents that cannot be opened are added as empty ones.
+   // Preconditions: numThreads >= 1
+   // Postconditions: numDocuments() increased by the size of toAdd
+   // Return value: True if every document was opened, false otherwise
+   // Functions called: open
+   bool addDocuments(const vector<string>& toAdd, int numThreads);
+
+   //--------------------------------------------------------------------------
+   // static bool listDocuments(const string& path, vector<string>& names);
+   // Adds path to names, or if path is a directory, every file within it
+   // and the directories under it, in order of their paths
+   // Preconditions: None
+   // Postconditions: names has the documents of path at its end
+   // Return value: False if path is a directory that could not be read,
+   //               true otherwise
+   // Functions called: listDocuments
+   static bool listDocuments(const string& path, vector<string>& names);
+
+   //--------------------------------------------------------------------------
+   // void clear();
+   // Preconditions: None
+   // Postconditions: Every document unmapped, Corpus has no documents
+   // Return value: None
+   // Functions called: None
+   void clear();
+
+   //--------------------------------------------------------------------------
+   // size_t numDocuments() const;
+   // Preconditions: None
+   // Postconditions: Corpus unchanged
+   // Return value: Number of documents added
+   // Functions called: None
+   size_t numDocuments() const;
+
+   //--------------------------------------------------------------------------
+   // size_t totalLength() const;
+   // Preconditions: None
+   // Postconditions: Corpus unchanged
+   // Return value: Total length of every document
+   // Functions called: None
+   size_t totalLength() const;
+
+   //--------------------------------------------------------------------------
+   // const string& getName(size_t document) const;
+   // Preconditions: document < numDocuments()
+   // Postconditions: Corpus unchanged
+   // Return value: The name the document was added with
+   // Functions called: None
+   const string& getName(size_t document) const;
+
+   //--------------------------------------------------------------------------
+   // bool isOpen(size_t document) const;
+   // Preconditions: document < numDocuments()
+   // Postconditions: Corpus unchanged
+   // Return value: True if the document was opened, false if it was added
+   //               as an empty one
+   // Functions called: isOpen
+   bool isOpen(size_t document) const;
+
+   //--------------------------------------------------------------------------
+   // const char* begin(size_t document) const;
+   // Preconditions: document < numDocuments()
+   // Postconditions: Corpus unchanged
+   // Return value: Pointer to the first byte of the document
+   // Functions called: begin
+   const char* begin(size_t document) const;
+
+   //--------------------------------------------------------------------------
+   // const char* end(size_t document) const;
+   // Preconditions: document < numDocuments()
+   // Postconditions: Corpus unchanged
+   // Return value: Pointer one past the last byte of the document
+   // Functions called: end
+   const char* end(size_t document) const;
+
+   //--------------------------------------------------------------------------
+   // size_t length(size_t document) const;
+   // Preconditions: document < numDocuments()
+   // Postconditions: Corpus unchanged
+   // Return value: Number of bytes in the document
+   // Functions called: length
+   size_t length(size_t document) const;
+
+   //--------------------------------------------------------------------------
+   // size_t base(size_t document) const;
+   // Preconditions: document < numDocuments()
+   // Postconditions: Corpus unchanged
+   // Return value: Offset of the document's first byte within the Corpus
+   // Functions called: None
+   size_t base(size_t document) const;
+
+   //--------------------------------------------------------------------------
+   // size_t findDocument(size_t offset) const;
+   // Binary searches the document bases for the document holding offset
+   // Preconditions: offset < totalLength()
+   // Postconditions: Corpus unchanged
+   // Return value: The document whose bytes include offset
+   // Functions called: None
+   size_t findDocument(size_t offset) const;
+};
\ No newline at end of file
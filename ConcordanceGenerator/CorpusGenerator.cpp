@@ -0,0 +1,283 @@
+// CorpusGenerator.cpp
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A CorpusGenerator writes a synthetic text for measuring the concordance
+// generator. It makes a vocabulary of distinct random words, then writes
+// words drawn from it until the text is the length asked for. Word
+// frequencies follow Zipf's law: the word of rank r is drawn in proportion
+// to 1 / r^skew, so a skew of 0 draws every word equally often and larger
+// skews make a few words most of the text, as in natural language. The
+// words may be written in the order they are drawn, or sorted so that each
+// word's occurrences follow one another in alphabetical order, which is the
+// order that unbalances a plain binary search tree. Everything is drawn
+// from a seeded pseudo-random generator, so the same settings always give
+// the same text on every machine.
+//
+// Inputs:
+// -- The vocabulary size, skew, order, length and seed of the text
+//
+// Outputs:
+// -- A text file of words separated by spaces and end lines, some ending
+//    in punctuation
+//
+// Assumptions:
+// -- The vocabulary is small enough to hold in memory
+//
+// Major algorithms & key variables:
+// Algorithms: xorshift64* pseudo-random numbers, Zipf sampling by binary
+// search of the cumulative frequencies
+// Key Variables: vector<string> vocabulary; vector<double> cumulative;
+// uint64_t state
+
+#include "CorpusGenerator.h"
+#include <fstream>
+#include <algorithm>
+#include <unordered_set>
+#include <cmath>
+
+//--------------------------------------------------------------------------
+// CorpusGenerator();
+// Constructor for CorpusGenerator
+// Preconditions: None
+// Postconditions: Settings are 10000 words, skew 1, random order,
+//                 16 MiB, seed 1
+// Return value: None
+// Functions called: None
+CorpusGenerator::CorpusGenerator() {
+   vocabularySize = 10000;
+   skew = 1.0;
+   sorted = false;
+   length = 16 << 20;
+   seed = 1;
+   state = 1;
+   tokensWritten = 0;
+}
+
+//--------------------------------------------------------------------------
+// void setVocabulary(size_t numWords);
+// Preconditions: numWords > 0
+// Postconditions: The text is drawn from numWords distinct words
+// Return value: None
+// Functions called: None
+void CorpusGenerator::setVocabulary(size_t numWords) {
+   vocabularySize = numWords;
+}
+
+//--------------------------------------------------------------------------
+// void setSkew(double exponent);
+// Preconditions: exponent >= 0
+// Postconditions: The word of rank r is drawn in proportion to
+//                 1 / r^exponent
+// Return value: None
+// Functions called: None
+void CorpusGenerator::setSkew(double exponent) {
+   skew = exponent;
+}
+
+//--------------------------------------------------------------------------
+// void setSorted(bool isSorted);
+// Preconditions: None
+// Postconditions: Words are written in alphabetical order if isSorted,
+//                 in the order drawn otherwise
+// Return value: None
+// Functions called: None
+void CorpusGenerator::setSorted(bool isSorted) {
+   sorted = isSorted;
+}
+
+//--------------------------------------------------------------------------
+// void setLength(size_t bytes);
+// Preconditions: None
+// Postconditions: The text is written until it is at least bytes long
+// Return value: None
+// Functions called: None
+void CorpusGenerator::setLength(size_t bytes) {
+   length = bytes;
+}
+
+//--------------------------------------------------------------------------
+// void setSeed(uint64_t newSeed);
+// Preconditions: None
+// Postconditions: The text is drawn from newSeed
+// Return value: None
+// Functions called: None
+void CorpusGenerator::setSeed(uint64_t newSeed) {
+   seed = newSeed;
+}
+
+//--------------------------------------------------------------------------
+// size_t numTokens() const;
+// Preconditions: None
+// Postconditions: CorpusGenerator unchanged
+// Return value: Number of words in the text last written
+// Functions called: None
+size_t CorpusGenerator::numTokens() const {
+   return tokensWritten;
+}
+
+//--------------------------------------------------------------------------
+// uint64_t nextRandom();
+// Preconditions: None
+// Postconditions: state advanced
+// Return value: The next pseudo-random number
+// Functions called: None
+uint64_t CorpusGenerator::nextRandom() {
+   // xorshift64*, which is the same on every machine, unlike the
+   // distributions of <random>
+   state ^= state >> 12;
+   state ^= state << 25;
+   state ^= state >> 27;
+   return state * 2685821657736338717ULL;
+}
+
+//--------------------------------------------------------------------------
+// double nextUniform();
+// Preconditions: None
+// Postconditions: state advanced
+// Return value: A pseudo-random number in [0, 1)
+// Functions called: nextRandom
+double CorpusGenerator::nextUniform() {
+   // the top 53 bits fill a double's mantissa exactly
+   return double(nextRandom() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//--------------------------------------------------------------------------
+// void makeVocabulary();
+// Makes vocabularySize distinct words and the Zipf frequencies of them
+// Preconditions: state seeded
+// Postconditions: vocabulary and cumulative filled
+// Return value: None
+// Functions called: nextRandom
+void CorpusGenerator::makeVocabulary() {
+   vocabulary.clear();
+   unordered_set<string> made;
+   string word;
+   while (vocabulary.size() < vocabularySize) {
+      // 2 to 9 letters, most often 5 or 6
+      uint64_t bits = nextRandom();
+      size_t wordLength = 2 + bits % 4 + (bits >> 8) % 5;
+      word.resize(wordLength);
+      for (size_t i = 0; i < wordLength; i++) {
+         word[i] = char('a' + nextRandom() % 26);
+      }
+      if (made.insert(word).second) {
+         vocabulary.push_back(word);
+      }
+   }
+
+   cumulative.resize(vocabularySize);
+   double total = 0;
+   for (size_t rank = 0; rank < vocabularySize; rank++) {
+      total += 1.0 / pow(double(rank + 1), skew);
+      cumulative[rank] = total;
+   }
+   for (size_t rank = 0; rank < vocabularySize; rank++) {
+      cumulative[rank] /= total;
+   }
+}
+
+//--------------------------------------------------------------------------
+// size_t drawWord();
+// Preconditions: makeVocabulary called
+// Postconditions: state advanced
+// Return value: The rank of a word drawn by its frequency
+// Functions called: nextUniform
+size_t CorpusGenerator::drawWord() {
+   size_t rank = size_t(upper_bound(cumulative.begin(), cumulative.end(),
+                                    nextUniform()) - cumulative.begin());
+   // rounding may leave the last cumulative frequency just under 1
+   return rank < vocabularySize ? rank : vocabularySize - 1;
+}
+
+//--------------------------------------------------------------------------
+// void appendWord(string& text, size_t rank, size_t& wordsOnLine);
+// Appends the word of rank to text, sometimes followed by punctuation,
+// then a space or, after WORDS_PER_LINE words, an end line
+// Preconditions: rank < vocabularySize
+// Postconditions: Word appended, tokensWritten counts it
+// Return value: None
+// Functions called: nextRandom
+void CorpusGenerator::appendWord(string& text, size_t rank, 
+                                 size_t& wordsOnLine) {
+   text += vocabulary[rank];
+   // one word in sixteen ends a clause or sentence
+   uint64_t punctuation = nextRandom() % 32;
+   if (punctuation == 0) {
+      text += '.';
+   }
+   else if (punctuation == 1) {
+      text += ',';
+   }
+   wordsOnLine++;
+   if (wordsOnLine == WORDS_PER_LINE) {
+      text += '\n';
+      wordsOnLine = 0;
+   }
+   else {
+      text += ' ';
+   }
+   tokensWritten++;
+}
+
+//--------------------------------------------------------------------------
+// bool write(const string& fileName);
+// Writes the text to fileName, replacing it
+// Preconditions: None
+// Postconditions: fileName holds the text
+// Return value: True if written, false if the file could not be written
+// Functions called: makeVocabulary, drawWord, appendWord
+bool CorpusGenerator::write(const string& fileName) {
+   ofstream out(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+   if (!out.is_open()) {
+      return false;
+   }
+   // xorshift never leaves a state of 0
+   state = seed * 0x9E3779B97F4A7C15ULL | 1;
+   makeVocabulary();
+   tokensWritten = 0;
+   size_t written = 0;
+   size_t wordsOnLine = 0;
+   string text;
+
+   if (!sorted) {
+      while (written + text.length() < length) {
+         appendWord(text, drawWord(), wordsOnLine);
+         if (text.length() >= WRITE_BLOCK) {
+            out.write(text.data(), streamsize(text.length()));
+            written += text.length();
+            text.clear();
+         }
+      }
+   }
+   else {
+      // draw every word first, counting each without punctuation, then
+      // write each word as many times as it was drawn, in word order
+      vector<size_t> counts(vocabularySize, 0);
+      size_t drawn = 0;
+      while (drawn < length) {
+         size_t rank = drawWord();
+         counts[rank]++;
+         drawn += vocabulary[rank].length() + 1;
+      }
+      vector<size_t> order(vocabularySize);
+      for (size_t rank = 0; rank < vocabularySize; rank++) {
+         order[rank] = rank;
+      }
+      const vector<string>& words = vocabulary;
+      sort(order.begin(), order.end(), [&words](size_t a, size_t b) {
+         return words[a] < words[b];
+      });
+      for (size_t i = 0; i < vocabularySize; i++) {
+         for (size_t j = 0; j < counts[order[i]]; j++) {
+            appendWord(text, order[i], wordsOnLine);
+            if (text.length() >= WRITE_BLOCK) {
+               out.write(text.data(), streamsize(text.length()));
+               text.clear();
+            }
+         }
+      }
+   }
+   out.write(text.data(), streamsize(text.length()));
+   return bool(out);
+}
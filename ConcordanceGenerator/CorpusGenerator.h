@@ -0,0 +1,171 @@
+// CorpusGenerator.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A CorpusGenerator writes a synthetic text for measuring the concordance
+// generator. It makes a vocabulary of distinct random words, then writes
+// words drawn from it until the text is the length asked for. Word
+// frequencies follow Zipf's law: the word of rank r is drawn in proportion
+// to 1 / r^skew, so a skew of 0 draws every word equally often and larger
+// skews make a few words most of the text, as in natural language. The
+// words may be written in the order they are drawn, or sorted so that each
+// word's occurrences follow one another in alphabetical order, which is the
+// order that unbalances a plain binary search tree. Everything is drawn
+// from a seeded pseudo-random generator, so the same settings always give
+// the same text on every machine.
+//
+// Inputs:
+// -- The vocabulary size, skew, order, length and seed of the text
+//
+// Outputs:
+// -- A text file of words separated by spaces and end lines, some ending
+//    in punctuation
+//
+// Assumptions:
+// -- The vocabulary is small enough to hold in memory
+//
+// Major algorithms & key variables:
+// Algorithms: xorshift64* pseudo-random numbers, Zipf sampling by binary
+// search of the cumulative frequencies
+// Key Variables: vector<string> vocabulary; vector<double> cumulative;
+// uint64_t state
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+class CorpusGenerator {
+
+private:
+   size_t vocabularySize;
+   double skew;
+   bool sorted;
+   size_t length;
+   uint64_t seed;
+   uint64_t state;
+   vector<string> vocabulary;
+   // cumulative[r] is the chance of drawing a word of rank r or less
+   vector<double> cumulative;
+   size_t tokensWritten;
+
+   //--------------------------------------------------------------------------
+   // uint64_t nextRandom();
+   // Preconditions: None
+   // Postconditions: state advanced
+   // Return value: The next pseudo-random number
+   // Functions called: None
+   uint64_t nextRandom();
+
+   //--------------------------------------------------------------------------
+   // double nextUniform();
+   // Preconditions: None
+   // Postconditions: state advanced
+   // Return value: A pseudo-random number in [0, 1)
+   // Functions called: nextRandom
+   double nextUniform();
+
+   //--------------------------------------------------------------------------
+   // void makeVocabulary();
+   // Makes vocabularySize distinct words and the Zipf frequencies of them
+   // Preconditions: state seeded
+   // Postconditions: vocabulary and cumulative filled
+   // Return value: None
+   // Functions called: nextRandom
+   void makeVocabulary();
+
+   //--------------------------------------------------------------------------
+   // size_t drawWord();
+   // Preconditions: makeVocabulary called
+   // Postconditions: state advanced
+   // Return value: The rank of a word drawn by its frequency
+   // Functions called: nextUniform
+   size_t drawWord();
+
+   //--------------------------------------------------------------------------
+   // void appendWord(string& text, size_t rank, size_t& wordsOnLine);
+   // Appends the word of rank to text, sometimes followed by punctuation,
+   // then a space or, after WORDS_PER_LINE words, an end line
+   // Preconditions: rank < vocabularySize
+   // Postconditions: Word appended, tokensWritten counts it
+   // Return value: None
+   // Functions called: nextRandom
+   void appendWord(string& text, size_t rank, size_t& wordsOnLine);
+
+public:
+   static const size_t WORDS_PER_LINE = 12;
+   // text is written to the file in blocks of this many characters
+   static const size_t WRITE_BLOCK = 1 << 20;
+
+   //--------------------------------------------------------------------------
+   // CorpusGenerator();
+   // Constructor for CorpusGenerator
+   // Preconditions: None
+   // Postconditions: Settings are 10000 words, skew 1, random order,
+   //                 16 MiB, seed 1
+   // Return value: None
+   // Functions called: None
+   CorpusGenerator();
+
+   //--------------------------------------------------------------------------
+   // void setVocabulary(size_t numWords);
+   // Preconditions: numWords > 0
+   // Postconditions: The text is drawn from numWords distinct words
+   // Return value: None
+   // Functions called: None
+   void setVocabulary(size_t numWords);
+
+   //--------------------------------------------------------------------------
+   // void setSkew(double exponent);
+   // Preconditions: exponent >= 0
+   // Postconditions: The word of rank r is drawn in proportion to
+   //                 1 / r^exponent
+   // Return value: None
+   // Functions called: None
+   void setSkew(double exponent);
+
+   //--------------------------------------------------------------------------
+   // void setSorted(bool isSorted);
+   // Preconditions: None
+   // Postconditions: Words are written in alphabetical order if isSorted,
+   //                 in the order drawn otherwise
+   // Return value: None
+   // Functions called: None
+   void setSorted(bool isSorted);
+
+   //--------------------------------------------------------------------------
+   // void setLength(size_t bytes);
+   // Preconditions: None
+   // Postconditions: The text is written until it is at least bytes long
+   // Return value: None
+   // Functions called: None
+   void setLength(size_t bytes);
+
+   //--------------------------------------------------------------------------
+   // void setSeed(uint64_t newSeed);
+   // Preconditions: None
+   // Postconditions: The text is drawn from newSeed
+   // Return value: None
+   // Functions called: None
+   void setSeed(uint64_t newSeed);
+
+   //--------------------------------------------------------------------------
+   // bool write(const string& fileName);
+   // Writes the text to fileName, replacing it
+   // Preconditions: None
+   // Postconditions: fileName holds the text
+   // Return value: True if written, false if the file could not be written
+   // Functions called: makeVocabulary, drawWord, appendWord
+   bool write(const string& fileName);
+
+   //--------------------------------------------------------------------------
+   // size_t numTokens() const;
+   // Preconditions: None
+   // Postconditions: CorpusGenerator unchanged
+   // Return value: Number of words in the text last written
+   // Functions called: None
+   size_t numTokens() const;
+};
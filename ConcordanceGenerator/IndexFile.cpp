@@ -0,0 +1,635 @@
+// IndexFile.cpp
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// An IndexFile is a concordance saved to disk so that it can be queried
+// again without re-reading the text it was built from. The file is a run of
+// segments, each saved from one BST. A segment holds a Header, a table of
+// the documents the BST was built from, a table of keywords in sorted
+// order, the offsets of every occurrence of each keyword in those
+// documents, and a pool of the keyword characters followed by the paths of
+// the documents. New documents are added by appending a segment for them
+// alone, so appending costs only as much as the new documents and the
+// segments already saved are never rewritten. Opening an IndexFile maps it
+// and every document into memory; nothing is parsed or rebuilt, so a
+// keyword is found with a binary search of each segment's keyword table,
+// and its concordances are read from the documents in segment order, which
+// is the order the documents were added in. Displaying the segments
+// together gives the same concordance as one BST built from every document.
+// Only the headers are checked when the file is opened; each keyword entry
+// and its occurrences are checked as they are read, so a damaged file is
+// never read out of bounds and opening does not read the whole file.
+//
+// Inputs:
+// -- A BST and the Corpus it was built from, to save or append
+// -- The name of a saved IndexFile, to open
+//
+// Outputs:
+// -- A saved IndexFile
+// -- The concordances of all keywords, or of the keywords matching a
+//    KeywordQuery
+//
+// Assumptions:
+// -- Documents are not changed after they are indexed, which is checked by
+//    their length
+// -- IndexFiles are read on a machine with the same byte order as the one
+//    that saved them
+//
+// Major algorithms & key variables:
+// Algorithms: Binary search of each sorted keyword table, merging the
+// segments' keywords in order
+// Key Variables: vector<Segment> segments; MappedFile indexMap; Corpus corpus
+
+#include "IndexFile.h"
+#include "ConcordWriter.h"
+#include "RunStats.h"
+#include "KeywordQuery.h"
+#include <cstring>
+#include <cstdlib>
+
+static const char INDEX_MAGIC[8] = { 'C', 'O', 'N', 'G', 'I', 'D', 'X', '\0' };
+
+//--------------------------------------------------------------------------
+// IndexFile();
+// Constructor for IndexFile
+// Preconditions: None
+// Postconditions: IndexFile exists with no file open
+// Return value: None
+// Functions called: None
+IndexFile::IndexFile() {
+   showSources = false;
+}
+
+//--------------------------------------------------------------------------
+// static bool save(const string& fileName, const BST& theTree,
+//                  const Corpus& theCorpus, bool append);
+// Saves theTree as a segment of the IndexFile named fileName, replacing
+// the file or, if append is true, added to the end of it. Each document
+// of theCorpus is recorded as a full path.
+// Preconditions: theTree was built from theCorpus, fileName is a saved
+//                IndexFile if append is true
+// Postconditions: fileName holds the saved segment
+// Return value: True if saved, false if the file could not be written
+// Functions called: countTree, writeKeywords, writeOccurrences,
+//                   writeKeywordChars
+bool IndexFile::save(const string& fileName, const BST& theTree,
+                     const Corpus& theCorpus, bool append) {
+   vector<string> fullNames(theCorpus.numDocuments());
+   uint64_t nameBytes = 0;
+   for (size_t i = 0; i < fullNames.size(); i++) {
+      fullNames[i] = theCorpus.getName(i);
+#ifndef _WIN32
+      char* resolved = realpath(fullNames[i].c_str(), nullptr);
+      if (resolved != nullptr) {
+         fullNames[i] = resolved;
+         free(resolved);
+      }
+#endif
+      nameBytes += fullNames[i].length();
+   }
+   Header toWrite;
+   memset(&toWrite, 0, sizeof(toWrite));
+   memcpy(toWrite.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+   toWrite.byteOrder = ENDIAN_MARK;
+   toWrite.version = VERSION;
+   toWrite.numDocuments = fullNames.size();
+   uint64_t keyBytes = 0;
+   countTree(theTree, toWrite.numKeywords, toWrite.numOccurrences, keyBytes);
+   toWrite.documentsOffset = sizeof(Header);
+   toWrite.keywordsOffset = toWrite.documentsOffset + 
+                            toWrite.numDocuments * sizeof(DocumentEntry);
+   toWrite.occurrencesOffset = toWrite.keywordsOffset + 
+                               toWrite.numKeywords * sizeof(KeywordEntry);
+   toWrite.poolOffset = toWrite.occurrencesOffset + 
+                        toWrite.numOccurrences * sizeof(uint64_t);
+   toWrite.poolLength = keyBytes + nameBytes;
+   // the next segment's Header must be as aligned as this one
+   uint64_t padding = (8 - toWrite.poolLength % 8) % 8;
+   toWrite.segmentLength = toWrite.poolOffset + toWrite.poolLength + padding;
+
+   ios::openmode mode = ios::out | ios::binary;
+   mode |= append ? ios::app : ios::trunc;
+   ofstream out(fileName.c_str(), mode);
+   if (!out.is_open()) {
+      return false;
+   }
+   out.write(reinterpret_cast<const char*>(&toWrite), sizeof(toWrite));
+   uint64_t nextName = keyBytes;
+   for (size_t i = 0; i < fullNames.size(); i++) {
+      DocumentEntry document;
+      document.nameOffset = nextName;
+      document.nameLength = fullNames[i].length();
+      document.sourceLength = theCorpus.length(i);
+      out.write(reinterpret_cast<const char*>(&document), sizeof(document));
+      nextName += document.nameLength;
+   }
+   uint64_t nextOccurrence = 0;
+   uint64_t nextKey = 0;
+   writeKeywords(theTree, out, nextOccurrence, nextKey);
+   writeOccurrences(theTree, out);
+   writeKeywordChars(theTree, out);
+   for (size_t i = 0; i < fullNames.size(); i++) {
+      out.write(fullNames[i].data(), streamsize(fullNames[i].length()));
+   }
+   const char zeros[8] = { 0 };
+   out.write(zeros, streamsize(padding));
+   out.close();
+   return !out.fail();
+}
+
+//--------------------------------------------------------------------------
+// static void countTree(const BST& theTree, uint64_t& numKeywords,
+//                       uint64_t& numOccurrences, uint64_t& keyBytes);
+// Counts the BSTNodes, concordances and keyword characters in theTree
+// Preconditions: None
+// Postconditions: Counts increased by those in theTree
+// Return value: None
+// Functions called: next()
+void IndexFile::countTree(const BST& theTree, uint64_t& numKeywords,
+                          uint64_t& numOccurrences, uint64_t& keyBytes) {
+   for (BST::Iterator at(theTree); at.isValid(); at.next()) {
+      const BST::BSTNode* top = at.node();
+      numKeywords++;
+      keyBytes += top->keyLength;
+      numOccurrences += top->concord.size();
+   }
+}
+
+//--------------------------------------------------------------------------
+// static void writeKeywords(const BST& theTree, ofstream& out,
+//                           uint64_t& nextOccurrence, uint64_t& nextKey);
+// Writes a KeywordEntry for each BSTNode of theTree, in order
+// Preconditions: out is open
+// Postconditions: KeywordEntries written, nextOccurrence and nextKey
+//                 moved past those of theTree
+// Return value: None
+// Functions called: next()
+void IndexFile::writeKeywords(const BST& theTree, ofstream& out,
+                              uint64_t& nextOccurrence, uint64_t& nextKey) {
+   for (BST::Iterator at(theTree); at.isValid(); at.next()) {
+      const BST::BSTNode* top = at.node();
+      KeywordEntry entry;
+      entry.keyOffset = nextKey;
+      entry.keyLength = top->keyLength;
+      entry.firstOccurrence = nextOccurrence;
+      entry.numOccurrences = top->concord.size();
+      out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+      nextKey += entry.keyLength;
+      nextOccurrence += entry.numOccurrences;
+   }
+}
+
+//--------------------------------------------------------------------------
+// static void writeOccurrences(const BST& theTree, ofstream& out);
+// Writes the offset of every concordance in theTree, in order
+// Preconditions: out is open
+// Postconditions: Offsets written
+// Return value: None
+// Functions called: next()
+void IndexFile::writeOccurrences(const BST& theTree, ofstream& out) {
+   for (BST::Iterator at(theTree); at.isValid(); at.next()) {
+      const Postings& concord = at.node()->concord;
+      for (Postings::Iterator each(concord); each.isValid(); each.next()) {
+         uint64_t offset = each.offset();
+         out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+      }
+   }
+}
+
+//--------------------------------------------------------------------------
+// static void writeKeywordChars(const BST& theTree, ofstream& out);
+// Writes the characters of each keyword in theTree, in order
+// Preconditions: out is open
+// Postconditions: Keyword characters written
+// Return value: None
+// Functions called: next()
+void IndexFile::writeKeywordChars(const BST& theTree, ofstream& out) {
+   for (BST::Iterator at(theTree); at.isValid(); at.next()) {
+      out.write(at.keyword(), streamsize(at.keyLength()));
+   }
+}
+
+//--------------------------------------------------------------------------
+// bool open(const string& fileName);
+// Maps a saved IndexFile and every document it was built from
+// Preconditions: None
+// Postconditions: Keywords can be looked up and displayed
+// Return value: True if opened, false otherwise (see getProblem)
+// Functions called: mapSegments
+bool IndexFile::open(const string& fileName) {
+   return mapSegments(fileName, true);
+}
+
+//--------------------------------------------------------------------------
+// bool check(const string& fileName);
+// Checks that fileName is a saved IndexFile whose segments are whole, by
+// their headers alone, without mapping the documents it was built from
+// Preconditions: None
+// Postconditions: No IndexFile open
+// Return value: True if every segment is whole, false otherwise (see
+//               getProblem)
+// Functions called: mapSegments, close
+bool IndexFile::check(const string& fileName) {
+   if (!mapSegments(fileName, false)) {
+      return false;
+   }
+   close();
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// bool mapSegments(const string& fileName, bool mapDocuments);
+// Maps the IndexFile fileName and opens each of its segments in turn
+// Preconditions: None
+// Postconditions: Every segment is in segments, with its documents in
+//                 the Corpus if mapDocuments
+// Return value: True if every segment is whole, false otherwise (see
+//               getProblem)
+// Functions called: open, openSegment, fail
+bool IndexFile::mapSegments(const string& fileName, bool mapDocuments) {
+   close();
+   indexName = fileName;
+   problem.clear();
+   if (!indexMap.open(fileName)) {
+      return fail("could not open " + fileName);
+   }
+   if (indexMap.length() == 0) {
+      return fail(fileName + " is not an index file");
+   }
+   size_t start = 0;
+   while (start < indexMap.length()) {
+      if (!openSegment(start, fileName, mapDocuments)) {
+         return false;
+      }
+      start += size_t(segments.back().header->segmentLength);
+   }
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// bool openSegment(size_t start, const string& fileName,
+//                  bool mapDocuments);
+// Checks the header of the segment at offset start of the mapped
+// IndexFile and that every section lies within the segment and is
+// aligned, then, if mapDocuments, maps its documents as the next
+// documents of the Corpus. Keyword entries and occurrences are left to be
+// checked as they are read.
+// Preconditions: IndexFile mapped, start is where a segment begins
+// Postconditions: The segment is added to segments
+// Return value: True if the segment is whole, false otherwise (see
+//               getProblem)
+// Functions called: addDocument, fail
+bool IndexFile::openSegment(size_t start, const string& fileName,
+                            bool mapDocuments) {
+   uint64_t length = indexMap.length() - start;
+   if (length < sizeof(Header)) {
+      return fail(fileName + " is not an index file");
+   }
+   Segment segment;
+   const char* begin = indexMap.begin() + start;
+   segment.header = reinterpret_cast<const Header*>(begin);
+   const Header* header = segment.header;
+   if (memcmp(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+       header->byteOrder != ENDIAN_MARK) {
+      return fail(fileName + " is not an index file");
+   }
+   if (header->version != VERSION) {
+      return fail(fileName + " was saved by a different version");
+   }
+   // every section must lie within the segment, and the segment within
+   // the file, with the tables aligned to be read in place
+   if (header->segmentLength < sizeof(Header) ||
+       header->segmentLength > length || header->segmentLength % 8 != 0) {
+      return fail(fileName + " is damaged");
+   }
+   length = header->segmentLength;
+   if (header->documentsOffset > length ||
+       header->numDocuments > (length - header->documentsOffset) /
+                              sizeof(DocumentEntry) ||
+       header->keywordsOffset > length ||
+       header->numKeywords > (length - header->keywordsOffset) / 
+                             sizeof(KeywordEntry) ||
+       header->occurrencesOffset > length ||
+       header->numOccurrences > (length - header->occurrencesOffset) /
+                                sizeof(uint64_t) ||
+       header->poolOffset > length ||
+       header->poolLength > length - header->poolOffset ||
+       header->documentsOffset % 8 != 0 || header->keywordsOffset % 8 != 0 ||
+       header->occurrencesOffset % 8 != 0) {
+      return fail(fileName + " is damaged");
+   }
+   segment.documents = reinterpret_cast<const DocumentEntry*>(
+      begin + header->documentsOffset);
+   segment.keywords = reinterpret_cast<const KeywordEntry*>(
+      begin + header->keywordsOffset);
+   segment.occurrences = reinterpret_cast<const uint64_t*>(
+      begin + header->occurrencesOffset);
+   segment.pool = begin + header->poolOffset;
+   segment.base = corpus.totalLength();
+
+   for (uint64_t i = 0; mapDocuments && i < header->numDocuments; i++) {
+      const DocumentEntry& document = segment.documents[i];
+      if (document.nameOffset > header->poolLength ||
+          document.nameLength > header->poolLength - document.nameOffset) {
+         return fail(fileName + " is damaged");
+      }
+      string sourceName(segment.pool + document.nameOffset, 
+                        size_t(document.nameLength));
+      if (!corpus.addDocument(sourceName)) {
+         return fail("could not open the indexed text " + sourceName);
+      }
+      if (corpus.length(corpus.numDocuments() - 1) != document.sourceLength) {
+         return fail(sourceName + " has changed since it was indexed");
+      }
+   }
+   segment.sourceLength = corpus.totalLength() - segment.base;
+   segments.push_back(segment);
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// void close();
+// Unmaps the IndexFile and its documents
+// Preconditions: None
+// Postconditions: No IndexFile open
+// Return value: None
+// Functions called: close, clear
+void IndexFile::close() {
+   segments.clear();
+   corpus.clear();
+   indexMap.close();
+}
+
+//--------------------------------------------------------------------------
+// bool fail(const string& why);
+// Records why the IndexFile could not be opened and closes it
+// Preconditions: None
+// Postconditions: IndexFile closed, problem set
+// Return value: False
+// Functions called: close
+bool IndexFile::fail(const string& why) {
+   close();
+   problem = why;
+   return false;
+}
+
+//--------------------------------------------------------------------------
+// const string& getProblem() const;
+// Preconditions: None
+// Postconditions: IndexFile unchanged
+// Return value: Why the IndexFile could not be opened or displayed, empty
+//               if nothing has gone wrong since it was opened
+// Functions called: None
+const string& IndexFile::getProblem() const {
+   return problem;
+}
+
+//--------------------------------------------------------------------------
+// size_t numSegments() const;
+// Preconditions: None
+// Postconditions: IndexFile unchanged
+// Return value: Number of segments in the open IndexFile
+// Functions called: None
+size_t IndexFile::numSegments() const {
+   return segments.size();
+}
+
+//--------------------------------------------------------------------------
+// void addStats(RunStats& stats) const;
+// Adds the number of segments, documents, keywords and occurrences
+// saved in the open IndexFile to stats
+// Preconditions: None
+// Postconditions: IndexFile unchanged
+// Return value: None
+// Functions called: addCount
+void IndexFile::addStats(RunStats& stats) const {
+   stats.addCount("segments", segments.size());
+   stats.addCount("documents", corpus.numDocuments());
+   for (size_t i = 0; i < segments.size(); i++) {
+      stats.addCount("saved keywords", segments[i].header->numKeywords);
+      stats.addCount("occurrences", segments[i].header->numOccurrences);
+   }
+}
+
+//--------------------------------------------------------------------------
+// void setShowSources(bool show);
+// Sets whether each concordance is followed by the name of its document
+// and the position of the keyword in that document
+// Preconditions: IndexFile exists
+// Postconditions: Concordances displayed from now on show their source
+//                 if show
+// Return value: None
+// Functions called: None
+void IndexFile::setShowSources(bool show) {
+   showSources = show;
+}
+
+//--------------------------------------------------------------------------
+// void setLayout(const ConcordWriter::Layout& newLayout);
+// Sets how many words are shown either side of each keyword and how wide
+// the concordances and keyword are
+// Preconditions: Every number of newLayout is at least 1
+// Postconditions: Concordances displayed from now on follow newLayout
+// Return value: None
+// Functions called: None
+void IndexFile::setLayout(const ConcordWriter::Layout& newLayout) {
+   layout = newLayout;
+}
+
+//--------------------------------------------------------------------------
+// static int compareKey(const Segment& segment, size_t position,
+//                       const char* key, size_t length);
+// Compares the keyword at position of the segment to key, in the order
+// of the BST
+// Preconditions: segment mapped, position < its number of keywords, the
+//                keyword at position is whole
+// Postconditions: None
+// Return value: Negative if the keyword comes first, 0 if equal,
+//               positive if after
+// Functions called: None
+int IndexFile::compareKey(const Segment& segment, size_t position,
+                          const char* key, size_t length) {
+   const KeywordEntry& entry = segment.keywords[position];
+   size_t keyLength = size_t(entry.keyLength);
+   size_t shorter = length;
+   if (keyLength < shorter) {
+      shorter = keyLength;
+   }
+   int compared = memcmp(segment.pool + entry.keyOffset, key, shorter);
+   if (compared != 0) {
+      return compared;
+   }
+   if (keyLength < length) {
+      return -1;
+   }
+   if (keyLength > length) {
+      return 1;
+   }
+   return 0;
+}
+
+//--------------------------------------------------------------------------
+// static bool findKeyword(const Segment& segment, const char* key,
+//                         size_t length, size_t& position);
+// Binary searches the segment's keyword table for the first keyword that
+// is not less than key, checking each keyword compared to key
+// Preconditions: segment mapped
+// Postconditions: position is that keyword's, or the segment's number of
+//                 keywords if there is none
+// Return value: True if every keyword compared and the one at position
+//               are whole, false if one is damaged
+// Functions called: isWhole, compareKey
+bool IndexFile::findKeyword(const Segment& segment, const char* key,
+                            size_t length, size_t& position) {
+   size_t low = 0;
+   size_t high = size_t(segment.header->numKeywords);
+   while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      if (!isWhole(segment, middle)) {
+         return false;
+      }
+      if (compareKey(segment, middle, key, length) < 0) {
+         low = middle + 1;
+      }
+      else {
+         high = middle;
+      }
+   }
+   position = low;
+   return isWhole(segment, position);
+}
+
+//--------------------------------------------------------------------------
+// static bool isWhole(const Segment& segment, size_t position);
+// Checks that the characters of the keyword at position of the segment
+// lie within the pool and its occurrences within the occurrence table
+// Preconditions: segment mapped
+// Postconditions: None
+// Return value: True if the keyword is whole or position is past the
+//               segment's last keyword, false if it is damaged
+// Functions called: None
+bool IndexFile::isWhole(const Segment& segment, size_t position) {
+   const Header* header = segment.header;
+   if (position >= header->numKeywords) {
+      return true;
+   }
+   const KeywordEntry& entry = segment.keywords[position];
+   return entry.keyOffset <= header->poolLength &&
+          entry.keyLength <= header->poolLength - entry.keyOffset &&
+          entry.firstOccurrence <= header->numOccurrences &&
+          entry.numOccurrences <=
+             header->numOccurrences - entry.firstOccurrence;
+}
+
+//--------------------------------------------------------------------------
+// static bool displayKeyword(const Segment& segment, size_t position,
+//                            ConcordWriter& writer);
+// Writes every concordance of the keyword at position of the segment,
+// once every occurrence is checked to lie within the segment's documents
+// Preconditions: segment mapped, position < its number of keywords, the
+//                keyword at position is whole, writer's Corpus and
+//                keyword set
+// Postconditions: IndexFile unchanged
+// Return value: True if written, false if an occurrence is damaged and
+//               nothing was written
+// Functions called: writeConcord
+bool IndexFile::displayKeyword(const Segment& segment, size_t position,
+                               ConcordWriter& writer) {
+   const KeywordEntry& entry = segment.keywords[position];
+   const uint64_t* first = segment.occurrences + entry.firstOccurrence;
+   const uint64_t* last = first + entry.numOccurrences;
+   for (const uint64_t* current = first; current != last; current++) {
+      if (*current >= segment.sourceLength) {
+         return false;
+      }
+   }
+   for (const uint64_t* current = first; current != last; current++) {
+      writer.writeConcord(segment.base + size_t(*current));
+   }
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// void displayIndex();
+// Displays every concordance of every keyword, as BST::displayTree does
+// Preconditions: IndexFile open
+// Postconditions: IndexFile unchanged, or getProblem says which part of
+//                 it is damaged
+// Return value: Outputs the entire index
+// Functions called: displayQuery
+void IndexFile::displayIndex() {
+   string next;
+   displayQuery(KeywordQuery(), next);
+}
+
+//--------------------------------------------------------------------------
+// size_t displayQuery(const KeywordQuery& query, string& next);
+// Displays every concordance of the keywords matching query, reading
+// only those keywords' entries, up to the query's limit. Each keyword is
+// displayed once with its concordances from every segment. Display stops
+// at the first damaged keyword entry or occurrence, and getProblem then
+// says the IndexFile is damaged.
+// Preconditions: IndexFile open
+// Postconditions: IndexFile unchanged, next is the first matching keyword
+//                 left undisplayed by the limit, or empty if there is none
+// Return value: Number of keywords displayed
+// Functions called: findKeyword, isWhole, compareKey, isPastEnd,
+//                   displayKeyword
+size_t IndexFile::displayQuery(const KeywordQuery& query, string& next) {
+   ConcordWriter writer(cout);
+   writer.setCorpus(&corpus);
+   writer.setShowSources(showSources);
+   writer.setLayout(layout);
+   // the position reached in each segment's keyword table, whose keyword
+   // is checked before it is compared or displayed
+   vector<size_t> positions(segments.size());
+   size_t displayed = 0;
+   next.clear();
+   for (size_t i = 0; i < segments.size(); i++) {
+      if (!findKeyword(segments[i], query.start().data(),
+                       query.start().length(), positions[i])) {
+         problem = indexName + " is damaged";
+         return displayed;
+      }
+   }
+   while (true) {
+      // the least keyword any segment has left
+      const char* key = nullptr;
+      size_t keyLength = 0;
+      for (size_t i = 0; i < segments.size(); i++) {
+         const Segment& segment = segments[i];
+         if (positions[i] < segment.header->numKeywords &&
+             (key == nullptr || 
+              compareKey(segment, positions[i], key, keyLength) < 0)) {
+            const KeywordEntry& entry = segment.keywords[positions[i]];
+            key = segment.pool + entry.keyOffset;
+            keyLength = size_t(entry.keyLength);
+         }
+      }
+      if (key == nullptr || query.isPastEnd(key, keyLength)) {
+         break;
+      }
+      if (displayed == query.getLimit()) {
+         next.assign(key, keyLength);
+         break;
+      }
+      // in segment order, which is the order the documents were added
+      writer.setKeyword(key, keyLength);
+      for (size_t i = 0; i < segments.size(); i++) {
+         if (positions[i] < segments[i].header->numKeywords &&
+             compareKey(segments[i], positions[i], key, keyLength) == 0) {
+            if (!displayKeyword(segments[i], positions[i], writer)) {
+               problem = indexName + " is damaged";
+               return displayed;
+            }
+            positions[i]++;
+            if (!isWhole(segments[i], positions[i])) {
+               problem = indexName + " is damaged";
+               return displayed;
+            }
+         }
+      }
+      displayed++;
+   }
+   return displayed;
+}
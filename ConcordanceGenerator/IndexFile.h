@@ -0,0 +1,371 @@
+// IndexFile.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// An IndexFile is a concordance saved to disk so that it can be queried
+// again without re-reading the text it was built from. The file is a run of
+// segments, each saved from one BST. A segment holds a Header, a table of
+// the documents the BST was built from, a table of keywords in sorted
+// order, the offsets of every occurrence of each keyword in those
+// documents, and a pool of the keyword characters followed by the paths of
+// the documents. New documents are added by appending a segment for them
+// alone, so appending costs only as much as the new documents and the
+// segments already saved are never rewritten. Opening an IndexFile maps it
+// and every document into memory; nothing is parsed or rebuilt, so a
+// keyword is found with a binary search of each segment's keyword table,
+// and its concordances are read from the documents in segment order, which
+// is the order the documents were added in. Displaying the segments
+// together gives the same concordance as one BST built from every document.
+// Only the headers are checked when the file is opened; each keyword entry
+// and its occurrences are checked as they are read, so a damaged file is
+// never read out of bounds and opening does not read the whole file.
+//
+// Inputs:
+// -- A BST and the Corpus it was built from, to save or append
+// -- The name of a saved IndexFile, to open
+//
+// Outputs:
+// -- A saved IndexFile
+// -- The concordances of all keywords, or of the keywords matching a
+//    KeywordQuery
+//
+// Assumptions:
+// -- Documents are not changed after they are indexed, which is checked by
+//    their length
+// -- IndexFiles are read on a machine with the same byte order as the one
+//    that saved them
+//
+// Major algorithms & key variables:
+// Algorithms: Binary search of each sorted keyword table, merging the
+// segments' keywords in order
+// Key Variables: vector<Segment> segments; MappedFile indexMap; Corpus corpus
+
+#pragma once
+
+#include "BST.h"
+#include "Corpus.h"
+#include "MappedFile.h"
+#include "ConcordWriter.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+using namespace std;
+
+class KeywordQuery;
+class RunStats;
+
+class IndexFile {
+
+private:
+   struct Header {
+      char magic[8];
+      uint32_t byteOrder;
+      uint32_t version;
+      uint64_t segmentLength;
+      uint64_t numDocuments;
+      uint64_t numKeywords;
+      uint64_t numOccurrences;
+      uint64_t documentsOffset;
+      uint64_t keywordsOffset;
+      uint64_t occurrencesOffset;
+      uint64_t poolOffset;
+      uint64_t poolLength;
+   };
+   struct DocumentEntry {
+      uint64_t nameOffset;
+      uint64_t nameLength;
+      uint64_t sourceLength;
+   };
+   struct KeywordEntry {
+      uint64_t keyOffset;
+      uint64_t keyLength;
+      uint64_t firstOccurrence;
+      uint64_t numOccurrences;
+   };
+   // a segment as mapped, with where its documents begin in the Corpus
+   // and their total length
+   struct Segment {
+      const Header* header;
+      const DocumentEntry* documents;
+      const KeywordEntry* keywords;
+      const uint64_t* occurrences;
+      const char* pool;
+      size_t base;
+      size_t sourceLength;
+   };
+
+   static const uint32_t ENDIAN_MARK = 0x01020304;
+   static const uint32_t VERSION = 2;
+
+   MappedFile indexMap;
+   vector<Segment> segments;
+   Corpus corpus;
+   string indexName;
+   string problem;
+   bool showSources;
+   ConcordWriter::Layout layout;
+
+   //--------------------------------------------------------------------------
+   // static void countTree(const BST& theTree, uint64_t& numKeywords,
+   //                       uint64_t& numOccurrences, uint64_t& keyBytes);
+   // Counts the BSTNodes, concordances and keyword characters in theTree
+   // Preconditions: None
+   // Postconditions: Counts increased by those in theTree
+   // Return value: None
+   // Functions called: next()
+   static void countTree(const BST& theTree, uint64_t& numKeywords,
+                         uint64_t& numOccurrences, uint64_t& keyBytes);
+
+   //--------------------------------------------------------------------------
+   // static void writeKeywords(const BST& theTree, ofstream& out,
+   //                           uint64_t& nextOccurrence, uint64_t& nextKey);
+   // Writes a KeywordEntry for each BSTNode of theTree, in order
+   // Preconditions: out is open
+   // Postconditions: KeywordEntries written, nextOccurrence and nextKey
+   //                 moved past those of theTree
+   // Return value: None
+   // Functions called: next()
+   static void writeKeywords(const BST& theTree, ofstream& out,
+                             uint64_t& nextOccurrence, uint64_t& nextKey);
+
+   //--------------------------------------------------------------------------
+   // static void writeOccurrences(const BST& theTree, ofstream& out);
+   // Writes the offset of every concordance in theTree, in order
+   // Preconditions: out is open
+   // Postconditions: Offsets written
+   // Return value: None
+   // Functions called: next()
+   static void writeOccurrences(const BST& theTree, ofstream& out);
+
+   //--------------------------------------------------------------------------
+   // static void writeKeywordChars(const BST& theTree, ofstream& out);
+   // Writes the characters of each keyword in theTree, in order
+   // Preconditions: out is open
+   // Postconditions: Keyword characters written
+   // Return value: None
+   // Functions called: next()
+   static void writeKeywordChars(const BST& theTree, ofstream& out);
+
+   //--------------------------------------------------------------------------
+   // bool mapSegments(const string& fileName, bool mapDocuments);
+   // Maps the IndexFile fileName and opens each of its segments in turn
+   // Preconditions: None
+   // Postconditions: Every segment is in segments, with its documents in
+   //                 the Corpus if mapDocuments
+   // Return value: True if every segment is whole, false otherwise (see
+   //               getProblem)
+   // Functions called: open, openSegment, fail
+   bool mapSegments(const string& fileName, bool mapDocuments);
+
+   //--------------------------------------------------------------------------
+   // bool openSegment(size_t start, const string& fileName,
+   //                  bool mapDocuments);
+   // Checks the header of the segment at offset start of the mapped
+   // IndexFile and that every section lies within the segment and is
+   // aligned, then, if mapDocuments, maps its documents as the next
+   // documents of the Corpus. Keyword entries and occurrences are left to be
+   // checked as they are read.
+   // Preconditions: IndexFile mapped, start is where a segment begins
+   // Postconditions: The segment is added to segments
+   // Return value: True if the segment is whole, false otherwise (see
+   //               getProblem)
+   // Functions called: addDocument, fail
+   bool openSegment(size_t start, const string& fileName,
+                    bool mapDocuments);
+
+   //--------------------------------------------------------------------------
+   // static bool findKeyword(const Segment& segment, const char* key,
+   //                         size_t length, size_t& position);
+   // Binary searches the segment's keyword table for the first keyword that
+   // is not less than key, checking each keyword compared to key
+   // Preconditions: segment mapped
+   // Postconditions: position is that keyword's, or the segment's number of
+   //                 keywords if there is none
+   // Return value: True if every keyword compared and the one at position
+   //               are whole, false if one is damaged
+   // Functions called: isWhole, compareKey
+   static bool findKeyword(const Segment& segment, const char* key,
+                           size_t length, size_t& position);
+
+   //--------------------------------------------------------------------------
+   // static bool isWhole(const Segment& segment, size_t position);
+   // Checks that the characters of the keyword at position of the segment
+   // lie within the pool and its occurrences within the occurrence table
+   // Preconditions: segment mapped
+   // Postconditions: None
+   // Return value: True if the keyword is whole or position is past the
+   //               segment's last keyword, false if it is damaged
+   // Functions called: None
+   static bool isWhole(const Segment& segment, size_t position);
+
+   //--------------------------------------------------------------------------
+   // static int compareKey(const Segment& segment, size_t position,
+   //                       const char* key, size_t length);
+   // Compares the keyword at position of the segment to key, in the order
+   // of the BST
+   // Preconditions: segment mapped, position < its number of keywords, the
+   //                keyword at position is whole
+   // Postconditions: None
+   // Return value: Negative if the keyword comes first, 0 if equal,
+   //               positive if after
+   // Functions called: None
+   static int compareKey(const Segment& segment, size_t position,
+                         const char* key, size_t length);
+
+   //--------------------------------------------------------------------------
+   // static bool displayKeyword(const Segment& segment, size_t position,
+   //                            ConcordWriter& writer);
+   // Writes every concordance of the keyword at position of the segment,
+   // once every occurrence is checked to lie within the segment's documents
+   // Preconditions: segment mapped, position < its number of keywords, the
+   //                keyword at position is whole, writer's Corpus and
+   //                keyword set
+   // Postconditions: IndexFile unchanged
+   // Return value: True if written, false if an occurrence is damaged and
+   //               nothing was written
+   // Functions called: writeConcord
+   static bool displayKeyword(const Segment& segment, size_t position,
+                              ConcordWriter& writer);
+
+   //--------------------------------------------------------------------------
+   // bool fail(const string& why);
+   // Records why the IndexFile could not be opened and closes it
+   // Preconditions: None
+   // Postconditions: IndexFile closed, problem set
+   // Return value: False
+   // Functions called: close
+   bool fail(const string& why);
+
+   // an IndexFile owns its mappings and is never copied
+   IndexFile(const IndexFile&);
+   IndexFile& operator=(const IndexFile&);
+
+public:
+
+   //--------------------------------------------------------------------------
+   // IndexFile();
+   // Constructor for IndexFile
+   // Preconditions: None
+   // Postconditions: IndexFile exists with no file open
+   // Return value: None
+   // Functions called: None
+   IndexFile();
+
+   //--------------------------------------------------------------------------
+   // static bool save(const string& fileName, const BST& theTree,
+   //                  const Corpus& theCorpus, bool append);
+   // Saves theTree as a segment of the IndexFile named fileName, replacing
+   // the file or, if append is true, added to the end of it. Each document
+   // of theCorpus is recorded as a full path.
+   // Preconditions: theTree was built from theCorpus, fileName is a saved
+   //                IndexFile if append is true
+   // Postconditions: fileName holds the saved segment
+   // Return value: True if saved, false if the file could not be written
+   // Functions called: countTree, writeKeywords, writeOccurrences,
+   //                   writeKeywordChars
+   static bool save(const string& fileName, const BST& theTree,
+                    const Corpus& theCorpus, bool append);
+
+   //--------------------------------------------------------------------------
+   // bool open(const string& fileName);
+   // Maps a saved IndexFile and every document it was built from
+   // Preconditions: None
+   // Postconditions: Keywords can be looked up and displayed
+   // Return value: True if opened, false otherwise (see getProblem)
+   // Functions called: mapSegments
+   bool open(const string& fileName);
+
+   //--------------------------------------------------------------------------
+   // bool check(const string& fileName);
+   // Checks that fileName is a saved IndexFile whose segments are whole, by
+   // their headers alone, without mapping the documents it was built from
+   // Preconditions: None
+   // Postconditions: No IndexFile open
+   // Return value: True if every segment is whole, false otherwise (see
+   //               getProblem)
+   // Functions called: mapSegments, close
+   bool check(const string& fileName);
+
+   //--------------------------------------------------------------------------
+   // void close();
+   // Unmaps the IndexFile and its documents
+   // Preconditions: None
+   // Postconditions: No IndexFile open
+   // Return value: None
+   // Functions called: close, clear
+   void close();
+
+   //--------------------------------------------------------------------------
+   // const string& getProblem() const;
+   // Preconditions: None
+   // Postconditions: IndexFile unchanged
+   // Return value: Why the IndexFile could not be opened or displayed, empty
+   //               if nothing has gone wrong since it was opened
+   // Functions called: None
+   const string& getProblem() const;
+
+   //--------------------------------------------------------------------------
+   // size_t numSegments() const;
+   // Preconditions: None
+   // Postconditions: IndexFile unchanged
+   // Return value: Number of segments in the open IndexFile
+   // Functions called: None
+   size_t numSegments() const;
+
+   //--------------------------------------------------------------------------
+   // void addStats(RunStats& stats) const;
+   // Adds the number of segments, documents, keywords and occurrences
+   // saved in the open IndexFile to stats
+   // Preconditions: None
+   // Postconditions: IndexFile unchanged
+   // Return value: None
+   // Functions called: addCount
+   void addStats(RunStats& stats) const;
+
+   //--------------------------------------------------------------------------
+   // void setShowSources(bool show);
+   // Sets whether each concordance is followed by the name of its document
+   // and the position of the keyword in that document
+   // Preconditions: IndexFile exists
+   // Postconditions: Concordances displayed from now on show their source
+   //                 if show
+   // Return value: None
+   // Functions called: None
+   void setShowSources(bool show);
+
+   //--------------------------------------------------------------------------
+   // void setLayout(const ConcordWriter::Layout& newLayout);
+   // Sets how many words are shown either side of each keyword and how wide
+   // the concordances and keyword are
+   // Preconditions: Every number of newLayout is at least 1
+   // Postconditions: Concordances displayed from now on follow newLayout
+   // Return value: None
+   // Functions called: None
+   void setLayout(const ConcordWriter::Layout& newLayout);
+
+   //--------------------------------------------------------------------------
+   // void displayIndex();
+   // Displays every concordance of every keyword, as BST::displayTree does
+   // Preconditions: IndexFile open
+   // Postconditions: IndexFile unchanged, or getProblem says which part of
+   //                 it is damaged
+   // Return value: Outputs the entire index
+   // Functions called: displayQuery
+   void displayIndex();
+
+   //--------------------------------------------------------------------------
+   // size_t displayQuery(const KeywordQuery& query, string& next);
+   // Displays every concordance of the keywords matching query, reading
+   // only those keywords' entries, up to the query's limit. Each keyword is
+   // displayed once with its concordances from every segment. Display stops
+   // at the first damaged keyword entry or occurrence, and getProblem then
+   // says the IndexFile is damaged.
+   // Preconditions: IndexFile open
+   // Postconditions: IndexFile unchanged, next is the first matching keyword
+   //                 left undisplayed by the limit, or empty if there is none
+   // Return value: Number of keywords displayed
+   // Functions called: findKeyword, isWhole, compareKey, isPastEnd,
+   //                   displayKeyword
+   size_t displayQuery(const KeywordQuery& query, string& next);
+};
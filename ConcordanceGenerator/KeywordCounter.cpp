@@ -0,0 +1,488 @@
+// KeywordCounter.cpp
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A KeywordCounter counts how often each keyword occurs without keeping
+// where, for when only the most frequent keywords or how often every
+// keyword occurs is wanted rather than the whole concordance. ReadIn reads
+// keywords into it just as into a BST, from one thread or several whose
+// KeywordCounters are merged in order. Each keyword is found by hashing it
+// into an open addressing table of Counters. By default every keyword gets
+// a Counter of its own and the counts are exact. Given a number of
+// Counters, the KeywordCounter instead keeps the Space-Saving summary of
+// the keywords in that fixed memory however large the text: once every
+// Counter is in use, a keyword without one takes over the Counter with the
+// smallest count, found at the top of a heap, and counts on from it. Every
+// keyword occurring more often than the number of keywords read divided by
+// the number of Counters is then sure to be counted, and each count is at
+// most its error more than the true count, never less.
+//
+// Inputs:
+// -- Keywords, as read by ReadIn
+// -- The number of Counters to keep, or none for exact counts
+//
+// Outputs:
+// -- The most frequent keywords and their counts
+//
+// Assumptions:
+// -- Fewer than 2^32 distinct keywords are counted
+//
+// Major algorithms & key variables:
+// Algorithms: Open addressing hash table with linear probing, FNV-1a hash,
+// Space-Saving with a min-heap of Counters, merging summaries
+// Key Variables: vector<Counter> counters; vector<uint32_t> slots;
+// vector<uint32_t> heap; size_t capacity
+
+#include "KeywordCounter.h"
+#include "RunStats.h"
+#include "WordHash.h"
+#include <algorithm>
+#include <iomanip>
+
+// the table is kept at most half full so probe sequences stay short
+static const size_t INITIAL_SLOTS = 512;
+
+//--------------------------------------------------------------------------
+// KeywordCounter();
+// Constructor for KeywordCounter
+// Preconditions: None
+// Postconditions: KeywordCounter counts exactly, and has counted nothing
+// Return value: None
+// Functions called: rehash
+KeywordCounter::KeywordCounter() {
+   capacity = 0;
+   numCounted = 0;
+   rehash(INITIAL_SLOTS);
+}
+
+//--------------------------------------------------------------------------
+// void setCapacity(size_t numCounters);
+// Sets the most Counters the KeywordCounter keeps, 0 for exact counts
+// Preconditions: Nothing counted yet
+// Postconditions: Counts are kept in at most numCounters Counters
+// Return value: None
+// Functions called: None
+void KeywordCounter::setCapacity(size_t numCounters) {
+   capacity = numCounters;
+   counters.reserve(capacity);
+   heap.reserve(capacity);
+}
+
+//--------------------------------------------------------------------------
+// void copySettings(const KeywordCounter& from);
+// Gives this KeywordCounter the capacity of from, so that a
+// KeywordCounter counting part of a text counts as from does
+// Preconditions: Nothing counted yet
+// Postconditions: Capacity the same as from
+// Return value: None
+// Functions called: None
+void KeywordCounter::copySettings(const KeywordCounter& from) {
+   setCapacity(from.capacity);
+}
+
+//--------------------------------------------------------------------------
+// void setCorpus(const Corpus* theCorpus);
+// Does nothing, as where keywords occur is never kept, but lets ReadIn
+// read into a KeywordCounter as into a BST
+// Preconditions: None
+// Postconditions: KeywordCounter unchanged
+// Return value: None
+// Functions called: None
+void KeywordCounter::setCorpus(const Corpus*) {
+}
+
+//--------------------------------------------------------------------------
+// void addKeyword(const string& toAdd, size_t offset);
+// Counts one occurrence of toAdd; offset is not kept
+// Preconditions: None
+// Postconditions: toAdd counted
+// Return value: None
+// Functions called: addCount
+void KeywordCounter::addKeyword(const string& toAdd, size_t) {
+   addCount(toAdd, 1, 0);
+   numCounted++;
+}
+
+//--------------------------------------------------------------------------
+// void addCount(const string& keyword, size_t count, size_t error);
+// Adds count and error to keyword's Counter, giving it one if it has
+// none, by taking over the Counter with the smallest count once there
+// are capacity of them
+// Preconditions: None
+// Postconditions: keyword has a Counter
+// Return value: None
+// Functions called: hashWord, findSlot, insertSlot, removeSlot, rehash,
+//                   siftUp, siftDown
+void KeywordCounter::addCount(const string& keyword, size_t count,
+                              size_t error) {
+   uint32_t hash = hashWord(keyword.data(), keyword.length());
+   size_t slot = findSlot(keyword, hash);
+   if (slots[slot] != 0) {
+      Counter& found = counters[slots[slot] - 1];
+      found.count += count;
+      found.error += error;
+      if (capacity > 0) {
+         siftDown(found.heapPosition);
+      }
+      return;
+   }
+   if (capacity == 0 || counters.size() < capacity) {
+      if ((counters.size() + 1) * 2 > slots.size()) {
+         rehash(slots.size() * 2);
+      }
+      Counter added;
+      added.keyword = keyword;
+      added.hash = hash;
+      added.count = count;
+      added.error = error;
+      added.heapPosition = heap.size();
+      counters.push_back(added);
+      uint32_t position = uint32_t(counters.size() - 1);
+      insertSlot(position);
+      if (capacity > 0) {
+         heap.push_back(position);
+         siftUp(heap.size() - 1);
+      }
+      return;
+   }
+   // every Counter is in use, so the keyword takes over the one with the
+   // smallest count, which it may have occurred as often as unseen
+   uint32_t position = heap[0];
+   Counter& smallest = counters[position];
+   removeSlot(findSlot(smallest.keyword, smallest.hash));
+   smallest.keyword = keyword;
+   smallest.hash = hash;
+   smallest.error = smallest.count + error;
+   smallest.count += count;
+   insertSlot(position);
+   siftDown(0);
+}
+
+//--------------------------------------------------------------------------
+// void mergeTree(KeywordCounter& other);
+// Adds the counts of other to this KeywordCounter. Exact counts are
+// summed. Otherwise a keyword without a Counter in one of them is taken
+// to have occurred as often as that one's smallest count, and only the
+// capacity of Counters with the largest counts are kept, so the merged
+// counts are within the sum of both errors of the true counts.
+// Preconditions: Both have the same capacity
+// Postconditions: other is empty, this KeywordCounter holds both counts
+// Return value: None
+// Functions called: addCount, findSlot, smallestCount, sortCounters,
+//                   rehash, siftDown
+void KeywordCounter::mergeTree(KeywordCounter& other) {
+   numCounted += other.numCounted;
+   if (capacity == 0) {
+      for (size_t i = 0; i < other.counters.size(); i++) {
+         const Counter& adding = other.counters[i];
+         addCount(adding.keyword, adding.count, adding.error);
+      }
+   }
+   else {
+      size_t thisSmallest = smallestCount();
+      size_t otherSmallest = other.smallestCount();
+      vector<bool> matched(other.counters.size(), false);
+      for (size_t i = 0; i < counters.size(); i++) {
+         Counter& current = counters[i];
+         size_t slot = other.findSlot(current.keyword, current.hash);
+         if (other.slots[slot] != 0) {
+            const Counter& match = other.counters[other.slots[slot] - 1];
+            current.count += match.count;
+            current.error += match.error;
+            matched[other.slots[slot] - 1] = true;
+         }
+         else {
+            current.count += otherSmallest;
+            current.error += otherSmallest;
+         }
+      }
+      for (size_t i = 0; i < other.counters.size(); i++) {
+         if (!matched[i]) {
+            counters.push_back(other.counters[i]);
+            counters.back().count += thisSmallest;
+            counters.back().error += thisSmallest;
+         }
+      }
+      // keep only the Counters with the largest counts
+      if (counters.size() > capacity) {
+         vector<uint32_t> order;
+         sortCounters(order, capacity);
+         vector<Counter> kept;
+         kept.reserve(capacity);
+         for (size_t i = 0; i < capacity; i++) {
+            kept.push_back(counters[order[i]]);
+         }
+         counters.swap(kept);
+      }
+      size_t numSlots = INITIAL_SLOTS;
+      while (counters.size() * 2 > numSlots) {
+         numSlots *= 2;
+      }
+      rehash(numSlots);
+      heap.clear();
+      for (size_t i = 0; i < counters.size(); i++) {
+         counters[i].heapPosition = i;
+         heap.push_back(uint32_t(i));
+      }
+      for (size_t i = heap.size() / 2; i > 0; i--) {
+         siftDown(i - 1);
+      }
+   }
+   other.counters.clear();
+   other.heap.clear();
+   other.numCounted = 0;
+   other.rehash(INITIAL_SLOTS);
+}
+
+//--------------------------------------------------------------------------
+// size_t smallestCount() const;
+// Preconditions: None
+// Postconditions: KeywordCounter unchanged
+// Return value: The smallest count if every Counter is in use, which a
+//               keyword without one may have occurred as often as, 0
+//               otherwise
+// Functions called: None
+size_t KeywordCounter::smallestCount() const {
+   if (capacity == 0 || counters.size() < capacity) {
+      return 0;
+   }
+   return counters[heap[0]].count;
+}
+
+//--------------------------------------------------------------------------
+// bool isExact() const;
+// Preconditions: None
+// Postconditions: KeywordCounter unchanged
+// Return value: True if every keyword has a Counter, false otherwise
+// Functions called: None
+bool KeywordCounter::isExact() const {
+   return capacity == 0 || counters.size() < capacity;
+}
+
+//--------------------------------------------------------------------------
+// void sortCounters(vector<uint32_t>& order, size_t numFirst) const;
+// Sorts the positions of the numFirst Counters with the largest counts
+// to the front of order, largest first and then by keyword
+// Preconditions: None
+// Postconditions: order holds the position of every Counter
+// Return value: None
+// Functions called: partial_sort
+void KeywordCounter::sortCounters(vector<uint32_t>& order,
+                                  size_t numFirst) const {
+   order.resize(counters.size());
+   for (size_t i = 0; i < order.size(); i++) {
+      order[i] = uint32_t(i);
+   }
+   if (numFirst > order.size()) {
+      numFirst = order.size();
+   }
+   const vector<Counter>& all = counters;
+   partial_sort(order.begin(), order.begin() + numFirst, order.end(),
+                [&all](uint32_t first, uint32_t second) {
+      if (all[first].count != all[second].count) {
+         return all[first].count > all[second].count;
+      }
+      return all[first].keyword < all[second].keyword;
+   });
+}
+
+//--------------------------------------------------------------------------
+// void mostFrequent(size_t numKeywords, vector<Frequency>& frequent)
+//                   const;
+// Finds the numKeywords keywords with the largest counts, or every
+// keyword counted if numKeywords is 0
+// Preconditions: None
+// Postconditions: frequent holds them, the largest count first and
+//                 keywords with the same count in order
+// Return value: None
+// Functions called: sortCounters
+void KeywordCounter::mostFrequent(size_t numKeywords,
+                                  vector<Frequency>& frequent) const {
+   if (numKeywords == 0 || numKeywords > counters.size()) {
+      numKeywords = counters.size();
+   }
+   vector<uint32_t> order;
+   sortCounters(order, numKeywords);
+   frequent.resize(numKeywords);
+   for (size_t i = 0; i < numKeywords; i++) {
+      const Counter& current = counters[order[i]];
+      frequent[i].keyword = current.keyword;
+      frequent[i].count = current.count;
+      frequent[i].error = current.error;
+   }
+}
+
+//--------------------------------------------------------------------------
+// void displayTop(size_t numKeywords) const;
+// Displays the numKeywords keywords with the largest counts, or every
+// keyword counted if numKeywords is 0, one to a line after its count.
+// Approximate counts are followed by the count each keyword is sure to
+// have reached.
+// Preconditions: None
+// Postconditions: KeywordCounter unchanged
+// Return value: Outputs the keywords and counts
+// Functions called: mostFrequent
+void KeywordCounter::displayTop(size_t numKeywords) const {
+   vector<Frequency> frequent;
+   mostFrequent(numKeywords, frequent);
+   bool exact = isExact();
+   for (size_t i = 0; i < frequent.size(); i++) {
+      cout << setw(10) << frequent[i].count << "  " << frequent[i].keyword;
+      if (!exact) {
+         cout << "  (at least " << frequent[i].count - frequent[i].error
+              << ")";
+      }
+      cout << "\n";
+   }
+   cout.flush();
+}
+
+//--------------------------------------------------------------------------
+// void addStats(RunStats& stats) const;
+// Adds the number of keywords counted and of Counters kept to stats
+// Preconditions: None
+// Postconditions: KeywordCounter unchanged
+// Return value: None
+// Functions called: addCount
+void KeywordCounter::addStats(RunStats& stats) const {
+   stats.addCount("keywords counted", numCounted);
+   stats.addCount("counters", counters.size());
+}
+
+//--------------------------------------------------------------------------
+// size_t findSlot(const string& keyword, uint32_t hash) const;
+// Preconditions: hash is the hash of keyword
+// Postconditions: KeywordCounter unchanged
+// Return value: The slot holding keyword's Counter, or the empty slot
+//               ending its probe sequence if it has none
+// Functions called: None
+size_t KeywordCounter::findSlot(const string& keyword, uint32_t hash) const {
+   size_t mask = slots.size() - 1;
+   size_t slot = hash & mask;
+   // an empty slot ends the probe sequence; the table is never full
+   while (slots[slot] != 0) {
+      const Counter& current = counters[slots[slot] - 1];
+      if (current.hash == hash && current.keyword == keyword) {
+         return slot;
+      }
+      slot = (slot + 1) & mask;
+   }
+   return slot;
+}
+
+//--------------------------------------------------------------------------
+// void insertSlot(uint32_t position);
+// Adds the Counter at position of counters to the table
+// Preconditions: Its keyword is not in the table, which has room
+// Postconditions: The Counter can be found by its keyword
+// Return value: None
+// Functions called: None
+void KeywordCounter::insertSlot(uint32_t position) {
+   size_t mask = slots.size() - 1;
+   size_t slot = counters[position].hash & mask;
+   while (slots[slot] != 0) {
+      slot = (slot + 1) & mask;
+   }
+   slots[slot] = position + 1;
+}
+
+//--------------------------------------------------------------------------
+// void removeSlot(size_t slot);
+// Empties slot, moving back any later slot of its probe sequence so
+// that no sequence is broken
+// Preconditions: slot holds a Counter
+// Postconditions: That Counter can no longer be found by its keyword
+// Return value: None
+// Functions called: None
+void KeywordCounter::removeSlot(size_t slot) {
+   size_t mask = slots.size() - 1;
+   size_t empty = slot;
+   size_t next = (slot + 1) & mask;
+   while (slots[next] != 0) {
+      size_t home = counters[slots[next] - 1].hash & mask;
+      // a slot may move back into the empty one only if its probe
+      // sequence, from home to next, passes through it
+      if (((next - home) & mask) >= ((next - empty) & mask)) {
+         slots[empty] = slots[next];
+         empty = next;
+      }
+      next = (next + 1) & mask;
+   }
+   slots[empty] = 0;
+}
+
+//--------------------------------------------------------------------------
+// void rehash(size_t numSlots);
+// Makes the table numSlots slots and adds every Counter again
+// Preconditions: numSlots is a power of two, more than twice the
+//                number of Counters
+// Postconditions: Every Counter can be found by its keyword
+// Return value: None
+// Functions called: insertSlot
+void KeywordCounter::rehash(size_t numSlots) {
+   slots.assign(numSlots, 0);
+   for (size_t i = 0; i < counters.size(); i++) {
+      insertSlot(uint32_t(i));
+   }
+}
+
+//--------------------------------------------------------------------------
+// void swapHeap(size_t first, size_t second);
+// Preconditions: first and second are positions in the heap
+// Postconditions: The Counters at first and second are swapped
+// Return value: None
+// Functions called: None
+void KeywordCounter::swapHeap(size_t first, size_t second) {
+   swap(heap[first], heap[second]);
+   counters[heap[first]].heapPosition = first;
+   counters[heap[second]].heapPosition = second;
+}
+
+//--------------------------------------------------------------------------
+// void siftUp(size_t position);
+// Moves the Counter at position of the heap up until its parent's count
+// is no larger
+// Preconditions: The heap is in order but for that Counter
+// Postconditions: The heap is in order
+// Return value: None
+// Functions called: swapHeap
+void KeywordCounter::siftUp(size_t position) {
+   while (position > 0) {
+      size_t parent = (position - 1) / 2;
+      if (counters[heap[parent]].count <= counters[heap[position]].count) {
+         break;
+      }
+      swapHeap(parent, position);
+      position = parent;
+   }
+}
+
+//--------------------------------------------------------------------------
+// void siftDown(size_t position);
+// Moves the Counter at position of the heap down until its children's
+// counts are no smaller
+// Preconditions: The heap is in order but for that Counter
+// Postconditions: The heap is in order
+// Return value: None
+// Functions called: swapHeap
+void KeywordCounter::siftDown(size_t position) {
+   size_t size = heap.size();
+   while (true) {
+      size_t smallest = position;
+      size_t left = position * 2 + 1;
+      size_t right = left + 1;
+      if (left < size &&
+          counters[heap[left]].count < counters[heap[smallest]].count) {
+         smallest = left;
+      }
+      if (right < size &&
+          counters[heap[right]].count < counters[heap[smallest]].count) {
+         smallest = right;
+      }
+      if (smallest == position) {
+         break;
+      }
+      swapHeap(position, smallest);
+      position = smallest;
+   }
+}
@@ -0,0 +1,279 @@
+// KeywordCounter.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A KeywordCounter counts how often each keyword occurs without keeping
+// where, for when only the most frequent keywords or how often every
+// keyword occurs is wanted rather than the whole concordance. ReadIn reads
+// keywords into it just as into a BST, from one thread or several whose
+// KeywordCounters are merged in order. Each keyword is found by hashing it
+// into an open addressing table of Counters. By default every keyword gets
+// a Counter of its own and the counts are exact. Given a number of
+// Counters, the KeywordCounter instead keeps the Space-Saving summary of
+// the keywords in that fixed memory however large the text: once every
+// Counter is in use, a keyword without one takes over the Counter with the
+// smallest count, found at the top of a heap, and counts on from it. Every
+// keyword occurring more often than the number of keywords read divided by
+// the number of Counters is then sure to be counted, and each count is at
+// most its error more than the true count, never less.
+//
+// Inputs:
+// -- Keywords, as read by ReadIn
+// -- The number of Counters to keep, or none for exact counts
+//
+// Outputs:
+// -- The most frequent keywords and their counts
+//
+// Assumptions:
+// -- Fewer than 2^32 distinct keywords are counted
+//
+// Major algorithms & key variables:
+// Algorithms: Open addressing hash table with linear probing, FNV-1a hash,
+// Space-Saving with a min-heap of Counters, merging summaries
+// Key Variables: vector<Counter> counters; vector<uint32_t> slots;
+// vector<uint32_t> heap; size_t capacity
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class Corpus;
+class RunStats;
+
+class KeywordCounter {
+
+public:
+   // a keyword and how often it occurred: between count - error and count
+   struct Frequency {
+      string keyword;
+      size_t count;
+      size_t error;
+   };
+
+private:
+   struct Counter {
+      string keyword;
+      uint32_t hash;
+      size_t count;
+      size_t error;
+      // where the Counter is in the heap, when there is one
+      size_t heapPosition;
+   };
+
+   // one more than the position in counters of the Counter each slot
+   // holds, or 0 for an empty slot; kept at most half full
+   vector<uint32_t> slots;
+   vector<Counter> counters;
+   // positions in counters, the smallest count first
+   vector<uint32_t> heap;
+   // the most Counters kept, or 0 for a Counter for every keyword
+   size_t capacity;
+   size_t numCounted;
+
+   //--------------------------------------------------------------------------
+   // size_t findSlot(const string& keyword, uint32_t hash) const;
+   // Preconditions: hash is the hash of keyword
+   // Postconditions: KeywordCounter unchanged
+   // Return value: The slot holding keyword's Counter, or the empty slot
+   //               ending its probe sequence if it has none
+   // Functions called: None
+   size_t findSlot(const string& keyword, uint32_t hash) const;
+
+   //--------------------------------------------------------------------------
+   // void insertSlot(uint32_t position);
+   // Adds the Counter at position of counters to the table
+   // Preconditions: Its keyword is not in the table, which has room
+   // Postconditions: The Counter can be found by its keyword
+   // Return value: None
+   // Functions called: None
+   void insertSlot(uint32_t position);
+
+   //--------------------------------------------------------------------------
+   // void removeSlot(size_t slot);
+   // Empties slot, moving back any later slot of its probe sequence so
+   // that no sequence is broken
+   // Preconditions: slot holds a Counter
+   // Postconditions: That Counter can no longer be found by its keyword
+   // Return value: None
+   // Functions called: None
+   void removeSlot(size_t slot);
+
+   //--------------------------------------------------------------------------
+   // void rehash(size_t numSlots);
+   // Makes the table numSlots slots and adds every Counter again
+   // Preconditions: numSlots is a power of two, more than twice the
+   //                number of Counters
+   // Postconditions: Every Counter can be found by its keyword
+   // Return value: None
+   // Functions called: insertSlot
+   void rehash(size_t numSlots);
+
+   //--------------------------------------------------------------------------
+   // void siftUp(size_t position);
+   // Moves the Counter at position of the heap up until its parent's count
+   // is no larger
+   // Preconditions: The heap is in order but for that Counter
+   // Postconditions: The heap is in order
+   // Return value: None
+   // Functions called: swapHeap
+   void siftUp(size_t position);
+
+   //--------------------------------------------------------------------------
+   // void siftDown(size_t position);
+   // Moves the Counter at position of the heap down until its children's
+   // counts are no smaller
+   // Preconditions: The heap is in order but for that Counter
+   // Postconditions: The heap is in order
+   // Return value: None
+   // Functions called: swapHeap
+   void siftDown(size_t position);
+
+   //--------------------------------------------------------------------------
+   // void swapHeap(size_t first, size_t second);
+   // Preconditions: first and second are positions in the heap
+   // Postconditions: The Counters at first and second are swapped
+   // Return value: None
+   // Functions called: None
+   void swapHeap(size_t first, size_t second);
+
+   //--------------------------------------------------------------------------
+   // size_t smallestCount() const;
+   // Preconditions: None
+   // Postconditions: KeywordCounter unchanged
+   // Return value: The smallest count if every Counter is in use, which a
+   //               keyword without one may have occurred as often as, 0
+   //               otherwise
+   // Functions called: None
+   size_t smallestCount() const;
+
+   //--------------------------------------------------------------------------
+   // void addCount(const string& keyword, size_t count, size_t error);
+   // Adds count and error to keyword's Counter, giving it one if it has
+   // none, by taking over the Counter with the smallest count once there
+   // are capacity of them
+   // Preconditions: None
+   // Postconditions: keyword has a Counter
+   // Return value: None
+   // Functions called: hashWord, findSlot, insertSlot, removeSlot, rehash,
+   //                   siftUp, siftDown
+   void addCount(const string& keyword, size_t count, size_t error);
+
+   //--------------------------------------------------------------------------
+   // void sortCounters(vector<uint32_t>& order, size_t numFirst) const;
+   // Sorts the positions of the numFirst Counters with the largest counts
+   // to the front of order, largest first and then by keyword
+   // Preconditions: None
+   // Postconditions: order holds the position of every Counter
+   // Return value: None
+   // Functions called: partial_sort
+   void sortCounters(vector<uint32_t>& order, size_t numFirst) const;
+
+public:
+
+   //--------------------------------------------------------------------------
+   // KeywordCounter();
+   // Constructor for KeywordCounter
+   // Preconditions: None
+   // Postconditions: KeywordCounter counts exactly, and has counted nothing
+   // Return value: None
+   // Functions called: rehash
+   KeywordCounter();
+
+   //--------------------------------------------------------------------------
+   // void setCapacity(size_t numCounters);
+   // Sets the most Counters the KeywordCounter keeps, 0 for exact counts
+   // Preconditions: Nothing counted yet
+   // Postconditions: Counts are kept in at most numCounters Counters
+   // Return value: None
+   // Functions called: None
+   void setCapacity(size_t numCounters);
+
+   //--------------------------------------------------------------------------
+   // void copySettings(const KeywordCounter& from);
+   // Gives this KeywordCounter the capacity of from, so that a
+   // KeywordCounter counting part of a text counts as from does
+   // Preconditions: Nothing counted yet
+   // Postconditions: Capacity the same as from
+   // Return value: None
+   // Functions called: None
+   void copySettings(const KeywordCounter& from);
+
+   //--------------------------------------------------------------------------
+   // void setCorpus(const Corpus* theCorpus);
+   // Does nothing, as where keywords occur is never kept, but lets ReadIn
+   // read into a KeywordCounter as into a BST
+   // Preconditions: None
+   // Postconditions: KeywordCounter unchanged
+   // Return value: None
+   // Functions called: None
+   void setCorpus(const Corpus* theCorpus);
+
+   //--------------------------------------------------------------------------
+   // void addKeyword(const string& toAdd, size_t offset);
+   // Counts one occurrence of toAdd; offset is not kept
+   // Preconditions: None
+   // Postconditions: toAdd counted
+   // Return value: None
+   // Functions called: addCount
+   void addKeyword(const string& toAdd, size_t offset);
+
+   //--------------------------------------------------------------------------
+   // void mergeTree(KeywordCounter& other);
+   // Adds the counts of other to this KeywordCounter. Exact counts are
+   // summed. Otherwise a keyword without a Counter in one of them is taken
+   // to have occurred as often as that one's smallest count, and only the
+   // capacity of Counters with the largest counts are kept, so the merged
+   // counts are within the sum of both errors of the true counts.
+   // Preconditions: Both have the same capacity
+   // Postconditions: other is empty, this KeywordCounter holds both counts
+   // Return value: None
+   // Functions called: addCount, findSlot, smallestCount, sortCounters,
+   //                   rehash, siftDown
+   void mergeTree(KeywordCounter& other);
+
+   //--------------------------------------------------------------------------
+   // void mostFrequent(size_t numKeywords, vector<Frequency>& frequent)
+   //                   const;
+   // Finds the numKeywords keywords with the largest counts, or every
+   // keyword counted if numKeywords is 0
+   // Preconditions: None
+   // Postconditions: frequent holds them, the largest count first and
+   //                 keywords with the same count in order
+   // Return value: None
+   // Functions called: sortCounters
+   void mostFrequent(size_t numKeywords, vector<Frequency>& frequent) const;
+
+   //--------------------------------------------------------------------------
+   // void displayTop(size_t numKeywords) const;
+   // Displays the numKeywords keywords with the largest counts, or every
+   // keyword counted if numKeywords is 0, one to a line after its count.
+   // Approximate counts are followed by the count each keyword is sure to
+   // have reached.
+   // Preconditions: None
+   // Postconditions: KeywordCounter unchanged
+   // Return value: Outputs the keywords and counts
+   // Functions called: mostFrequent
+   void displayTop(size_t numKeywords) const;
+
+   //--------------------------------------------------------------------------
+   // bool isExact() const;
+   // Preconditions: None
+   // Postconditions: KeywordCounter unchanged
+   // Return value: True if every keyword has a Counter, false otherwise
+   // Functions called: None
+   bool isExact() const;
+
+   //--------------------------------------------------------------------------
+   // void addStats(RunStats& stats) const;
+   // Adds the number of keywords counted and of Counters kept to stats
+   // Preconditions: None
+   // Postconditions: KeywordCounter unchanged
+   // Return value: None
+   // Functions called: addCount
+   void addStats(RunStats& stats) const;
+};
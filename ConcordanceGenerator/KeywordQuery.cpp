@@ -0,0 +1,144 @@
+// KeywordQuery.cpp
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// A KeywordQuery selects which keywords of a concordance are displayed: all
+// of them, a single keyword, every keyword starting with a prefix, or every
+// keyword from one word to another inclusive. The keywords matching any of
+// these form one run in sorted order, so a query is answered by seeking an
+// iterator over the index to the query's start and stepping forward until a
+// keyword is past the query's end, without visiting any other keyword.
+// A query may also be limited to a number of keywords, so that a large
+// concordance is displayed a page at a time, each page starting where the
+// last one stopped.
+// 
+// Inputs: 
+// -- A keyword, a prefix, or the first and last words of a range
+//
+// Outputs:
+// -- Where the matching run of keywords starts and whether a keyword is
+//    past its end
+//
+// Assumptions:
+// -- Keywords are compared as the BST compares them
+// 
+// Major algorithms & key variables:
+// Algorithms: None
+// Key Variables: string first, last; Kind kind; size_t limit
+
+#include "KeywordQuery.h"
+#include <cstring>
+
+//--------------------------------------------------------------------------
+// KeywordQuery();
+// Constructor for a KeywordQuery matching every keyword
+// Preconditions: None
+// Postconditions: Query matches all keywords
+// Return value: None
+// Functions called: None
+KeywordQuery::KeywordQuery() {
+   kind = ALL;
+   first = "";
+   last = "";
+   hasLast = false;
+   limit = NO_LIMIT;
+}
+
+//--------------------------------------------------------------------------
+// static KeywordQuery keyword(const string& word);
+// Preconditions: None
+// Postconditions: None
+// Return value: A query matching only word
+// Functions called: None
+KeywordQuery KeywordQuery::keyword(const string& word) {
+   KeywordQuery toReturn;
+   toReturn.kind = KEYWORD;
+   toReturn.first = word;
+   return toReturn;
+}
+
+//--------------------------------------------------------------------------
+// static KeywordQuery prefix(const string& start);
+// Preconditions: None
+// Postconditions: None
+// Return value: A query matching every keyword beginning with start
+// Functions called: None
+KeywordQuery KeywordQuery::prefix(const string& start) {
+   KeywordQuery toReturn;
+   toReturn.kind = PREFIX;
+   toReturn.first = start;
+   return toReturn;
+}
+
+//--------------------------------------------------------------------------
+// static KeywordQuery range(const string& from, const string& to, 
+//                           bool hasTo);
+// Preconditions: None
+// Postconditions: None
+// Return value: A query matching every keyword from from to to, 
+//               inclusive. With hasTo false there is no upper bound.
+// Functions called: None
+KeywordQuery KeywordQuery::range(const string& from, const string& to, 
+                                 bool hasTo) {
+   KeywordQuery toReturn;
+   toReturn.kind = RANGE;
+   toReturn.first = from;
+   toReturn.last = to;
+   toReturn.hasLast = hasTo;
+   return toReturn;
+}
+
+//--------------------------------------------------------------------------
+// void setLimit(size_t maxKeywords);
+// Limits how many keywords are displayed for the query
+// Preconditions: None
+// Postconditions: At most maxKeywords keywords are displayed
+// Return value: None
+// Functions called: None
+void KeywordQuery::setLimit(size_t maxKeywords) {
+   limit = maxKeywords;
+}
+
+//--------------------------------------------------------------------------
+// size_t getLimit() const;
+// Preconditions: None
+// Postconditions: KeywordQuery unchanged
+// Return value: The most keywords to display, NO_LIMIT if unlimited
+// Functions called: None
+size_t KeywordQuery::getLimit() const {
+   return limit;
+}
+
+//--------------------------------------------------------------------------
+// const string& start() const;
+// Preconditions: None
+// Postconditions: KeywordQuery unchanged
+// Return value: The least word any matching keyword can be
+// Functions called: None
+const string& KeywordQuery::start() const {
+   return first;
+}
+
+//--------------------------------------------------------------------------
+// bool isPastEnd(const char* key, size_t length) const;
+// Checks a keyword at or after start() in sorted order
+// Preconditions: key is not less than start()
+// Postconditions: KeywordQuery unchanged
+// Return value: True if key and every keyword after it do not match,
+//               false if key matches
+// Functions called: None
+bool KeywordQuery::isPastEnd(const char* key, size_t length) const {
+   switch (kind) {
+   case KEYWORD:
+      return length != first.length() || 
+             memcmp(key, first.data(), length) != 0;
+   case PREFIX:
+      return length < first.length() || 
+             memcmp(key, first.data(), first.length()) != 0;
+   case RANGE:
+      // past the end once the keyword sorts after last
+      return hasLast && last.compare(0, last.length(), key, length) < 0;
+   default:
+      return false;
+   }
+}
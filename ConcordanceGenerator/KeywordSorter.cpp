@@ -0,0 +1,425 @@
+// KeywordSorter.cpp
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A KeywordSorter builds a concordance by sorting rather than by searching
+// a tree for every word. ReadIn reads keywords into it just as into a BST,
+// from one thread or several whose KeywordSorters are merged in order, but
+// each keyword is only written down as a Record of the keyword and the
+// offset of its occurrence, at the end of a flat run of Records. Sorting
+// then orders each run by keyword and offset, every run on a thread of its
+// own with a radix sort of the Records' prefixes, and merges the sorted
+// runs a pair at a time, splitting each merge between threads at matching
+// Records of the pair, until one run is left.
+// A BST is built from the sorted Records in one pass, each keyword's
+// Records together and in the order the keyword occurred, which gives the
+// same concordance as adding every keyword to the BST as it was read. Each
+// Record holds the first eight characters of its keyword as a number, so
+// most Records are ordered by comparing one number, and the characters of
+// the keywords are copied into the KeywordSorter's Arena.
+//
+// Inputs:
+// -- Keywords, as read by ReadIn
+// -- The number of threads to sort with
+//
+// Outputs:
+// -- The Records of every keyword, sorted by keyword and offset
+//
+// Assumptions:
+// -- Keywords are read in order of offset within each KeywordSorter, and
+//    KeywordSorters are merged in order of offset
+//
+// Major algorithms & key variables:
+// Algorithms: Parallel merge sort: LSD radix sorting runs on separate
+// threads, then merging pairs of runs split at matching Records
+// Key Variables: vector<vector<Record>> runs; Arena arena
+
+#include "KeywordSorter.h"
+#include "RunStats.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstring>
+
+//--------------------------------------------------------------------------
+// KeywordSorter();
+// Constructor for KeywordSorter
+// Preconditions: None
+// Postconditions: KeywordSorter exists with one empty run
+// Return value: None
+// Functions called: None
+KeywordSorter::KeywordSorter() : runs(1) {
+   numRecords = 0;
+   numRunsSorted = 0;
+   numMerges = 0;
+}
+
+//--------------------------------------------------------------------------
+// void copySettings(const KeywordSorter& from);
+// Does nothing, as a KeywordSorter has no settings, but lets ReadIn read
+// into KeywordSorters as into BSTs
+// Preconditions: None
+// Postconditions: KeywordSorter unchanged
+// Return value: None
+// Functions called: None
+void KeywordSorter::copySettings(const KeywordSorter&) {
+}
+
+//--------------------------------------------------------------------------
+// void setCorpus(const Corpus* theCorpus);
+// Does nothing, as the concordance is displayed from the BST built from
+// the KeywordSorter, but lets ReadIn read into it as into a BST
+// Preconditions: None
+// Postconditions: KeywordSorter unchanged
+// Return value: None
+// Functions called: None
+void KeywordSorter::setCorpus(const Corpus*) {
+}
+
+//--------------------------------------------------------------------------
+// void addKeyword(const string& toAdd, size_t offset);
+// Adds a Record of toAdd at offset to the end of the last run, with a
+// copy of the keyword in the Arena
+// Preconditions: offset is after every offset already added
+// Postconditions: Record added, unsorted
+// Return value: None -- will quit if out of memory
+// Functions called: allocateBytes, prefixOf
+void KeywordSorter::addKeyword(const string& toAdd, size_t offset) {
+   Record record;
+   record.length = toAdd.length();
+   char* keyword = arena.allocateBytes(record.length);
+   memcpy(keyword, toAdd.data(), record.length);
+   record.keyword = keyword;
+   record.prefix = prefixOf(keyword, record.length);
+   record.offset = offset;
+   runs.back().push_back(record);
+   numRecords++;
+}
+
+//--------------------------------------------------------------------------
+// void mergeTree(KeywordSorter& other);
+// Moves the runs of other after the runs of this KeywordSorter, without
+// sorting them, along with the Arena holding their keywords
+// Preconditions: other's offsets are after this KeywordSorter's
+// Postconditions: other is empty, this KeywordSorter holds both Records
+// Return value: None
+// Functions called: adopt
+void KeywordSorter::mergeTree(KeywordSorter& other) {
+   if (&other == this) {
+      return;
+   }
+   for (size_t i = 0; i < other.runs.size(); i++) {
+      if (!other.runs[i].empty()) {
+         runs.push_back(vector<Record>());
+         runs.back().swap(other.runs[i]);
+      }
+   }
+   numRecords += other.numRecords;
+   other.runs.assign(1, vector<Record>());
+   other.numRecords = 0;
+   // the moved Records' keywords still live in other's Arena
+   arena.adopt(other.arena);
+}
+
+//--------------------------------------------------------------------------
+// void sort(int numThreads);
+// Sorts every run on its own thread, then merges pairs of runs, each
+// merge split between the threads it has to itself, until one sorted
+// run holds every Record
+// Preconditions: None
+// Postconditions: Records sorted by keyword and then offset
+// Return value: None
+// Functions called: runParallel, sortRun, mergePiece
+void KeywordSorter::sort(int numThreads) {
+   vector<vector<Record>> sorting;
+   for (size_t i = 0; i < runs.size(); i++) {
+      if (!runs[i].empty()) {
+         sorting.push_back(vector<Record>());
+         sorting.back().swap(runs[i]);
+      }
+   }
+   numRunsSorted += sorting.size();
+   runParallel(sorting.size(), numThreads, [&sorting](size_t run) {
+      sortRun(sorting[run]);
+   });
+
+   while (sorting.size() > 1) {
+      size_t numPairs = sorting.size() / 2;
+      vector<vector<Record>> merged((sorting.size() + 1) / 2);
+      for (size_t pair = 0; pair < numPairs; pair++) {
+         merged[pair].resize(sorting[2 * pair].size() +
+                             sorting[2 * pair + 1].size());
+      }
+      // a run left without a partner goes on to the next round as it is
+      if (sorting.size() % 2 == 1) {
+         merged.back().swap(sorting.back());
+      }
+      // the threads are shared between this round's merges, so the last
+      // round's one merge is split as many ways as there are threads
+      size_t numPieces = size_t(numThreads) / numPairs;
+      if (numPieces < 1) {
+         numPieces = 1;
+      }
+      runParallel(numPairs * numPieces, numThreads,
+                  [&sorting, &merged, numPieces](size_t task) {
+         size_t pair = task / numPieces;
+         mergePiece(sorting[2 * pair], sorting[2 * pair + 1],
+                    task % numPieces, numPieces, merged[pair]);
+      });
+      numMerges += numPairs;
+      sorting.swap(merged);
+   }
+   runs.swap(sorting);
+   if (runs.empty()) {
+      runs.push_back(vector<Record>());
+   }
+}
+
+//--------------------------------------------------------------------------
+// size_t size() const;
+// Preconditions: None
+// Postconditions: KeywordSorter unchanged
+// Return value: The number of Records
+// Functions called: None
+size_t KeywordSorter::size() const {
+   return numRecords;
+}
+
+//--------------------------------------------------------------------------
+// const Record* records() const;
+// Preconditions: sort called since the last Record was added
+// Postconditions: KeywordSorter unchanged
+// Return value: The size() sorted Records
+// Functions called: None
+const KeywordSorter::Record* KeywordSorter::records() const {
+   return runs[0].data();
+}
+
+//--------------------------------------------------------------------------
+// static bool sameKeyword(const Record& first, const Record& second);
+// Preconditions: None
+// Postconditions: None
+// Return value: True if both Records are of the same keyword, false
+//               otherwise
+// Functions called: None
+bool KeywordSorter::sameKeyword(const Record& first, const Record& second) {
+   return first.prefix == second.prefix && first.length == second.length &&
+          memcmp(first.keyword, second.keyword, first.length) == 0;
+}
+
+//--------------------------------------------------------------------------
+// void addStats(RunStats& stats) const;
+// Adds the number of Records sorted, of runs they were sorted in and of
+// merges, and what the Arena allocated for keywords to stats
+// Preconditions: None
+// Postconditions: KeywordSorter unchanged
+// Return value: None
+// Functions called: addCount, getStats
+void KeywordSorter::addStats(RunStats& stats) const {
+   stats.addCount("records sorted", numRecords);
+   stats.addCount("sorted runs", numRunsSorted);
+   stats.addCount("run merges", numMerges);
+   stats.addCount("record bytes", numRecords * sizeof(Record));
+   stats.addCount("sorter keyword bytes", arena.getStats().bytesAllocated);
+}
+
+//--------------------------------------------------------------------------
+// static uint64_t prefixOf(const char* keyword, size_t length);
+// Preconditions: keyword has length characters
+// Postconditions: None
+// Return value: The first eight characters of keyword as a number, the
+//               first in the highest byte and padded with zeros, which
+//               orders keywords as their first eight characters do
+// Functions called: None
+uint64_t KeywordSorter::prefixOf(const char* keyword, size_t length) {
+   uint64_t prefix = 0;
+   for (size_t i = 0; i < 8; i++) {
+      prefix <<= 8;
+      if (i < length) {
+         prefix |= (unsigned char)keyword[i];
+      }
+   }
+   return prefix;
+}
+
+//--------------------------------------------------------------------------
+// static bool lessRecord(const Record& first, const Record& second);
+// Orders Records by keyword, in the order of the BST, and then by offset
+// Preconditions: None
+// Postconditions: None
+// Return value: True if first comes before second, false otherwise
+// Functions called: compareKeywords
+bool KeywordSorter::lessRecord(const Record& first, const Record& second) {
+   if (first.prefix != second.prefix) {
+      return first.prefix < second.prefix;
+   }
+   int compared = compareKeywords(first, second);
+   if (compared != 0) {
+      return compared < 0;
+   }
+   return first.offset < second.offset;
+}
+
+//--------------------------------------------------------------------------
+// static int compareKeywords(const Record& first, const Record& second);
+// Compares the keywords of two Records in the same order as
+// string::compare
+// Preconditions: None
+// Postconditions: None
+// Return value: Negative if first's keyword comes first, 0 if equal,
+//               positive if after
+// Functions called: None
+int KeywordSorter::compareKeywords(const Record& first,
+                                   const Record& second) {
+   size_t shorter = first.length < second.length ? first.length
+                                                 : second.length;
+   int compared = memcmp(first.keyword, second.keyword, shorter);
+   if (compared != 0) {
+      return compared;
+   }
+   if (first.length != second.length) {
+      return first.length < second.length ? -1 : 1;
+   }
+   return 0;
+}
+
+//--------------------------------------------------------------------------
+// static void sortRun(vector<Record>& run);
+// Sorts a run whose Records are in order of offset by keyword, keeping
+// each keyword's Records in order of offset. The run is radix sorted a
+// byte of the prefix at a time from the lowest, skipping any byte every
+// Record shares, and each stretch of Records with the same prefix whose
+// keywords may still differ, as they are longer than eight characters or
+// differ in length, is then sorted by keyword with a stable sort.
+// Preconditions: run is in order of offset
+// Postconditions: run sorted by keyword and then offset
+// Return value: None
+// Functions called: stable_sort, compareKeywords
+void KeywordSorter::sortRun(vector<Record>& run) {
+   size_t numRun = run.size();
+   vector<Record> buffer(numRun);
+   // how many Records have each value of each byte of the prefix
+   vector<size_t> counts(8 * 256, 0);
+   for (size_t i = 0; i < numRun; i++) {
+      uint64_t prefix = run[i].prefix;
+      for (int byte = 0; byte < 8; byte++) {
+         counts[byte * 256 + ((prefix >> (8 * byte)) & 0xff)]++;
+      }
+   }
+   Record* from = run.data();
+   Record* to = buffer.data();
+   for (int byte = 0; byte < 8; byte++) {
+      size_t* count = &counts[byte * 256];
+      int shift = 8 * byte;
+      if (numRun == 0 || count[(from[0].prefix >> shift) & 0xff] == numRun) {
+         continue;
+      }
+      // each count becomes where the first Record with that byte goes
+      size_t position = 0;
+      for (int value = 0; value < 256; value++) {
+         size_t numValue = count[value];
+         count[value] = position;
+         position += numValue;
+      }
+      for (size_t i = 0; i < numRun; i++) {
+         to[count[(from[i].prefix >> shift) & 0xff]++] = from[i];
+      }
+      Record* sorted = to;
+      to = from;
+      from = sorted;
+   }
+   if (from != run.data()) {
+      run.swap(buffer);
+   }
+
+   size_t first = 0;
+   while (first < numRun) {
+      size_t end = first + 1;
+      bool mayDiffer = run[first].length > 8;
+      while (end < numRun && run[end].prefix == run[first].prefix) {
+         if (run[end].length != run[first].length || run[end].length > 8) {
+            mayDiffer = true;
+         }
+         end++;
+      }
+      if (mayDiffer && end - first > 1) {
+         stable_sort(run.begin() + first, run.begin() + end,
+                     [](const Record& one, const Record& other) {
+            return compareKeywords(one, other) < 0;
+         });
+      }
+      first = end;
+   }
+}
+
+//--------------------------------------------------------------------------
+// static void runParallel(size_t numTasks, int numThreads,
+//                         const function<void(size_t)>& task);
+// Runs task for each number below numTasks, on up to numThreads threads
+// that each take the next task left until none are
+// Preconditions: Tasks can run at the same time
+// Postconditions: Every task has run
+// Return value: None
+// Functions called: task
+void KeywordSorter::runParallel(size_t numTasks, int numThreads,
+                                const function<void(size_t)>& task) {
+   size_t numWorkers = size_t(numThreads);
+   if (numWorkers > numTasks) {
+      numWorkers = numTasks;
+   }
+   if (numWorkers <= 1) {
+      for (size_t i = 0; i < numTasks; i++) {
+         task(i);
+      }
+      return;
+   }
+   atomic<size_t> nextTask(0);
+   vector<thread> workers;
+   for (size_t i = 0; i < numWorkers; i++) {
+      workers.push_back(thread([&task, &nextTask, numTasks]() {
+         size_t taken;
+         while ((taken = nextTask++) < numTasks) {
+            task(taken);
+         }
+      }));
+   }
+   for (size_t i = 0; i < workers.size(); i++) {
+      workers[i].join();
+   }
+}
+
+//--------------------------------------------------------------------------
+// static void mergePiece(const vector<Record>& first,
+//                        const vector<Record>& second, size_t piece,
+//                        size_t numPieces, vector<Record>& merged);
+// Merges one of numPieces pieces of two sorted runs into its place in
+// merged. Piece p takes the Records of first from p / numPieces of the
+// way along and the Records of second that come before the same
+// Records of first, so the pieces fill merged without overlapping.
+// Preconditions: first and second sorted, merged has room for both
+// Postconditions: The piece's Records are in order in merged
+// Return value: None
+// Functions called: lower_bound, merge, lessRecord
+void KeywordSorter::mergePiece(const vector<Record>& first,
+                               const vector<Record>& second, size_t piece,
+                               size_t numPieces, vector<Record>& merged) {
+   size_t firstFrom = first.size() * piece / numPieces;
+   size_t firstTo = first.size() * (piece + 1) / numPieces;
+   // no two Records are equal, as no two have the same offset, so each
+   // Record of second belongs to exactly one piece
+   size_t secondFrom = 0;
+   if (piece > 0) {
+      secondFrom = size_t(lower_bound(second.begin(), second.end(),
+                                      first[firstFrom], lessRecord) -
+                          second.begin());
+   }
+   size_t secondTo = second.size();
+   if (piece + 1 < numPieces) {
+      secondTo = size_t(lower_bound(second.begin(), second.end(),
+                                    first[firstTo], lessRecord) -
+                        second.begin());
+   }
+   merge(first.begin() + firstFrom, first.begin() + firstTo,
+         second.begin() + secondFrom, second.begin() + secondTo,
+         merged.begin() + firstFrom + secondFrom, lessRecord);
+}
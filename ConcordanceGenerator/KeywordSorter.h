@@ -0,0 +1,245 @@
+// KeywordSorter.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A KeywordSorter builds a concordance by sorting rather than by searching
+// a tree for every word. ReadIn reads keywords into it just as into a BST,
+// from one thread or several whose KeywordSorters are merged in order, but
+// each keyword is only written down as a Record of the keyword and the
+// offset of its occurrence, at the end of a flat run of Records. Sorting
+// then orders each run by keyword and offset, every run on a thread of its
+// own with a radix sort of the Records' prefixes, and merges the sorted
+// runs a pair at a time, splitting each merge between threads at matching
+// Records of the pair, until one run is left.
+// A BST is built from the sorted Records in one pass, each keyword's
+// Records together and in the order the keyword occurred, which gives the
+// same concordance as adding every keyword to the BST as it was read. Each
+// Record holds the first eight characters of its keyword as a number, so
+// most Records are ordered by comparing one number, and the characters of
+// the keywords are copied into the KeywordSorter's Arena.
+//
+// Inputs:
+// -- Keywords, as read by ReadIn
+// -- The number of threads to sort with
+//
+// Outputs:
+// -- The Records of every keyword, sorted by keyword and offset
+//
+// Assumptions:
+// -- Keywords are read in order of offset within each KeywordSorter, and
+//    KeywordSorters are merged in order of offset
+//
+// Major algorithms & key variables:
+// Algorithms: Parallel merge sort: LSD radix sorting runs on separate
+// threads, then merging pairs of runs split at matching Records
+// Key Variables: vector<vector<Record>> runs; Arena arena
+
+#pragma once
+
+#include "Arena.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class Corpus;
+class RunStats;
+
+class KeywordSorter {
+
+public:
+   // one occurrence of a keyword; prefix is the first eight characters of
+   // the keyword, the first in the highest byte and padded with zeros
+   struct Record {
+      uint64_t prefix;
+      const char* keyword;
+      size_t length;
+      size_t offset;
+   };
+
+private:
+   // the Records added, a run for each KeywordSorter merged in; a single
+   // run in order once sorted
+   vector<vector<Record>> runs;
+   // the characters of every keyword
+   Arena arena;
+   size_t numRecords;
+   // kept for addStats
+   size_t numRunsSorted;
+   size_t numMerges;
+
+   //--------------------------------------------------------------------------
+   // static uint64_t prefixOf(const char* keyword, size_t length);
+   // Preconditions: keyword has length characters
+   // Postconditions: None
+   // Return value: The first eight characters of keyword as a number, the
+   //               first in the highest byte and padded with zeros, which
+   //               orders keywords as their first eight characters do
+   // Functions called: None
+   static uint64_t prefixOf(const char* keyword, size_t length);
+
+   //--------------------------------------------------------------------------
+   // static bool lessRecord(const Record& first, const Record& second);
+   // Orders Records by keyword, in the order of the BST, and then by offset
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: True if first comes before second, false otherwise
+   // Functions called: compareKeywords
+   static bool lessRecord(const Record& first, const Record& second);
+
+   //--------------------------------------------------------------------------
+   // static int compareKeywords(const Record& first, const Record& second);
+   // Compares the keywords of two Records in the same order as
+   // string::compare
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: Negative if first's keyword comes first, 0 if equal,
+   //               positive if after
+   // Functions called: None
+   static int compareKeywords(const Record& first, const Record& second);
+
+   //--------------------------------------------------------------------------
+   // static void sortRun(vector<Record>& run);
+   // Sorts a run whose Records are in order of offset by keyword, keeping
+   // each keyword's Records in order of offset. The run is radix sorted a
+   // byte of the prefix at a time from the lowest, skipping any byte every
+   // Record shares, and each stretch of Records with the same prefix whose
+   // keywords may still differ, as they are longer than eight characters or
+   // differ in length, is then sorted by keyword with a stable sort.
+   // Preconditions: run is in order of offset
+   // Postconditions: run sorted by keyword and then offset
+   // Return value: None
+   // Functions called: stable_sort, compareKeywords
+   static void sortRun(vector<Record>& run);
+
+   //--------------------------------------------------------------------------
+   // static void runParallel(size_t numTasks, int numThreads,
+   //                         const function<void(size_t)>& task);
+   // Runs task for each number below numTasks, on up to numThreads threads
+   // that each take the next task left until none are
+   // Preconditions: Tasks can run at the same time
+   // Postconditions: Every task has run
+   // Return value: None
+   // Functions called: task
+   static void runParallel(size_t numTasks, int numThreads,
+                           const function<void(size_t)>& task);
+
+   //--------------------------------------------------------------------------
+   // static void mergePiece(const vector<Record>& first,
+   //                        const vector<Record>& second, size_t piece,
+   //                        size_t numPieces, vector<Record>& merged);
+   // Merges one of numPieces pieces of two sorted runs into its place in
+   // merged. Piece p takes the Records of first from p / numPieces of the
+   // way along and the Records of second that come before the same
+   // Records of first, so the pieces fill merged without overlapping.
+   // Preconditions: first and second sorted, merged has room for both
+   // Postconditions: The piece's Records are in order in merged
+   // Return value: None
+   // Functions called: lower_bound, merge, lessRecord
+   static void mergePiece(const vector<Record>& first,
+                          const vector<Record>& second, size_t piece,
+                          size_t numPieces, vector<Record>& merged);
+
+   // a KeywordSorter owns its Arena and is never copied
+   KeywordSorter(const KeywordSorter&);
+   KeywordSorter& operator=(const KeywordSorter&);
+
+public:
+
+   //--------------------------------------------------------------------------
+   // KeywordSorter();
+   // Constructor for KeywordSorter
+   // Preconditions: None
+   // Postconditions: KeywordSorter exists with one empty run
+   // Return value: None
+   // Functions called: None
+   KeywordSorter();
+
+   //--------------------------------------------------------------------------
+   // void copySettings(const KeywordSorter& from);
+   // Does nothing, as a KeywordSorter has no settings, but lets ReadIn read
+   // into KeywordSorters as into BSTs
+   // Preconditions: None
+   // Postconditions: KeywordSorter unchanged
+   // Return value: None
+   // Functions called: None
+   void copySettings(const KeywordSorter& from);
+
+   //--------------------------------------------------------------------------
+   // void setCorpus(const Corpus* theCorpus);
+   // Does nothing, as the concordance is displayed from the BST built from
+   // the KeywordSorter, but lets ReadIn read into it as into a BST
+   // Preconditions: None
+   // Postconditions: KeywordSorter unchanged
+   // Return value: None
+   // Functions called: None
+   void setCorpus(const Corpus* theCorpus);
+
+   //--------------------------------------------------------------------------
+   // void addKeyword(const string& toAdd, size_t offset);
+   // Adds a Record of toAdd at offset to the end of the last run, with a
+   // copy of the keyword in the Arena
+   // Preconditions: offset is after every offset already added
+   // Postconditions: Record added, unsorted
+   // Return value: None -- will quit if out of memory
+   // Functions called: allocateBytes, prefixOf
+   void addKeyword(const string& toAdd, size_t offset);
+
+   //--------------------------------------------------------------------------
+   // void mergeTree(KeywordSorter& other);
+   // Moves the runs of other after the runs of this KeywordSorter, without
+   // sorting them, along with the Arena holding their keywords
+   // Preconditions: other's offsets are after this KeywordSorter's
+   // Postconditions: other is empty, this KeywordSorter holds both Records
+   // Return value: None
+   // Functions called: adopt
+   void mergeTree(KeywordSorter& other);
+
+   //--------------------------------------------------------------------------
+   // void sort(int numThreads);
+   // Sorts every run on its own thread, then merges pairs of runs, each
+   // merge split between the threads it has to itself, until one sorted
+   // run holds every Record
+   // Preconditions: None
+   // Postconditions: Records sorted by keyword and then offset
+   // Return value: None
+   // Functions called: runParallel, sortRun, mergePiece
+   void sort(int numThreads);
+
+   //--------------------------------------------------------------------------
+   // size_t size() const;
+   // Preconditions: None
+   // Postconditions: KeywordSorter unchanged
+   // Return value: The number of Records
+   // Functions called: None
+   size_t size() const;
+
+   //--------------------------------------------------------------------------
+   // const Record* records() const;
+   // Preconditions: sort called since the last Record was added
+   // Postconditions: KeywordSorter unchanged
+   // Return value: The size() sorted Records
+   // Functions called: None
+   const Record* records() const;
+
+   //--------------------------------------------------------------------------
+   // static bool sameKeyword(const Record& first, const Record& second);
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: True if both Records are of the same keyword, false
+   //               otherwise
+   // Functions called: None
+   static bool sameKeyword(const Record& first, const Record& second);
+
+   //--------------------------------------------------------------------------
+   // void addStats(RunStats& stats) const;
+   // Adds the number of Records sorted, of runs they were sorted in and of
+   // merges, and what the Arena allocated for keywords to stats
+   // Preconditions: None
+   // Postconditions: KeywordSorter unchanged
+   // Return value: None
+   // Functions called: addCount, getStats
+   void addStats(RunStats& stats) const;
+};
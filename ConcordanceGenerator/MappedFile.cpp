@@ -0,0 +1,198 @@
+// MappedFile.cpp
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// MappedFile maps a whole file into memory read-only so that words can be
+// taken as slices of the file's bytes rather than copied out of a stream.
+// On systems without mmap the file is read into a single buffer instead.
+// The mapping is released when the MappedFile is closed or destructed.
+// 
+// Inputs: 
+// -- The name of a file to map
+//
+// Outputs:
+// -- A pointer to the first byte of the file and the file's length
+//
+// Assumptions:
+// -- The file is not modified while it is mapped
+// 
+// Major algorithms & key variables:
+// Algorithms: None
+// Key Variables: const char* data; size_t size; bool mapped
+
+#include "MappedFile.h"
+#include <fstream>
+#include <iostream>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//--------------------------------------------------------------------------
+// MappedFile();
+// Constructor for MappedFile
+// Preconditions: None
+// Postconditions: MappedFile exists with no file open
+// Return value: None
+// Functions called: None
+MappedFile::MappedFile() {
+   data = nullptr;
+   size = 0;
+   opened = false;
+   mapped = false;
+}
+
+//--------------------------------------------------------------------------
+// MappedFile(const string& fileName);
+// Constructor for MappedFile that opens fileName
+// Preconditions: None
+// Postconditions: fileName is mapped if it could be opened
+// Return value: None
+// Functions called: open
+MappedFile::MappedFile(const string& fileName) {
+   data = nullptr;
+   size = 0;
+   opened = false;
+   mapped = false;
+   open(fileName);
+}
+
+//--------------------------------------------------------------------------
+// ~MappedFile();
+// Destructor for MappedFile
+// Preconditions: MappedFile exists
+// Postconditions: Mapping released
+// Return value: None
+// Functions called: close
+MappedFile::~MappedFile() {
+   close();
+}
+
+//--------------------------------------------------------------------------
+// bool open(const string& fileName);
+// Maps the whole of fileName into memory, closing any file already open.
+// Preconditions: None
+// Postconditions: The file's bytes are available from begin() to end()
+// Return value: True if the file was opened, false otherwise
+// Functions called: close
+bool MappedFile::open(const string& fileName) {
+   close();
+#ifndef _WIN32
+   int fd = ::open(fileName.c_str(), O_RDONLY);
+   if (fd < 0) {
+      return false;
+   }
+   struct stat info;
+   if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+      size = size_t(info.st_size);
+      // an empty file cannot be mapped, but is still a valid open file
+      if (size == 0) {
+         ::close(fd);
+         opened = true;
+         return true;
+      }
+      void* region = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (region != MAP_FAILED) {
+         // words are read front to back, let the kernel read ahead
+         madvise(region, size, MADV_SEQUENTIAL);
+         ::close(fd);
+         data = static_cast<const char*>(region);
+         opened = true;
+         mapped = true;
+         return true;
+      }
+   }
+   ::close(fd);
+   size = 0;
+#endif
+   // no mapping possible (or not a regular file), read it into a buffer
+   ifstream inFile(fileName.c_str(), ios::in | ios::binary);
+   if (!inFile.is_open()) {
+      return false;
+   }
+   string contents;
+   char block[1 << 16];
+   while (inFile.read(block, sizeof(block)) || inFile.gcount() > 0) {
+      contents.append(block, size_t(inFile.gcount()));
+   }
+   try {
+      char* buffer = new char[contents.length() + 1];
+      contents.copy(buffer, contents.length());
+      data = buffer;
+      size = contents.length();
+   }
+   catch (...) {
+      cout << "You are out of memory.\n";
+      exit(0);
+   }
+   opened = true;
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// void close();
+// Releases the mapping or buffer holding the file
+// Preconditions: None
+// Postconditions: No file is open
+// Return value: None
+// Functions called: None
+void MappedFile::close() {
+   if (data != nullptr) {
+#ifndef _WIN32
+      if (mapped) {
+         munmap(const_cast<char*>(data), size);
+      }
+      else {
+         delete[] data;
+      }
+#else
+      delete[] data;
+#endif
+   }
+   data = nullptr;
+   size = 0;
+   opened = false;
+   mapped = false;
+}
+
+//--------------------------------------------------------------------------
+// bool isOpen() const;
+// Preconditions: MappedFile exists
+// Postconditions: MappedFile unchanged
+// Return value: True if a file is open, false otherwise
+// Functions called: None
+bool MappedFile::isOpen() const {
+   return opened;
+}
+
+//--------------------------------------------------------------------------
+// const char* begin() const;
+// Preconditions: MappedFile exists
+// Postconditions: MappedFile unchanged
+// Return value: Pointer to the first byte of the file
+// Functions called: None
+const char* MappedFile::begin() const {
+   return data;
+}
+
+//--------------------------------------------------------------------------
+// const char* end() const;
+// Preconditions: MappedFile exists
+// Postconditions: MappedFile unchanged
+// Return value: Pointer one past the last byte of the file
+// Functions called: None
+const char* MappedFile::end() const {
+   return data + size;
+}
+
+//--------------------------------------------------------------------------
+// size_t length() const;
+// Preconditions: MappedFile exists
+// Postconditions: MappedFile unchanged
+// Return value: Number of bytes in the file
+// Functions called: None
+size_t MappedFile::length() const {
+   return size;
+}
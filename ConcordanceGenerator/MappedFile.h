@@ -0,0 +1,119 @@
+// MappedFile.h
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// MappedFile maps a whole file into memory read-only so that words can be
+// taken as slices of the file's bytes rather than copied out of a stream.
+// On systems without mmap the file is read into a single buffer instead.
+// The mapping is released when the MappedFile is closed or destructed.
+// 
+// Inputs: 
+// -- The name of a file to map
+//
+// Outputs:
+// -- A pointer to the first byte of the file and the file's length
+//
+// Assumptions:
+// -- The file is not modified while it is mapped
+// 
+// Major algorithms & key variables:
+// Algorithms: None
+// Key Variables: const char* data; size_t size; bool mapped
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+using namespace std;
+
+class MappedFile {
+
+private:
+   const char* data;
+   size_t size;
+   bool opened;
+   bool mapped;
+
+   // a MappedFile owns its mapping and is never copied
+   MappedFile(const MappedFile&);
+   MappedFile& operator=(const MappedFile&);
+
+public:
+
+   //--------------------------------------------------------------------------
+   // MappedFile();
+   // Constructor for MappedFile
+   // Preconditions: None
+   // Postconditions: MappedFile exists with no file open
+   // Return value: None
+   // Functions called: None
+   MappedFile();
+
+   //--------------------------------------------------------------------------
+   // MappedFile(const string& fileName);
+   // Constructor for MappedFile that opens fileName
+   // Preconditions: None
+   // Postconditions: fileName is mapped if it could be opened
+   // Return value: None
+   // Functions called: open
+   MappedFile(const string& fileName);
+
+   //--------------------------------------------------------------------------
+   // ~MappedFile();
+   // Destructor for MappedFile
+   // Preconditions: MappedFile exists
+   // Postconditions: Mapping released
+   // Return value: None
+   // Functions called: close
+   ~MappedFile();
+
+   //--------------------------------------------------------------------------
+   // bool open(const string& fileName);
+   // Maps the whole of fileName into memory, closing any file already open.
+   // Preconditions: None
+   // Postconditions: The file's bytes are available from begin() to end()
+   // Return value: True if the file was opened, false otherwise
+   // Functions called: close
+   bool open(const string& fileName);
+
+   //--------------------------------------------------------------------------
+   // void close();
+   // Releases the mapping or buffer holding the file
+   // Preconditions: None
+   // Postconditions: No file is open
+   // Return value: None
+   // Functions called: None
+   void close();
+
+   //--------------------------------------------------------------------------
+   // bool isOpen() const;
+   // Preconditions: MappedFile exists
+   // Postconditions: MappedFile unchanged
+   // Return value: True if a file is open, false otherwise
+   // Functions called: None
+   bool isOpen() const;
+
+   //--------------------------------------------------------------------------
+   // const char* begin() const;
+   // Preconditions: MappedFile exists
+   // Postconditions: MappedFile unchanged
+   // Return value: Pointer to the first byte of the file
+   // Functions called: None
+   const char* begin() const;
+
+   //--------------------------------------------------------------------------
+   // const char* end() const;
+   // Preconditions: MappedFile exists
+   // Postconditions: MappedFile unchanged
+   // Return value: Pointer one past the last byte of the file
+   // Functions called: None
+   const char* end() const;
+
+   //--------------------------------------------------------------------------
+   // size_t length() const;
+   // Preconditions: MappedFile exists
+   // Postconditions: MappedFile unchanged
+   // Return value: Number of bytes in the file
+   // Functions called: None
+   size_t length() const;
+};
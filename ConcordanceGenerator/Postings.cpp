@@ -0,0 +1,134 @@
+// Postings.cpp
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// Postings hold the offset of every occurrence of one keyword, in the order
+// they were added, as compactly as they can be read back in that order.
+// Each offset is stored as its difference from the offset before it, and
+// each difference as a varint: seven bits to a byte, low bits first, with
+// the top bit set on every byte but the last. A keyword that occurs often
+// has small differences between its occurrences, so most of them take one
+// or two bytes rather than the eight of an offset. The bytes are kept in
+// Chunks allocated from the tree's Arena, each twice the size of the one
+// before up to a limit, so a keyword's postings are a few runs of bytes
+// however many occurrences it has, and adding one is writing a few bytes at
+// the end of the last Chunk. Postings are appended to others by linking
+// their Chunks on, rewriting only the first difference, which is then from
+// the last offset of the Postings appended to rather than from 0; it is
+// rewritten in the same number of bytes, padded with zero bits, so nothing
+// is moved. An Iterator decodes the offsets in order.
+//
+// Inputs:
+// -- Offsets of the occurrences of a keyword, in increasing order
+// -- The Arena to allocate Chunks from
+//
+// Outputs:
+// -- The offsets, in the order they were added
+// -- The number of offsets and of bytes they take
+//
+// Assumptions:
+// -- Offsets are added in increasing order, and Postings are appended only
+//    to Postings whose offsets are all smaller
+//
+// Major algorithms & key variables:
+// Algorithms: Delta encoding, varint (LEB128) encoding
+// Key Variables: Chunk* head, tail; size_t count; size_t last
+
+#include "Postings.h"
+
+//--------------------------------------------------------------------------
+// Postings();
+// Constructor for Postings
+// Preconditions: None
+// Postconditions: Postings exist with no offsets
+// Return value: None
+// Functions called: None
+Postings::Postings() {
+   head = nullptr;
+   tail = nullptr;
+   count = 0;
+   last = 0;
+}
+
+//--------------------------------------------------------------------------
+// void newChunk(Arena& arena);
+// Adds an empty Chunk after the last, twice the size of it up to the
+// largest Chunk size
+// Preconditions: Memory available
+// Postconditions: tail is the new Chunk
+// Return value: None -- will quit if out of memory (based on allocate())
+// Functions called: allocate
+void Postings::newChunk(Arena& arena) {
+   uint32_t size = FIRST_CHUNK_SIZE;
+   if (tail != nullptr) {
+      size = tail->size < MAX_CHUNK_SIZE / 2 ? tail->size * 2
+                                              : MAX_CHUNK_SIZE;
+   }
+   Chunk* chunk = static_cast<Chunk*>(arena.allocate(sizeof(Chunk) + size));
+   chunk->next = nullptr;
+   chunk->used = 0;
+   chunk->size = size;
+   if (tail == nullptr) {
+      head = chunk;
+   }
+   else {
+      tail->next = chunk;
+   }
+   tail = chunk;
+}
+
+//--------------------------------------------------------------------------
+// void append(Postings& other);
+// Moves every offset of other onto the end of these Postings by linking
+// on its Chunks
+// Preconditions: Every offset of other is larger than these Postings'
+// Postconditions: other is empty, its offsets follow these Postings'
+// Return value: None
+// Functions called: bytes
+void Postings::append(Postings& other) {
+   if (&other == this || other.isEmpty()) {
+      return;
+   }
+   if (isEmpty()) {
+      head = other.head;
+   }
+   else {
+      // other's first difference is its first offset; make it the
+      // difference from this last offset, in as many bytes as before
+      unsigned char* first = bytes(other.head);
+      size_t length = 1;
+      size_t offset = first[0] & 0x7f;
+      while (first[length - 1] & 0x80) {
+         offset |= size_t(first[length] & 0x7f) << (7 * length);
+         length++;
+      }
+      size_t difference = offset - last;
+      for (size_t i = 0; i + 1 < length; i++) {
+         first[i] = (unsigned char)(difference | 0x80);
+         difference >>= 7;
+      }
+      first[length - 1] = (unsigned char)difference;
+      tail->next = other.head;
+   }
+   tail = other.tail;
+   count += other.count;
+   last = other.last;
+   other.head = nullptr;
+   other.tail = nullptr;
+   other.count = 0;
+   other.last = 0;
+}
+
+//--------------------------------------------------------------------------
+// size_t numBytes() const;
+// Preconditions: None
+// Postconditions: Postings unchanged
+// Return value: The number of bytes the offsets are encoded in
+// Functions called: None
+size_t Postings::numBytes() const {
+   size_t total = 0;
+   for (const Chunk* chunk = head; chunk != nullptr; chunk = chunk->next) {
+      total += chunk->used;
+   }
+   return total;
+}
@@ -0,0 +1,243 @@
+// Postings.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// Postings hold the offset of every occurrence of one keyword, in the order
+// they were added, as compactly as they can be read back in that order.
+// Each offset is stored as its difference from the offset before it, and
+// each difference as a varint: seven bits to a byte, low bits first, with
+// the top bit set on every byte but the last. A keyword that occurs often
+// has small differences between its occurrences, so most of them take one
+// or two bytes rather than the eight of an offset. The bytes are kept in
+// Chunks allocated from the tree's Arena, each twice the size of the one
+// before up to a limit, so a keyword's postings are a few runs of bytes
+// however many occurrences it has, and adding one is writing a few bytes at
+// the end of the last Chunk. Postings are appended to others by linking
+// their Chunks on, rewriting only the first difference, which is then from
+// the last offset of the Postings appended to rather than from 0; it is
+// rewritten in the same number of bytes, padded with zero bits, so nothing
+// is moved. An Iterator decodes the offsets in order.
+//
+// Inputs:
+// -- Offsets of the occurrences of a keyword, in increasing order
+// -- The Arena to allocate Chunks from
+//
+// Outputs:
+// -- The offsets, in the order they were added
+// -- The number of offsets and of bytes they take
+//
+// Assumptions:
+// -- Offsets are added in increasing order, and Postings are appended only
+//    to Postings whose offsets are all smaller
+//
+// Major algorithms & key variables:
+// Algorithms: Delta encoding, varint (LEB128) encoding
+// Key Variables: Chunk* head, tail; size_t count; size_t last
+
+#pragma once
+
+#include "Arena.h"
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class Postings {
+
+private:
+   // followed in memory by size bytes, of which the first used are encoded
+   struct Chunk {
+      Chunk* next;
+      uint32_t used;
+      uint32_t size;
+   };
+
+   static const uint32_t FIRST_CHUNK_SIZE = 16;
+   static const uint32_t MAX_CHUNK_SIZE = 4096;
+   // the most bytes one difference is encoded in
+   static const size_t MAX_VARINT = (sizeof(size_t) * 8 + 6) / 7;
+
+   Chunk* head;
+   Chunk* tail;
+   size_t count;
+   size_t last;
+
+   //--------------------------------------------------------------------------
+   // static unsigned char* bytes(Chunk* chunk);
+   // static const unsigned char* bytes(const Chunk* chunk);
+   // Preconditions: chunk exists
+   // Postconditions: None
+   // Return value: The first of chunk's bytes
+   // Functions called: None
+   static unsigned char* bytes(Chunk* chunk) {
+      return reinterpret_cast<unsigned char*>(chunk + 1);
+   }
+   static const unsigned char* bytes(const Chunk* chunk) {
+      return reinterpret_cast<const unsigned char*>(chunk + 1);
+   }
+
+   //--------------------------------------------------------------------------
+   // void newChunk(Arena& arena);
+   // Adds an empty Chunk after the last, twice the size of it up to the
+   // largest Chunk size
+   // Preconditions: Memory available
+   // Postconditions: tail is the new Chunk
+   // Return value: None -- will quit if out of memory (based on allocate())
+   // Functions called: allocate
+   void newChunk(Arena& arena);
+
+public:
+
+   // An Iterator decodes the offsets of Postings in the order they were
+   // added, reading each byte once.
+   class Iterator {
+
+   private:
+      const Chunk* chunk;
+      const unsigned char* at;
+      const unsigned char* end;
+      size_t current;
+      bool valid;
+
+   public:
+
+      //-----------------------------------------------------------------------
+      // Iterator(const Postings& postings);
+      // Constructor for an Iterator at the first offset of postings
+      // Preconditions: postings is not changed while iterating
+      // Postconditions: Iterator at the first offset, or past the end if
+      //                 there is none
+      // Return value: None
+      // Functions called: next
+      Iterator(const Postings& postings) {
+         chunk = postings.head;
+         at = nullptr;
+         end = nullptr;
+         current = 0;
+         valid = true;
+         next();
+      }
+
+      //-----------------------------------------------------------------------
+      // bool isValid() const;
+      // Preconditions: Iterator exists
+      // Postconditions: Iterator unchanged
+      // Return value: True if at an offset, false if past the last one
+      // Functions called: None
+      bool isValid() const {
+         return valid;
+      }
+
+      //-----------------------------------------------------------------------
+      // size_t offset() const;
+      // Preconditions: isValid()
+      // Postconditions: Iterator unchanged
+      // Return value: The current offset
+      // Functions called: None
+      size_t offset() const {
+         return current;
+      }
+
+      //-----------------------------------------------------------------------
+      // void next();
+      // Decodes the following offset, moving on to the next Chunk when this
+      // one is used up
+      // Preconditions: isValid()
+      // Postconditions: Iterator at the next offset, or past the end
+      // Return value: None
+      // Functions called: bytes
+      void next() {
+         while (at == end) {
+            if (chunk == nullptr) {
+               valid = false;
+               return;
+            }
+            at = bytes(chunk);
+            end = at + chunk->used;
+            chunk = chunk->next;
+         }
+         size_t difference = *at & 0x7f;
+         int shift = 7;
+         while (*at++ & 0x80) {
+            difference |= size_t(*at & 0x7f) << shift;
+            shift += 7;
+         }
+         current += difference;
+      }
+   };
+
+   //--------------------------------------------------------------------------
+   // Postings();
+   // Constructor for Postings
+   // Preconditions: None
+   // Postconditions: Postings exist with no offsets
+   // Return value: None
+   // Functions called: None
+   Postings();
+
+   //--------------------------------------------------------------------------
+   // void add(size_t offset, Arena& arena);
+   // Adds offset after the others, starting a Chunk from arena if the last
+   // one does not have room for it
+   // Preconditions: offset is larger than every offset already added
+   // Postconditions: offset is the last offset
+   // Return value: None -- will quit if out of memory (based on allocate())
+   // Functions called: newChunk, bytes
+   void add(size_t offset, Arena& arena) {
+      unsigned char encoded[MAX_VARINT];
+      size_t difference = offset - last;
+      size_t length = 0;
+      while (difference >= 0x80) {
+         encoded[length++] = (unsigned char)(difference | 0x80);
+         difference >>= 7;
+      }
+      encoded[length++] = (unsigned char)difference;
+      if (tail == nullptr || tail->size - tail->used < length) {
+         newChunk(arena);
+      }
+      unsigned char* to = bytes(tail) + tail->used;
+      for (size_t i = 0; i < length; i++) {
+         to[i] = encoded[i];
+      }
+      tail->used += uint32_t(length);
+      last = offset;
+      count++;
+   }
+
+   //--------------------------------------------------------------------------
+   // void append(Postings& other);
+   // Moves every offset of other onto the end of these Postings by linking
+   // on its Chunks
+   // Preconditions: Every offset of other is larger than these Postings'
+   // Postconditions: other is empty, its offsets follow these Postings'
+   // Return value: None
+   // Functions called: bytes
+   void append(Postings& other);
+
+   //--------------------------------------------------------------------------
+   // bool isEmpty() const;
+   // Preconditions: None
+   // Postconditions: Postings unchanged
+   // Return value: True if there are no offsets, false otherwise
+   // Functions called: None
+   bool isEmpty() const {
+      return count == 0;
+   }
+
+   //--------------------------------------------------------------------------
+   // size_t size() const;
+   // Preconditions: None
+   // Postconditions: Postings unchanged
+   // Return value: The number of offsets
+   // Functions called: None
+   size_t size() const {
+      return count;
+   }
+
+   //--------------------------------------------------------------------------
+   // size_t numBytes() const;
+   // Preconditions: None
+   // Postconditions: Postings unchanged
+   // Return value: The number of bytes the offsets are encoded in
+   // Functions called: None
+   size_t numBytes() const;
+};
@@ -0,0 +1,541 @@
+// RadixTree.cpp
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A RadixTree holds the same concordance as a BST, but as a compressed
+// trie of the keywords. Each RadixNode is labelled with a run of characters
+// and the keyword of a RadixNode is the labels on the path down to it, so
+// keywords sharing a prefix share the RadixNodes for it and finding a
+// keyword compares each of its characters once, however many keywords there
+// are. The children of a RadixNode begin with different characters and are
+// kept in order of them, so visiting a RadixNode before its children visits
+// the keywords in sorted order, and every keyword with a given prefix is
+// under one RadixNode. Labels are not copied: each keyword is copied into
+// the Arena once and every label points into the copy of the keyword that
+// made it. The RadixTree can be built, merged, displayed and queried as a
+// BST is.
+//
+// Inputs:
+// -- The Corpus the keywords were read from
+// -- Keywords and the offset of each occurrence in the Corpus
+//
+// Outputs:
+// -- Displaying the concordance of every keyword, or of the keywords
+//    matching a KeywordQuery
+//
+// Assumptions:
+// -- Keywords are not empty
+//
+// Major algorithms & key variables:
+// Algorithms: Compressed trie (radix tree), preorder traversal with parent
+// links
+// Key Variables: RadixNode* root; Arena arena; const char* label;
+// size_t depth
+
+#include "RadixTree.h"
+#include "ConcordWriter.h"
+#include "RunStats.h"
+#include "KeywordQuery.h"
+#include <cstring>
+
+//--------------------------------------------------------------------------
+// RadixTree();
+// RadixTree constructor
+// Preconditions: Memory available
+// Postconditions: Root is now nullptr
+// Return value: None
+// Functions called: None
+RadixTree::RadixTree() {
+   root = nullptr;
+   corpus = nullptr;
+   showSources = false;
+   numNodes = 0;
+   numComparisons = 0;
+}
+
+//--------------------------------------------------------------------------
+// ~RadixTree();
+// Destructs RadixTree
+// Preconditions: RadixTree exists
+// Postconditions: Every RadixNode released with the Arena
+// Return value: None
+// Functions called: release()
+RadixTree::~RadixTree() {
+   root = nullptr;
+   arena.release();
+}
+
+//--------------------------------------------------------------------------
+// void setCorpus(const Corpus* theCorpus);
+// Sets the Corpus that keyword offsets refer into
+// Preconditions: RadixTree exists, theCorpus stays open while displayed
+// Postconditions: Concordances are read from theCorpus
+// Return value: None
+// Functions called: None
+void RadixTree::setCorpus(const Corpus* theCorpus) {
+   corpus = theCorpus;
+}
+
+//--------------------------------------------------------------------------
+// void setShowSources(bool show);
+// Sets whether each concordance is followed by the name of its document
+// and the position of the keyword in that document
+// Preconditions: RadixTree exists
+// Postconditions: Concordances displayed from now on show their source
+//                 if show
+// Return value: None
+// Functions called: None
+void RadixTree::setShowSources(bool show) {
+   showSources = show;
+}
+
+//--------------------------------------------------------------------------
+// void setLayout(const ConcordWriter::Layout& newLayout);
+// Sets how many words are shown either side of each keyword and how wide
+// the concordances and keyword are
+// Preconditions: Every number of newLayout is at least 1
+// Postconditions: Concordances displayed from now on follow newLayout
+// Return value: None
+// Functions called: None
+void RadixTree::setLayout(const ConcordWriter::Layout& newLayout) {
+   layout = newLayout;
+}
+
+//--------------------------------------------------------------------------
+// void displayTree();
+// Display every keyword with all its concordances, in sorted order
+// Preconditions: RadixTree exists
+// Postconditions: RadixTree unchanged
+// Return value: None
+// Functions called: next(), displayNode()
+void RadixTree::displayTree() {
+   ConcordWriter writer(cout);
+   writer.setCorpus(corpus);
+   writer.setShowSources(showSources);
+   writer.setLayout(layout);
+   for (Iterator at(*this); at.isValid(); at.next()) {
+      displayNode(at.node, writer);
+   }
+}
+
+//--------------------------------------------------------------------------
+// size_t displayQuery(const KeywordQuery& query, string& next);
+// Display the concordances of the keywords matching query, visiting only
+// those keywords, up to the query's limit
+// Preconditions: RadixTree exists
+// Postconditions: RadixTree unchanged, next is the first matching keyword
+//                 left undisplayed by the limit, or empty if there is none
+// Return value: Number of keywords displayed
+// Functions called: seek, isPastEnd, next, displayNode
+size_t RadixTree::displayQuery(const KeywordQuery& query, string& next) {
+   ConcordWriter writer(cout);
+   writer.setCorpus(corpus);
+   writer.setShowSources(showSources);
+   writer.setLayout(layout);
+   size_t displayed = 0;
+   next.clear();
+   Iterator at(*this);
+   at.seek(query.start().data(), query.start().length());
+   while (at.isValid() && !query.isPastEnd(at.keyword(), at.keyLength())) {
+      if (displayed == query.getLimit()) {
+         next.assign(at.keyword(), at.keyLength());
+         break;
+      }
+      displayNode(at.node, writer);
+      displayed++;
+      at.next();
+   }
+   return displayed;
+}
+
+//--------------------------------------------------------------------------
+// static void displayNode(const RadixNode* top, ConcordWriter& writer);
+// Display the keyword with all concordances within the Postings
+// Preconditions: top ends a keyword
+// Postconditions: RadixTree unchanged
+// Return value: None
+// Functions called: setKeyword, writeConcord
+void RadixTree::displayNode(const RadixNode* top, ConcordWriter& writer) {
+   writer.setKeyword(top->label + top->labelLength - top->depth, top->depth);
+   for (Postings::Iterator at(top->concord); at.isValid(); at.next()) {
+      writer.writeConcord(at.offset());
+   }
+}
+
+//--------------------------------------------------------------------------
+// bool isEmpty() const;
+// Preconditions: RadixTree exists
+// Postconditions: RadixTree unchanged
+// Return value: True if there are no keywords, false otherwise
+// Functions called: None
+bool RadixTree::isEmpty() const {
+   return firstKeyword(root) == nullptr;
+}
+
+//--------------------------------------------------------------------------
+// void addKeyword(const string& toAdd, size_t offset);
+// Adds the concordance at offset to the RadixNode for the keyword
+// Preconditions: RadixTree exists, toAdd is not empty
+// Postconditions: toAdd is a keyword of the RadixTree
+// Return value: None -- will quit if out of memory
+// Functions called: findOrAddNode()
+void RadixTree::addKeyword(const string& toAdd, size_t offset) {
+   findOrAddNode(toAdd.data(), toAdd.length())->concord.add(offset, arena);
+}
+
+//--------------------------------------------------------------------------
+// void mergeTree(RadixTree& other);
+// Moves every concordance in other into this RadixTree. For keywords in
+// both, other's concordances are placed after this RadixTree's.
+// Preconditions: Both RadixTrees exist and refer to the same Corpus
+// Postconditions: other is empty, this RadixTree holds all concordances
+// Return value: None
+// Functions called: findOrAddNode(), append(), adopt()
+void RadixTree::mergeTree(RadixTree& other) {
+   if (&other == this) {
+      return;
+   }
+   for (Iterator at(other); at.isValid(); at.next()) {
+      findOrAddNode(at.keyword(), at.keyLength())->concord.append(
+         at.node->concord);
+   }
+   numComparisons += other.numComparisons;
+   other.root = nullptr;
+   other.numNodes = 0;
+   other.numComparisons = 0;
+   // the moved Postings Chunks still live in other's Arena
+   arena.adopt(other.arena);
+}
+
+//--------------------------------------------------------------------------
+// void setArenaBlockSize(size_t bytes);
+// Sets the largest block the RadixTree's Arena will grow to
+// Preconditions: RadixTree exists
+// Postconditions: Arena blocks allocated from now on are at most bytes
+// Return value: None
+// Functions called: setMaxBlockSize()
+void RadixTree::setArenaBlockSize(size_t bytes) {
+   arena.setMaxBlockSize(bytes);
+}
+
+//--------------------------------------------------------------------------
+// size_t getArenaBlockSize() const;
+// Preconditions: RadixTree exists
+// Postconditions: RadixTree unchanged
+// Return value: The largest block the RadixTree's Arena will grow to
+// Functions called: getMaxBlockSize()
+size_t RadixTree::getArenaBlockSize() const {
+   return arena.getMaxBlockSize();
+}
+
+//--------------------------------------------------------------------------
+// void copySettings(const RadixTree& from);
+// Gives this RadixTree the Arena block size of from, so that a RadixTree
+// built from part of a text is built as from is
+// Preconditions: RadixTree exists
+// Postconditions: Arena block size the same as from
+// Return value: None
+// Functions called: setArenaBlockSize(), getArenaBlockSize()
+void RadixTree::copySettings(const RadixTree& from) {
+   setArenaBlockSize(from.getArenaBlockSize());
+}
+
+//--------------------------------------------------------------------------
+// Arena::Stats getArenaStats() const;
+// Preconditions: RadixTree exists
+// Postconditions: RadixTree unchanged
+// Return value: Stats of the Arena holding the RadixTree's RadixNodes
+// Functions called: getStats()
+Arena::Stats RadixTree::getArenaStats() const {
+   return arena.getStats();
+}
+
+//--------------------------------------------------------------------------
+// void addStats(RunStats& stats) const;
+// Adds the number of RadixNodes, the height of the RadixTree, the
+// characters compared building it, its occurrences, the bytes their
+// Postings take and what its Arena allocated to stats
+// Preconditions: RadixTree exists
+// Postconditions: RadixTree unchanged
+// Return value: None
+// Functions called: addCount, getStats, height, size, numBytes
+void RadixTree::addStats(RunStats& stats) const {
+   Arena::Stats arenaStats = arena.getStats();
+   size_t numOccurrences = 0;
+   size_t postingBytes = 0;
+   for (Iterator at(*this); at.isValid(); at.next()) {
+      const RadixNode* top = at.node;
+      numOccurrences += top->concord.size();
+      postingBytes += top->concord.numBytes();
+   }
+   stats.addCount("tree nodes", numNodes);
+   stats.addCount("tree height", height());
+   stats.addCount("key comparisons", numComparisons);
+   stats.addCount("occurrences", numOccurrences);
+   stats.addCount("posting bytes", postingBytes);
+   stats.addCount("arena allocations", arenaStats.numAllocations);
+   stats.addCount("arena bytes allocated", arenaStats.bytesAllocated);
+   stats.addCount("arena bytes reserved", arenaStats.bytesReserved);
+   stats.addCount("arena blocks", arenaStats.numBlocks);
+}
+
+//--------------------------------------------------------------------------
+// size_t height() const;
+// Preconditions: None
+// Postconditions: RadixTree unchanged
+// Return value: Number of RadixNodes on the longest path down from the
+//               root, 0 if there is no root
+// Functions called: None
+size_t RadixTree::height() const {
+   // walk in preorder, counting the levels gone down and back up
+   size_t tallest = 0;
+   size_t level = 1;
+   const RadixNode* at = root;
+   while (at != nullptr) {
+      if (level > tallest) {
+         tallest = level;
+      }
+      if (at->child != nullptr) {
+         at = at->child;
+         level++;
+         continue;
+      }
+      while (at != nullptr && at->sibling == nullptr) {
+         at = at->parent;
+         level--;
+      }
+      if (at != nullptr) {
+         at = at->sibling;
+      }
+   }
+   return tallest;
+}
+
+//--------------------------------------------------------------------------
+// RadixNode* newRadixNode(const char* label, size_t labelLength,
+//                         RadixNode* parent);
+// Creates a RadixNode with no concordances in the Arena below parent
+// Preconditions: label stays in memory
+// Postconditions: RadixNode created, not yet linked into the RadixTree
+// Return value: RadixNode* (will quit if out of memory)
+// Functions called: make
+RadixTree::RadixNode* RadixTree::newRadixNode(const char* label, 
+                                              size_t labelLength,
+                                              RadixNode* parent) {
+   RadixNode* newNode = arena.make<RadixNode>();
+   newNode->label = label;
+   newNode->labelLength = labelLength;
+   newNode->depth = labelLength;
+   if (parent != nullptr) {
+      newNode->depth += parent->depth;
+   }
+   newNode->parent = parent;
+   numNodes++;
+   return newNode;
+}
+
+//--------------------------------------------------------------------------
+// RadixNode* findOrAddNode(const char* toAdd, size_t length);
+// Finds the RadixNode for the keyword, adding one with no concordances if
+// there is none. A label that only partly matches is split in two.
+// Preconditions: RadixTree exists, length > 0
+// Postconditions: A RadixNode for toAdd exists
+// Return value: RadixNode* for toAdd (will quit if out of memory)
+// Functions called: newRadixNode(), allocate()
+RadixTree::RadixNode* RadixTree::findOrAddNode(const char* toAdd, 
+                                               size_t length) {
+   // each character of the keyword is compared once on the way down
+   numComparisons += length;
+   if (root == nullptr) {
+      root = newRadixNode(nullptr, 0, nullptr);
+   }
+   RadixNode* current = root;
+   size_t matched = 0;
+   while (matched < length) {
+      // find where a child starting with the next character is, or belongs
+      unsigned char next = (unsigned char)toAdd[matched];
+      RadixNode** link = &current->child;
+      while (*link != nullptr && (unsigned char)(*link)->label[0] < next) {
+         link = &(*link)->sibling;
+      }
+      RadixNode* child = *link;
+      if (child == nullptr || (unsigned char)child->label[0] != next) {
+         // the rest of the keyword becomes the label of a new leaf, inside
+         // the one copy of the keyword
+         char* keyword = static_cast<char*>(arena.allocate(length));
+         memcpy(keyword, toAdd, length);
+         RadixNode* leaf = newRadixNode(keyword + matched, length - matched,
+                                        current);
+         leaf->sibling = child;
+         *link = leaf;
+         return leaf;
+      }
+      size_t common = 1;
+      while (common < child->labelLength && matched + common < length &&
+             child->label[common] == toAdd[matched + common]) {
+         common++;
+      }
+      if (common < child->labelLength) {
+         // split the label, the front part becomes a RadixNode of its own
+         // with the rest of the old RadixNode as its only child
+         RadixNode* front = newRadixNode(child->label, common, current);
+         front->sibling = child->sibling;
+         front->child = child;
+         *link = front;
+         child->parent = front;
+         child->sibling = nullptr;
+         child->label += common;
+         child->labelLength -= common;
+         child = front;
+      }
+      current = child;
+      matched += common;
+   }
+   return current;
+}
+
+//--------------------------------------------------------------------------
+// static RadixNode* skipChildren(const RadixNode* top);
+// Preconditions: top exists
+// Postconditions: None
+// Return value: The first RadixNode after top and everything under it in
+//               preorder, nullptr if there is none
+// Functions called: None
+RadixTree::RadixNode* RadixTree::skipChildren(const RadixNode* top) {
+   while (top != nullptr && top->sibling == nullptr) {
+      top = top->parent;
+   }
+   if (top == nullptr) {
+      return nullptr;
+   }
+   return top->sibling;
+}
+
+//--------------------------------------------------------------------------
+// static RadixNode* firstKeyword(RadixNode* top);
+// Preconditions: None
+// Postconditions: None
+// Return value: top if it ends a keyword, otherwise the next RadixNode in
+//               preorder that does, nullptr if there is none
+// Functions called: skipChildren()
+RadixTree::RadixNode* RadixTree::firstKeyword(RadixNode* top) {
+   while (top != nullptr && top->concord.isEmpty()) {
+      if (top->child != nullptr) {
+         top = top->child;
+      }
+      else {
+         top = skipChildren(top);
+      }
+   }
+   return top;
+}
+
+//--------------------------------------------------------------------------
+// Iterator(const RadixTree& theTree);
+// Constructor for an Iterator at the first keyword of theTree
+// Preconditions: theTree exists and is not changed while iterating
+// Postconditions: Iterator at the least keyword
+// Return value: None
+// Functions called: firstKeyword
+RadixTree::Iterator::Iterator(const RadixTree& theTree) {
+   tree = &theTree;
+   node = firstKeyword(theTree.root);
+}
+
+//--------------------------------------------------------------------------
+// void seek(const char* key, size_t length);
+// Moves to the first keyword that is not less than key, comparing
+// each character of key at most once
+// Preconditions: Iterator exists
+// Postconditions: Iterator at that keyword, or past the end
+// Return value: None
+// Functions called: firstKeyword, skipChildren
+void RadixTree::Iterator::seek(const char* key, size_t length) {
+   RadixNode* current = tree->root;
+   size_t matched = 0;
+   // current's keyword is always the first matched characters of key
+   while (current != nullptr && matched < length) {
+      unsigned char next = (unsigned char)key[matched];
+      RadixNode* child = current->child;
+      while (child != nullptr && (unsigned char)child->label[0] < next) {
+         child = child->sibling;
+      }
+      if (child == nullptr) {
+         // every keyword under current is less than key
+         node = firstKeyword(skipChildren(current));
+         return;
+      }
+      if ((unsigned char)child->label[0] > next) {
+         node = firstKeyword(child);
+         return;
+      }
+      size_t common = 1;
+      while (common < child->labelLength && matched + common < length &&
+             child->label[common] == key[matched + common]) {
+         common++;
+      }
+      if (common < child->labelLength) {
+         // key ends inside the label, or differs from it
+         if (matched + common == length || 
+             (unsigned char)child->label[common] > 
+             (unsigned char)key[matched + common]) {
+            node = firstKeyword(child);
+         }
+         else {
+            node = firstKeyword(skipChildren(child));
+         }
+         return;
+      }
+      current = child;
+      matched += common;
+   }
+   // key is current's keyword, or the RadixTree is empty
+   node = firstKeyword(current);
+}
+
+//--------------------------------------------------------------------------
+// bool isValid() const;
+// Preconditions: Iterator exists
+// Postconditions: Iterator unchanged
+// Return value: True if at a keyword, false if past the last keyword
+// Functions called: None
+bool RadixTree::Iterator::isValid() const {
+   return node != nullptr;
+}
+
+//--------------------------------------------------------------------------
+// void next();
+// Moves to the following keyword in sorted order
+// Preconditions: isValid()
+// Postconditions: Iterator at the next keyword, or past the end
+// Return value: None
+// Functions called: firstKeyword, skipChildren
+void RadixTree::Iterator::next() {
+   // a keyword comes before the longer keywords under it
+   if (node->child != nullptr) {
+      node = firstKeyword(node->child);
+   }
+   else {
+      node = firstKeyword(skipChildren(node));
+   }
+}
+
+//--------------------------------------------------------------------------
+// const char* keyword() const;
+// Preconditions: isValid()
+// Postconditions: Iterator unchanged
+// Return value: The characters of the current keyword
+// Functions called: None
+const char* RadixTree::Iterator::keyword() const {
+   return node->label + node->labelLength - node->depth;
+}
+
+//--------------------------------------------------------------------------
+// size_t keyLength() const;
+// Preconditions: isValid()
+// Postconditions: Iterator unchanged
+// Return value: The length of the current keyword
+// Functions called: None
+size_t RadixTree::Iterator::keyLength() const {
+   return node->depth;
+}
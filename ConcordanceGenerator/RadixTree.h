@@ -0,0 +1,341 @@
+// RadixTree.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A RadixTree holds the same concordance as a BST, but as a compressed
+// trie of the keywords. Each RadixNode is labelled with a run of characters
+// and the keyword of a RadixNode is the labels on the path down to it, so
+// keywords sharing a prefix share the RadixNodes for it and finding a
+// keyword compares each of its characters once, however many keywords there
+// are. The children of a RadixNode begin with different characters and are
+// kept in order of them, so visiting a RadixNode before its children visits
+// the keywords in sorted order, and every keyword with a given prefix is
+// under one RadixNode. Labels are not copied: each keyword is copied into
+// the Arena once and every label points into the copy of the keyword that
+// made it. The RadixTree can be built, merged, displayed and queried as a
+// BST is.
+//
+// Inputs:
+// -- The Corpus the keywords were read from
+// -- Keywords and the offset of each occurrence in the Corpus
+//
+// Outputs:
+// -- Displaying the concordance of every keyword, or of the keywords
+//    matching a KeywordQuery
+//
+// Assumptions:
+// -- Keywords are not empty
+//
+// Major algorithms & key variables:
+// Algorithms: Compressed trie (radix tree), preorder traversal with parent
+// links
+// Key Variables: RadixNode* root; Arena arena; const char* label;
+// size_t depth
+
+#pragma once
+#include "Postings.h"
+#include "Arena.h"
+#include "ConcordWriter.h"
+#include <string>
+#include <iostream>
+using namespace std;
+
+class Corpus;
+class KeywordQuery;
+class RunStats;
+
+class RadixTree {
+
+private:
+   struct RadixNode {
+      const char* label = nullptr;
+      size_t labelLength = 0;
+      // length of the keyword ending at this RadixNode, which ends with label
+      size_t depth = 0;
+      Postings concord;
+      RadixNode* parent = nullptr;
+      // first child, the rest follow in order of their first character
+      RadixNode* child = nullptr;
+      RadixNode* sibling = nullptr;
+   };
+
+   // root has an empty label and is made with the first keyword
+   RadixNode* root;
+   Arena arena;
+   const Corpus* corpus;
+   bool showSources;
+   ConcordWriter::Layout layout;
+   // kept as the RadixTree is built, for addStats
+   size_t numNodes;
+   size_t numComparisons;
+
+   //--------------------------------------------------------------------------
+   // RadixNode* newRadixNode(const char* label, size_t labelLength,
+   //                         RadixNode* parent);
+   // Creates a RadixNode with no concordances in the Arena below parent
+   // Preconditions: label stays in memory
+   // Postconditions: RadixNode created, not yet linked into the RadixTree
+   // Return value: RadixNode* (will quit if out of memory)
+   // Functions called: make
+   RadixNode* newRadixNode(const char* label, size_t labelLength,
+                           RadixNode* parent);
+
+   //--------------------------------------------------------------------------
+   // RadixNode* findOrAddNode(const char* toAdd, size_t length);
+   // Finds the RadixNode for the keyword, adding one with no concordances if
+   // there is none. A label that only partly matches is split in two.
+   // Preconditions: RadixTree exists, length > 0
+   // Postconditions: A RadixNode for toAdd exists
+   // Return value: RadixNode* for toAdd (will quit if out of memory)
+   // Functions called: newRadixNode(), allocate()
+   RadixNode* findOrAddNode(const char* toAdd, size_t length);
+
+   //--------------------------------------------------------------------------
+   // static RadixNode* skipChildren(const RadixNode* top);
+   // Preconditions: top exists
+   // Postconditions: None
+   // Return value: The first RadixNode after top and everything under it in
+   //               preorder, nullptr if there is none
+   // Functions called: None
+   static RadixNode* skipChildren(const RadixNode* top);
+
+   //--------------------------------------------------------------------------
+   // static RadixNode* firstKeyword(RadixNode* top);
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: top if it ends a keyword, otherwise the next RadixNode in
+   //               preorder that does, nullptr if there is none
+   // Functions called: skipChildren()
+   static RadixNode* firstKeyword(RadixNode* top);
+
+   //--------------------------------------------------------------------------
+   // size_t height() const;
+   // Preconditions: None
+   // Postconditions: RadixTree unchanged
+   // Return value: Number of RadixNodes on the longest path down from the
+   //               root, 0 if there is no root
+   // Functions called: None
+   size_t height() const;
+
+   //--------------------------------------------------------------------------
+   // static void displayNode(const RadixNode* top, ConcordWriter& writer);
+   // Display the keyword with all concordances within the Postings
+   // Preconditions: top ends a keyword
+   // Postconditions: RadixTree unchanged
+   // Return value: None
+   // Functions called: setKeyword, writeConcord
+   static void displayNode(const RadixNode* top, ConcordWriter& writer);
+
+   // a RadixTree owns its RadixNodes through its Arena and is never copied
+   RadixTree(const RadixTree&);
+   RadixTree& operator=(const RadixTree&);
+
+public:
+
+   // An Iterator visits the keywords of a RadixTree in sorted order. It
+   // follows the child, sibling and parent links from the current
+   // RadixNode, so it needs no stack and may be kept between calls to walk
+   // a RadixTree a page at a time.
+   class Iterator {
+      friend class RadixTree;
+
+   private:
+      const RadixTree* tree;
+      RadixNode* node;
+
+   public:
+
+      //-----------------------------------------------------------------------
+      // Iterator(const RadixTree& theTree);
+      // Constructor for an Iterator at the first keyword of theTree
+      // Preconditions: theTree exists and is not changed while iterating
+      // Postconditions: Iterator at the least keyword
+      // Return value: None
+      // Functions called: firstKeyword
+      Iterator(const RadixTree& theTree);
+
+      //-----------------------------------------------------------------------
+      // void seek(const char* key, size_t length);
+      // Moves to the first keyword that is not less than key, comparing
+      // each character of key at most once
+      // Preconditions: Iterator exists
+      // Postconditions: Iterator at that keyword, or past the end
+      // Return value: None
+      // Functions called: firstKeyword, skipChildren
+      void seek(const char* key, size_t length);
+
+      //-----------------------------------------------------------------------
+      // bool isValid() const;
+      // Preconditions: Iterator exists
+      // Postconditions: Iterator unchanged
+      // Return value: True if at a keyword, false if past the last keyword
+      // Functions called: None
+      bool isValid() const;
+
+      //-----------------------------------------------------------------------
+      // void next();
+      // Moves to the following keyword in sorted order
+      // Preconditions: isValid()
+      // Postconditions: Iterator at the next keyword, or past the end
+      // Return value: None
+      // Functions called: firstKeyword, skipChildren
+      void next();
+
+      //-----------------------------------------------------------------------
+      // const char* keyword() const;
+      // Preconditions: isValid()
+      // Postconditions: Iterator unchanged
+      // Return value: The characters of the current keyword
+      // Functions called: None
+      const char* keyword() const;
+
+      //-----------------------------------------------------------------------
+      // size_t keyLength() const;
+      // Preconditions: isValid()
+      // Postconditions: Iterator unchanged
+      // Return value: The length of the current keyword
+      // Functions called: None
+      size_t keyLength() const;
+   };
+
+   //--------------------------------------------------------------------------
+   // RadixTree();
+   // RadixTree constructor
+   // Preconditions: Memory available
+   // Postconditions: Root is now nullptr
+   // Return value: None
+   // Functions called: None
+   RadixTree();
+
+   //--------------------------------------------------------------------------
+   // ~RadixTree();
+   // Destructs RadixTree
+   // Preconditions: RadixTree exists
+   // Postconditions: Every RadixNode released with the Arena
+   // Return value: None
+   // Functions called: release()
+   ~RadixTree();
+
+   //--------------------------------------------------------------------------
+   // void setCorpus(const Corpus* theCorpus);
+   // Sets the Corpus that keyword offsets refer into
+   // Preconditions: RadixTree exists, theCorpus stays open while displayed
+   // Postconditions: Concordances are read from theCorpus
+   // Return value: None
+   // Functions called: None
+   void setCorpus(const Corpus* theCorpus);
+
+   //--------------------------------------------------------------------------
+   // void setShowSources(bool show);
+   // Sets whether each concordance is followed by the name of its document
+   // and the position of the keyword in that document
+   // Preconditions: RadixTree exists
+   // Postconditions: Concordances displayed from now on show their source
+   //                 if show
+   // Return value: None
+   // Functions called: None
+   void setShowSources(bool show);
+
+   //--------------------------------------------------------------------------
+   // void setLayout(const ConcordWriter::Layout& newLayout);
+   // Sets how many words are shown either side of each keyword and how wide
+   // the concordances and keyword are
+   // Preconditions: Every number of newLayout is at least 1
+   // Postconditions: Concordances displayed from now on follow newLayout
+   // Return value: None
+   // Functions called: None
+   void setLayout(const ConcordWriter::Layout& newLayout);
+
+   //--------------------------------------------------------------------------
+   // void displayTree();
+   // Display every keyword with all its concordances, in sorted order
+   // Preconditions: RadixTree exists
+   // Postconditions: RadixTree unchanged
+   // Return value: None
+   // Functions called: next(), displayNode()
+   void displayTree();
+
+   //--------------------------------------------------------------------------
+   // size_t displayQuery(const KeywordQuery& query, string& next);
+   // Display the concordances of the keywords matching query, visiting only
+   // those keywords, up to the query's limit
+   // Preconditions: RadixTree exists
+   // Postconditions: RadixTree unchanged, next is the first matching keyword
+   //                 left undisplayed by the limit, or empty if there is none
+   // Return value: Number of keywords displayed
+   // Functions called: seek, isPastEnd, next, displayNode
+   size_t displayQuery(const KeywordQuery& query, string& next);
+
+   //--------------------------------------------------------------------------
+   // bool isEmpty() const;
+   // Preconditions: RadixTree exists
+   // Postconditions: RadixTree unchanged
+   // Return value: True if there are no keywords, false otherwise
+   // Functions called: None
+   bool isEmpty() const;
+
+   //--------------------------------------------------------------------------
+   // void addKeyword(const string& toAdd, size_t offset);
+   // Adds the concordance at offset to the RadixNode for the keyword
+   // Preconditions: RadixTree exists, toAdd is not empty
+   // Postconditions: toAdd is a keyword of the RadixTree
+   // Return value: None -- will quit if out of memory
+   // Functions called: findOrAddNode()
+   void addKeyword(const string& toAdd, size_t offset);
+
+   //--------------------------------------------------------------------------
+   // void mergeTree(RadixTree& other);
+   // Moves every concordance in other into this RadixTree. For keywords in
+   // both, other's concordances are placed after this RadixTree's.
+   // Preconditions: Both RadixTrees exist and refer to the same Corpus
+   // Postconditions: other is empty, this RadixTree holds all concordances
+   // Return value: None
+   // Functions called: findOrAddNode(), append(), adopt()
+   void mergeTree(RadixTree& other);
+
+   //--------------------------------------------------------------------------
+   // void setArenaBlockSize(size_t bytes);
+   // Sets the largest block the RadixTree's Arena will grow to
+   // Preconditions: RadixTree exists
+   // Postconditions: Arena blocks allocated from now on are at most bytes
+   // Return value: None
+   // Functions called: setMaxBlockSize()
+   void setArenaBlockSize(size_t bytes);
+
+   //--------------------------------------------------------------------------
+   // size_t getArenaBlockSize() const;
+   // Preconditions: RadixTree exists
+   // Postconditions: RadixTree unchanged
+   // Return value: The largest block the RadixTree's Arena will grow to
+   // Functions called: getMaxBlockSize()
+   size_t getArenaBlockSize() const;
+
+   //--------------------------------------------------------------------------
+   // void copySettings(const RadixTree& from);
+   // Gives this RadixTree the Arena block size of from, so that a RadixTree
+   // built from part of a text is built as from is
+   // Preconditions: RadixTree exists
+   // Postconditions: Arena block size the same as from
+   // Return value: None
+   // Functions called: setArenaBlockSize(), getArenaBlockSize()
+   void copySettings(const RadixTree& from);
+
+   //--------------------------------------------------------------------------
+   // Arena::Stats getArenaStats() const;
+   // Preconditions: RadixTree exists
+   // Postconditions: RadixTree unchanged
+   // Return value: Stats of the Arena holding the RadixTree's RadixNodes
+   // Functions called: getStats()
+   Arena::Stats getArenaStats() const;
+
+   //--------------------------------------------------------------------------
+   // void addStats(RunStats& stats) const;
+   // Adds the number of RadixNodes, the height of the RadixTree, the
+   // characters compared building it, its occurrences, the bytes their
+   // Postings take and what its Arena allocated to stats
+   // Preconditions: RadixTree exists
+   // Postconditions: RadixTree unchanged
+   // Return value: None
+   // Functions called: addCount, getStats, height, size, numBytes
+   void addStats(RunStats& stats) const;
+};
@@ -2,193 +2,615 @@
 // Author: Kelsey Stemm
 // Date: 12-9-15
 // Description:
-// ReadIn accepts input from a file to create concordances for the BST. This
+// ReadIn accepts input from files to create concordances for the BST. This
 // program also takes the input and trims away unnecessary punctuation from
-// the keyword only. This will also propagate a stopWords BST for comparison
-// to keywords. If the keyword is a stopword, it will not be input into the
-// BST as a keyword.The concordance is assembled based on the number of
-// WORDS_IN_CONCORD.
+// the keyword only. Each keyword is checked against the StopWords loaded at
+// startup. If the keyword is a stopword, it will not be input into the
+// BST as a keyword. The files are the documents of a Corpus, each memory
+// mapped, and each word is a Token referring into a mapping, so words are
+// never copied. Only the offset of each keyword within the Corpus is given
+// to the BST, which reads the words around it from the same mapping when
+// the concordance is displayed. To read with several threads, the Corpus is
+// split at word boundaries into chunks of about the same length, so a large
+// document is split into several chunks and many small documents are read
+// as one. A pool of threads takes the next unread chunk until none are left
+// and reads each into its own BST. Because every concordance is read from
+// the whole mapping at display time, no context is lost at the edges of a
+// chunk, and merging the chunk BSTs in order gives the same BST as reading
+// the Corpus on one thread. The keywords may be read into either a BST or a
+// RadixTree, which are added to and merged in the same way, or only counted
+// by a KeywordCounter, which is added to and merged the same way again.
+// A KeywordSorter is read into the same way as well, to be sorted and a
+// BST built from it in one pass.
+// A pipelined build instead splits reading into stages on threads of their
+// own, so that waiting on the disk, tokenizing and adding to the tree all
+// overlap. A reader thread pages in each chunk of the Corpus before it is
+// tokenized, by touching a byte of every page. Tokenizer threads, each
+// given every so many chunks in turn, trim the words and filter out stop
+// words, writing the keywords and their offsets into KeywordBatches. The
+// calling thread adds the keywords of every batch to the one tree, chunk
+// by chunk in order, so no tree is merged. The stages pass chunks and
+// batches through RingQueues of fixed size, and each tokenizer writes only
+// into batches the indexing thread has handed back to it, so however far
+// one stage runs ahead of the next, no more text is paged in and no more
+// keywords are held than the queues have room for.
+// A ShardedIndex is read into by a pool of threads as well, each reading
+// a chunk into a ChunkWriter of its own and adding it to the shards of
+// the one index itself, which takes each chunk's keywords in order, so
+// the threads add to the index at once and nothing is merged afterwards.
 // 
 // Inputs: 
-// -- An in file stream
+// -- A Corpus
 //
 // Outputs:
-// -- A BST containing all keywords and their concordances
+// -- A BST, RadixTree or ShardedIndex containing all keywords and where
+//    they occur, or a KeywordCounter of how often they occur, or a
+//    KeywordSorter of where they occur to be sorted
 //
 // Assumptions:
-// -- File to be read in can only have ASCII characters, will have issues with
-//    non-ASCII charaters
+// -- Files are UTF-8, of which ASCII is a part
+// -- The Corpus stays open for as long as the BST is displayed
 // 
 // Major algorithms & key variables:
-// Algorithms: None
-// Key Variables: ifstream inFile; LinkedList<ReadInto> pre, post, all;
-//                BST stopWords
+// Algorithms: Worker pool over chunks of the Corpus, merging BSTs, or a
+// pipeline of stages joined by ring queues
+// Key Variables: Corpus corpus; string key; StopWords stopWords
+
 
 #include "ReadIn.h"
+#include <thread>
+#include <vector>
+#include <memory>
+#include <atomic>
 
 //--------------------------------------------------------------------------
-// ReadIn();
+// ReadIn(const StopWords& stopList);
 // Constructor for ReadIn
-// Preconditions: Memory available
-// Postconditions: All LinkedLists constructed and strings initialized to ""
+// Preconditions: Memory available, stopList loaded
+// Postconditions: key initialized to "", keywords will be checked against
+//                 stopList
 // Return value: None
 // Functions called: None
-ReadIn::ReadIn() {
-   pre.head = nullptr;
-   pre.tail = nullptr;
-   post.head = nullptr;
-   post.tail = nullptr;
+ReadIn::ReadIn(const StopWords& stopList) : stopWords(stopList) {
    key = "";
-   preAssembled = "";
-   postAssembled = "";
+   numTokens = 0;
+   numStopWords = 0;
+   pipelined = false;
+   numPipelineChunks = 0;
+   numReaderWaits = 0;
+   numTokenizerWaits = 0;
+   numIndexerWaits = 0;
 }
 
 //--------------------------------------------------------------------------
-// string generateCon(const LinkedList<ReadInto>& toAssemble);
-// Generates a single string from a LinkedList<ReadInto>. Separates them
-// with a single space.
-// Preconditions: LinkedList exists
-// Postconditions: LinkedList unchanged
-// Return value: A string of the concatenated word set
+// void setPipelined(bool isPipelined);
+// Sets whether buildTree reads through a pipeline of stages on threads
+// of their own rather than a pool of threads building trees of their own
+// Preconditions: None
+// Postconditions: buildTree builds as set
+// Return value: None
 // Functions called: None
-string ReadIn::generateCon(const LinkedList<ReadInto>& toAssemble) {
-   LinkedList<ReadInto>::Node* current = toAssemble.head;
-   string toReturn;
-   while (current != nullptr) {
-      string word = current->data->wordUntrimmed;
-      toReturn.append(word);
-      toReturn.append(" ");
-      current = current->next;
-   }
-   return toReturn;
+void ReadIn::setPipelined(bool isPipelined) {
+   pipelined = isPipelined;
 }
 
 //--------------------------------------------------------------------------
-// bool isStopWord(const string toCheck);
-// When the BST stopWords does not exist, will assemble it. Then will 
-// search the BST for the word.
-// Preconditions: Memory exists for the BST, stopwords.txt available
-// Postconditions: BST stopWords exist
-// Return value: True if toCheck is a stopWord, false if not
-// Functions called: searchBST
-bool ReadIn::isStopWord(const string toCheck) {
-   if (stopWords.isEmpty()) {
-      ifstream stopWordFile;
-      stopWordFile.open("stopwords.txt");
-      if (stopWordFile.is_open()) {
-         string word = "";
-         while (stopWordFile >> word) {
-            for (int i = 0; i < word.length(); i++) {
-               word[i] = tolower(word[i]);
-            }
-            stopWords.addBSTNode(word, "", "");
-         }
-      }
-      // in the event that there is no data, no file and empty word once
-      // trimming is complete
-      stopWords.addBSTNode("", "", "");
+// void addStats(RunStats& stats) const;
+// Adds the number of words read and of stop words skipped to stats,
+// and after a pipelined build how many chunks it read and how often
+// each stage waited on another
+// Preconditions: None
+// Postconditions: ReadIn unchanged
+// Return value: None
+// Functions called: addCount
+void ReadIn::addStats(RunStats& stats) const {
+   stats.addCount("words", numTokens);
+   stats.addCount("stop words", numStopWords);
+   stats.addCount("keywords added", numTokens - numStopWords);
+   if (numPipelineChunks > 0) {
+      stats.addCount("pipeline chunks", numPipelineChunks);
+      stats.addCount("reader waits", numReaderWaits);
+      stats.addCount("tokenizer waits", numTokenizerWaits);
+      stats.addCount("indexer waits", numIndexerWaits);
    }
-   return stopWords.searchBSTKey(toCheck);
-
 }
 
 //--------------------------------------------------------------------------
-// string trimWord(const string toTrim);
+// void trimWord(const Token& toTrim, string& trimmed);
 // Takes an untrimmed word and removes all non-alphanumeric characters from
 // the end of the word. If the word is only non-alphanumeric, will remove
-// word entirely.
-// Preconditions: String exists
-// Postconditions: toTrim unchanged
-// Return value: Trimmed string
-// Functions called: None
-string ReadIn::trimWord(const string toTrim) {
-   string toReturn = toTrim;
-   char lastChar;
-   // while it is not an empty string
-   while (toReturn != ""){
-      lastChar = toReturn[toReturn.length() - 1];
-      if (!isalpha(lastChar) && !isdigit(lastChar)) {
-         toReturn = toReturn.substr(0, toReturn.length() - 1);     
-      }  //will break when there is nothing left to change
-      else {
+// word entirely. The trailing punctuation is skipped in place and only
+// the remaining characters are lowercased into trimmed, whose storage is
+// reused between calls. ASCII is tested a byte at a time; other UTF-8
+// characters are decoded whole, so a word ending in a letter such as e
+// with acute keeps every byte of it.
+// Preconditions: Token refers to a word
+// Postconditions: toTrim unchanged, trimmed holds the lowercase keyword
+// Return value: None
+// Functions called: isAlphanumeric, characterBefore, isWordCharacter, 
+//                   lowerCase
+void ReadIn::trimWord(const Token& toTrim, string& trimmed) {
+   size_t keep = toTrim.length;
+   // while it is not an empty word
+   while (keep > 0) {
+      char last = toTrim.start[keep - 1];
+      if ((unsigned char)last < 0x80) {
+         if (!Tokenizer::isAlphanumeric(last)) {
+            keep--;
+         }  //will break when there is nothing left to change
+         else {
+            break;
+         }
+         continue;
+      }
+      // a character that is not ASCII is trimmed whole, or a byte at a
+      // time if it is not well formed
+      uint32_t codePoint;
+      size_t length = Tokenizer::characterBefore(toTrim.start, 
+                                                 toTrim.start + keep, 
+                                                 codePoint);
+      if (length > 0 && Tokenizer::isWordCharacter(codePoint)) {
          break;
       }
+      keep -= length > 0 ? length : 1;
+   }
+
+   trimmed.resize(keep);
+   if (keep > 0) {
+      Tokenizer::lowerCase(&trimmed[0], toTrim.start, keep);
+   }
+}
+
+//--------------------------------------------------------------------------
+// static size_t wordBoundary(const Corpus& corpus, size_t offset);
+// Preconditions: offset <= corpus.totalLength()
+// Postconditions: None
+// Return value: offset, moved forward past the end of any word it lands
+//               in, so that no word starts before it and ends after it
+// Functions called: findDocument, isSpace
+size_t ReadIn::wordBoundary(const Corpus& corpus, size_t offset) {
+   if (offset >= corpus.totalLength()) {
+      return corpus.totalLength();
+   }
+   size_t document = corpus.findDocument(offset);
+   const char* text = corpus.begin(document);
+   size_t length = corpus.length(document);
+   size_t position = offset - corpus.base(document);
+   // the start of a document is always a boundary, as words never cross
+   // from one document into the next
+   if (position > 0) {
+      while (position < length && !Tokenizer::isSpace(text[position])) {
+         position++;
+      }
    }
-   
-   for (int i = 0; i < toReturn.length(); i++) {
-      toReturn[i] = tolower(toReturn[i]);
+   return corpus.base(document) + position;
+}
+
+//--------------------------------------------------------------------------
+// static void chunkBounds(const Corpus& corpus, size_t numChunks,
+//                         vector<size_t>& bounds);
+// Cuts the corpus at evenly spaced offsets, each moved forward past the
+// end of any word it lands in so that every word belongs to exactly one
+// chunk
+// Preconditions: numChunks > 0
+// Postconditions: bounds holds numChunks + 1 offsets, chunk i running
+//                 from bounds[i] to bounds[i + 1]
+// Return value: None
+// Functions called: wordBoundary
+void ReadIn::chunkBounds(const Corpus& corpus, size_t numChunks,
+                         vector<size_t>& bounds) {
+   size_t length = corpus.totalLength();
+   bounds.resize(numChunks + 1);
+   bounds[0] = 0;
+   bounds[numChunks] = length;
+   for (size_t i = 1; i < numChunks; i++) {
+      size_t bound = length / numChunks * i;
+      if (bound < bounds[i - 1]) {
+         bound = bounds[i - 1];
+      }
+      bounds[i] = wordBoundary(corpus, bound);
    }
-   return toReturn;
 }
 
 //--------------------------------------------------------------------------
-// void getWords(ifstream & inFile);
-// Retrieves all of the words from inFile delimited by whitespace. Makes a
-// new ReadInto for all words in the file and places into LinkedList all.
-// Preconditions: LinkedList all is empty
-// Postconditions: LinkedList all contains all words in file
+// static void touchRange(const Corpus& corpus, size_t from, size_t to);
+// Reads a byte of every page of the documents between offsets from and
+// to of the corpus, so that the pages are read from disk now rather than
+// when the words on them are
+// Preconditions: from <= to <= corpus.totalLength()
+// Postconditions: Corpus unchanged
 // Return value: None
-// Functions called: None
-void ReadIn::getWords(ifstream & inFile) {
-   string word = "";
-   while (inFile >> word) {
-      try {
-         ReadInto* newNode = new ReadInto;
-         newNode->wordUntrimmed = word;
-         all.addLast(newNode);
+// Functions called: findDocument
+void ReadIn::touchRange(const Corpus& corpus, size_t from, size_t to) {
+   const size_t PAGE_SIZE = 4096;
+   if (from >= to) {
+      return;
+   }
+   // volatile, so that the reads are not optimized away
+   volatile char touched = 0;
+   for (size_t document = corpus.findDocument(from);
+        document < corpus.numDocuments() && corpus.base(document) < to;
+        document++) {
+      const char* text = corpus.begin(document);
+      size_t base = corpus.base(document);
+      size_t first = from > base ? from - base : 0;
+      size_t last = corpus.length(document);
+      if (to - base < last) {
+         last = to - base;
       }
-      catch (...) {
-         cout << "You are out of memory.\n";
-         exit(0);
+      for (size_t position = first; position < last;
+           position += PAGE_SIZE) {
+         touched = text[position];
       }
    }
+   (void)touched;
 }
 
 //--------------------------------------------------------------------------
-// void buildTree(ifstream & inFile, BST& theTree);
-// Builds the LinkedLists pre, post, all containing the words within the
-// inFile. For each word, create a pre- and post-keyword concordance and 
-// trim the keyword of all excess punctuation. Then adds a BSTNode to the
-// given BST.
-// Preconditions: inFile has text, BST exists
-// Postconditions: BST has BSTNodes corresponding to the words in the file
+// BatchWriter(RingQueue<KeywordBatch*>& freeQueue,
+//             RingQueue<KeywordBatch*>& fullQueue);
+// Constructor for a BatchWriter
+// Preconditions: None
+// Postconditions: Batches will be taken from freeQueue and sent
+//                 through fullQueue
 // Return value: None
-// Functions called: getWords, addLast, addLastNode, trimWord, isStopWord
-//                   removeFirst
-void ReadIn::buildTree(ifstream &  inFile, BST& theTree) {
-   LinkedList<ReadInto>::Node* theKey;
-   // build the LinkedList of all words
-   getWords(inFile);
-   // initialize the pre- and post-keyword concordance arrays (does not 
-   // initialize key) based on size WORDS_IN_CONCORD
-   for (int i = 0; i < WORDS_IN_CONCORD; i++) {
-      if (all.isEmpty()) {
-         break;
+// Functions called: None
+ReadIn::BatchWriter::BatchWriter(RingQueue<KeywordBatch*>& freeQueue,
+                                 RingQueue<KeywordBatch*>& fullQueue)
+   : freeBatches(freeQueue), fullBatches(fullQueue) {
+   batch = nullptr;
+}
+
+//--------------------------------------------------------------------------
+// void addKeyword(const string& toAdd, size_t offset);
+// Writes toAdd and offset into the batch, taking an empty one if
+// there is none and sending it once it holds BATCH_KEYWORDS
+// Preconditions: None
+// Postconditions: toAdd written
+// Return value: None
+// Functions called: pop, send
+void ReadIn::BatchWriter::addKeyword(const string& toAdd, size_t offset) {
+   if (batch == nullptr) {
+      freeBatches.pop(batch);
+   }
+   batch->characters += toAdd;
+   batch->ends.push_back(batch->characters.length());
+   batch->offsets.push_back(offset);
+   if (batch->offsets.size() == BATCH_KEYWORDS) {
+      send(false);
+   }
+}
+
+//--------------------------------------------------------------------------
+// void endChunk();
+// Sends the last batch of a chunk, empty if it has no keywords left
+// Preconditions: None
+// Postconditions: Every keyword written has been sent
+// Return value: None
+// Functions called: send
+void ReadIn::BatchWriter::endChunk() {
+   send(true);
+}
+
+//--------------------------------------------------------------------------
+// void send(bool endsChunk);
+// Sends the batch being written, taking one if there is none
+// Preconditions: None
+// Postconditions: No batch is being written
+// Return value: None
+// Functions called: pop, push
+void ReadIn::BatchWriter::send(bool endsChunk) {
+   if (batch == nullptr) {
+      freeBatches.pop(batch);
+   }
+   batch->endsChunk = endsChunk;
+   fullBatches.push(batch);
+   batch = nullptr;
+}
+
+//--------------------------------------------------------------------------
+// void buildTree(const Corpus& corpus, Tree& theTree, int numThreads);
+// Reads each word of each document of the corpus in order and trims it
+// of all excess punctuation. Unless it is a stop word, adds the keyword
+// to the given BST along with the offset of the word in the corpus, from
+// which the BST can later find its pre- and post-keyword concordance.
+// With more than one thread, the corpus is split into chunks that
+// numThreads threads read into BSTs of their own, which are then merged
+// in order into the given BST. A pipelined build reads the chunks
+// through buildPipelined instead.
+// Preconditions: corpus is open, BST exists and is empty
+// Postconditions: BST has BSTNodes corresponding to the words in the 
+//                 corpus, the same as built by a single thread
+// Return value: None
+// Functions called: setCorpus, buildPipelined, chunkBounds, copySettings,
+//                   buildRange, mergeTree
+template <class Tree>
+void ReadIn::buildTree(const Corpus& corpus, Tree& theTree, int numThreads) {
+   theTree.setCorpus(&corpus);
+   if (pipelined) {
+      buildPipelined(corpus, theTree, numThreads);
+      return;
+   }
+   size_t length = corpus.totalLength();
+   size_t numChunks = length / MIN_CHUNK_LENGTH;
+   if (numChunks > size_t(numThreads) * CHUNKS_PER_THREAD) {
+      numChunks = size_t(numThreads) * CHUNKS_PER_THREAD;
+   }
+   if (numThreads <= 1 || numChunks <= 1) {
+      buildRange(corpus, 0, length, theTree);
+      return;
+   }
+   vector<size_t> bounds;
+   chunkBounds(corpus, numChunks, bounds);
+
+   unique_ptr<Tree[]> chunkTrees(new Tree[numChunks]);
+   for (size_t i = 0; i < numChunks; i++) {
+      chunkTrees[i].copySettings(theTree);
+   }
+   // each thread takes the next unread chunk, so no thread waits on
+   // another while chunks are left
+   atomic<size_t> nextChunk(0);
+   vector<thread> workers;
+   // each thread counts into a ReadIn of its own
+   vector<ReadIn> chunkReaders;
+   chunkReaders.reserve(size_t(numThreads));
+   for (int i = 0; i < numThreads; i++) {
+      chunkReaders.push_back(ReadIn(stopWords));
+   }
+   for (int i = 0; i < numThreads; i++) {
+      ReadIn& chunkReader = chunkReaders[i];
+      workers.push_back(thread([&corpus, &chunkReader, &chunkTrees, &bounds,
+                                &nextChunk, numChunks]() {
+         size_t chunk;
+         while ((chunk = nextChunk++) < numChunks) {
+            chunkReader.buildRange(corpus, bounds[chunk], bounds[chunk + 1],
+                                   chunkTrees[chunk]);
+         }
+      }));
+   }
+   for (size_t i = 0; i < workers.size(); i++) {
+      workers[i].join();
+      numTokens += chunkReaders[i].numTokens;
+      numStopWords += chunkReaders[i].numStopWords;
+   }
+
+   for (size_t i = 0; i < numChunks; i++) {
+      theTree.mergeTree(chunkTrees[i]);
+   }
+}
+
+//--------------------------------------------------------------------------
+// void buildPipelined(const Corpus& corpus, Tree& theTree,
+//                     int numThreads);
+// Builds theTree as buildTree does, with a reader thread paging in the
+// chunks of the corpus, numThreads tokenizer threads reading the
+// keywords of every numThreads-th chunk into KeywordBatches, and this
+// thread adding the keywords of each chunk's batches to theTree in order
+// Preconditions: corpus is open, theTree exists, is empty and has the
+//                corpus set
+// Postconditions: theTree the same as built by a single thread
+// Return value: None
+// Functions called: chunkBounds, touchRange, buildRange, endChunk, push,
+//                   pop, addKeyword, pushWaits, popWaits
+template <class Tree>
+void ReadIn::buildPipelined(const Corpus& corpus, Tree& theTree,
+                            int numThreads) {
+   size_t numTokenizers = numThreads > 1 ? size_t(numThreads) : 1;
+   size_t numChunks = (corpus.totalLength() + PIPELINE_CHUNK_LENGTH - 1) /
+                      PIPELINE_CHUNK_LENGTH;
+   if (numChunks == 0) {
+      numChunks = 1;
+   }
+   vector<size_t> bounds;
+   chunkBounds(corpus, numChunks, bounds);
+
+   // every queue has one thread pushing and one popping: the reader hands
+   // chunk c to tokenizer c % numTokenizers, which hands its batches to
+   // this thread, which hands them back empty
+   vector<unique_ptr<RingQueue<size_t>>> chunkQueues;
+   vector<unique_ptr<RingQueue<KeywordBatch*>>> freeQueues;
+   vector<unique_ptr<RingQueue<KeywordBatch*>>> fullQueues;
+   unique_ptr<KeywordBatch[]> batches(
+      new KeywordBatch[numTokenizers * BATCHES_PER_TOKENIZER]);
+   for (size_t i = 0; i < numTokenizers; i++) {
+      // the reader pages in at most two chunks ahead of each tokenizer
+      chunkQueues.push_back(unique_ptr<RingQueue<size_t>>(
+         new RingQueue<size_t>(2)));
+      freeQueues.push_back(unique_ptr<RingQueue<KeywordBatch*>>(
+         new RingQueue<KeywordBatch*>(BATCHES_PER_TOKENIZER)));
+      fullQueues.push_back(unique_ptr<RingQueue<KeywordBatch*>>(
+         new RingQueue<KeywordBatch*>(BATCHES_PER_TOKENIZER)));
+      for (size_t j = 0; j < BATCHES_PER_TOKENIZER; j++) {
+         freeQueues[i]->push(&batches[i * BATCHES_PER_TOKENIZER + j]);
+      }
+   }
+
+   thread reader([&corpus, &bounds, &chunkQueues, numChunks, 
+                  numTokenizers]() {
+      for (size_t chunk = 0; chunk < numChunks; chunk++) {
+         touchRange(corpus, bounds[chunk], bounds[chunk + 1]);
+         chunkQueues[chunk % numTokenizers]->push(chunk);
       }
-      ReadInto* newPreNode = new ReadInto;
-      newPreNode->wordUntrimmed = "";
-      pre.addLast(newPreNode);
-      post.addLastNode(all.removeFirst());
-   }
-   while (!post.isEmpty()) {                                            
-      // pre and post exist, no key exists. Add another node from all. 
-      // pull the key from the beginning of the post words. Generate and 
-      // assemble the key and the pre- and post-keyword concordances.
-      // Finally, move the key and remove/delete the first node.
-      if (!all.isEmpty()) {
-         post.addLastNode(all.removeFirst());
+      // numChunks tells each tokenizer that no chunks are left
+      for (size_t i = 0; i < numTokenizers; i++) {
+         chunkQueues[i]->push(numChunks);
       }
-      theKey = post.removeFirst();
-      key = trimWord(theKey->data->wordUntrimmed);
-      // if the key is not a stop word, then make a BST node
-      if (!isStopWord(key)) {
-         preAssembled = generateCon(pre);
-         postAssembled = generateCon(post);
-         theTree.addBSTNode(key, preAssembled, postAssembled);
+   });
+   vector<thread> tokenizers;
+   // each thread counts into a ReadIn of its own
+   vector<ReadIn> chunkReaders;
+   chunkReaders.reserve(numTokenizers);
+   for (size_t i = 0; i < numTokenizers; i++) {
+      chunkReaders.push_back(ReadIn(stopWords));
+   }
+   for (size_t i = 0; i < numTokenizers; i++) {
+      ReadIn& chunkReader = chunkReaders[i];
+      RingQueue<size_t>& chunks = *chunkQueues[i];
+      RingQueue<KeywordBatch*>& freeBatches = *freeQueues[i];
+      RingQueue<KeywordBatch*>& fullBatches = *fullQueues[i];
+      tokenizers.push_back(thread([&corpus, &chunkReader, &bounds, &chunks,
+                                   &freeBatches, &fullBatches, numChunks]() {
+         BatchWriter writer(freeBatches, fullBatches);
+         size_t chunk;
+         chunks.pop(chunk);
+         while (chunk < numChunks) {
+            chunkReader.buildRange(corpus, bounds[chunk], bounds[chunk + 1],
+                                   writer);
+            writer.endChunk();
+            chunks.pop(chunk);
+         }
+      }));
+   }
+
+   // the keywords are added in the order they were read, a chunk at a time
+   string keyword;
+   for (size_t chunk = 0; chunk < numChunks; chunk++) {
+      RingQueue<KeywordBatch*>& fullBatches = 
+         *fullQueues[chunk % numTokenizers];
+      RingQueue<KeywordBatch*>& freeBatches = 
+         *freeQueues[chunk % numTokenizers];
+      bool endsChunk = false;
+      while (!endsChunk) {
+         KeywordBatch* batch;
+         fullBatches.pop(batch);
+         size_t start = 0;
+         for (size_t i = 0; i < batch->offsets.size(); i++) {
+            keyword.assign(batch->characters, start, batch->ends[i] - start);
+            theTree.addKeyword(keyword, batch->offsets[i]);
+            start = batch->ends[i];
+         }
+         endsChunk = batch->endsChunk;
+         batch->characters.clear();
+         batch->ends.clear();
+         batch->offsets.clear();
+         freeBatches.push(batch);
       }
-      pre.addLastNode(theKey);
-      LinkedList<ReadInto>::Node* toDelete = pre.removeFirst();
-      delete toDelete->data;
-      delete toDelete;
+   }
+
+   reader.join();
+   numPipelineChunks = numChunks;
+   numReaderWaits = 0;
+   numTokenizerWaits = 0;
+   numIndexerWaits = 0;
+   for (size_t i = 0; i < numTokenizers; i++) {
+      tokenizers[i].join();
+      numTokens += chunkReaders[i].numTokens;
+      numStopWords += chunkReaders[i].numStopWords;
+      numReaderWaits += chunkQueues[i]->pushWaits();
+      numTokenizerWaits += chunkQueues[i]->popWaits() + 
+                           freeQueues[i]->popWaits() + 
+                           fullQueues[i]->pushWaits();
+      numIndexerWaits += fullQueues[i]->popWaits() + 
+                         freeQueues[i]->pushWaits();
+   }
+}
+
+//--------------------------------------------------------------------------
+// void buildSharded(const Corpus& corpus, ShardedIndex& theIndex,
+//                   int numThreads);
+// Reads the keywords of the corpus into theIndex as buildTree reads
+// them into a BST, with numThreads threads that each take the next
+// unread chunk, read it into a ChunkWriter and add it to theIndex
+// Preconditions: corpus is open, theIndex exists and is empty
+// Postconditions: theIndex holds every keyword of the corpus, the same
+//                 as built by a single thread
+// Return value: None
+// Functions called: setCorpus, chunkBounds, buildRange, addChunk
+void ReadIn::buildSharded(const Corpus& corpus, ShardedIndex& theIndex,
+                          int numThreads) {
+   theIndex.setCorpus(&corpus);
+   size_t numWorkers = numThreads > 1 ? size_t(numThreads) : 1;
+   size_t numChunks = corpus.totalLength() / MIN_CHUNK_LENGTH;
+   if (numChunks > numWorkers * CHUNKS_PER_THREAD) {
+      numChunks = numWorkers * CHUNKS_PER_THREAD;
+   }
+   if (numChunks == 0) {
+      numChunks = 1;
+   }
+   vector<size_t> bounds;
+   chunkBounds(corpus, numChunks, bounds);
+
+   // chunks are taken in order, so the thread with the first chunk not
+   // yet added never waits for its turn at a shard
+   atomic<size_t> nextChunk(0);
+   vector<thread> workers;
+   // each thread counts into a ReadIn of its own
+   vector<ReadIn> chunkReaders;
+   chunkReaders.reserve(numWorkers);
+   for (size_t i = 0; i < numWorkers; i++) {
+      chunkReaders.push_back(ReadIn(stopWords));
+   }
+   for (size_t i = 0; i < numWorkers; i++) {
+      ReadIn& chunkReader = chunkReaders[i];
+      workers.push_back(thread([&corpus, &chunkReader, &theIndex, &bounds,
+                                &nextChunk, numChunks]() {
+         ShardedIndex::ChunkWriter writer(theIndex);
+         size_t chunk;
+         while ((chunk = nextChunk++) < numChunks) {
+            chunkReader.buildRange(corpus, bounds[chunk], bounds[chunk + 1],
+                                   writer);
+            writer.addChunk(chunk);
+         }
+      }));
+   }
+   for (size_t i = 0; i < workers.size(); i++) {
+      workers[i].join();
+      numTokens += chunkReaders[i].numTokens;
+      numStopWords += chunkReaders[i].numStopWords;
    }
 }
+
+//--------------------------------------------------------------------------
+// void buildRange(const Corpus& corpus, size_t from, size_t to, 
+//                 Tree& theTree);
+// Adds the keywords of the words starting between offsets from and to of
+// the corpus to the given BST, reading each document the range covers.
+// Preconditions: from <= to <= corpus.totalLength(), from and to are not
+//                inside a word
+// Postconditions: BST has BSTNodes corresponding to the words in range
+// Return value: None
+// Functions called: findDocument, nextToken, trimWord, isStopWord, 
+//                   addKeyword
+template <class Tree>
+void ReadIn::buildRange(const Corpus& corpus, size_t from, size_t to, 
+                        Tree& theTree) {
+   if (from >= to) {
+      return;
+   }
+   size_t tokensRead = 0;
+   size_t stopWordsRead = 0;
+   for (size_t document = corpus.findDocument(from); 
+        document < corpus.numDocuments() && corpus.base(document) < to; 
+        document++) {
+      const char* text = corpus.begin(document);
+      size_t base = corpus.base(document);
+      size_t first = from > base ? from - base : 0;
+      size_t last = corpus.length(document);
+      if (to - base < last) {
+         last = to - base;
+      }
+      Tokenizer words(text + first, text + last);
+      Token word;
+      while (words.nextToken(word)) {
+         tokensRead++;
+         trimWord(word, key);
+         // if the key is not a stop word, then make a BST node
+         if (!stopWords.isStopWord(key)) {
+            theTree.addKeyword(key, base + size_t(word.start - text));
+         }
+         else {
+            stopWordsRead++;
+         }
+      }
+   }
+   numTokens += tokensRead;
+   numStopWords += stopWordsRead;
+}
+
+// the only kinds of Tree keywords are read into
+template void ReadIn::buildTree<BST>(const Corpus&, BST&, int);
+template void ReadIn::buildTree<RadixTree>(const Corpus&, RadixTree&, int);
+template void ReadIn::buildTree<KeywordCounter>(const Corpus&, 
+                                                KeywordCounter&, int);
+template void ReadIn::buildTree<KeywordSorter>(const Corpus&, 
+                                               KeywordSorter&, int);
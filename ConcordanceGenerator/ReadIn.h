@@ -2,117 +2,313 @@
 // Author: Kelsey Stemm
 // Date: 12-9-15
 // Description:
-// ReadIn accepts input from a file to create concordances for the BST. This
+// ReadIn accepts input from files to create concordances for the BST. This
 // program also takes the input and trims away unnecessary punctuation from
-// the keyword only. This will also propagate a stopWords BST for comparison
-// to keywords. If the keyword is a stopword, it will not be input into the
-// BST as a keyword. The concordance is assembled based on the number of
-// WORDS_IN_CONCORD, by utilizing a LinkedList<ReadInto> where ReadInto holds
-// a single word. Three LinkedLists can exist at any given time: the 
-// concordance for before the keyword (pre), the concordance after (post) and
-// all of the remaining words in the document (all).
+// the keyword only. Each keyword is checked against the StopWords loaded at
+// startup. If the keyword is a stopword, it will not be input into the
+// BST as a keyword. The files are the documents of a Corpus, each memory
+// mapped, and each word is a Token referring into a mapping, so words are
+// never copied. Only the offset of each keyword within the Corpus is given
+// to the BST, which reads the words around it from the same mapping when
+// the concordance is displayed. To read with several threads, the Corpus is
+// split at word boundaries into chunks of about the same length, so a large
+// document is split into several chunks and many small documents are read
+// as one. A pool of threads takes the next unread chunk until none are left
+// and reads each into its own BST. Because every concordance is read from
+// the whole mapping at display time, no context is lost at the edges of a
+// chunk, and merging the chunk BSTs in order gives the same BST as reading
+// the Corpus on one thread. The keywords may be read into either a BST or a
+// RadixTree, which are added to and merged in the same way, or only counted
+// by a KeywordCounter, which is added to and merged the same way again.
+// A KeywordSorter is read into the same way as well, to be sorted and a
+// BST built from it in one pass.
+// A pipelined build instead splits reading into stages on threads of their
+// own, so that waiting on the disk, tokenizing and adding to the tree all
+// overlap. A reader thread pages in each chunk of the Corpus before it is
+// tokenized, by touching a byte of every page. Tokenizer threads, each
+// given every so many chunks in turn, trim the words and filter out stop
+// words, writing the keywords and their offsets into KeywordBatches. The
+// calling thread adds the keywords of every batch to the one tree, chunk
+// by chunk in order, so no tree is merged. The stages pass chunks and
+// batches through RingQueues of fixed size, and each tokenizer writes only
+// into batches the indexing thread has handed back to it, so however far
+// one stage runs ahead of the next, no more text is paged in and no more
+// keywords are held than the queues have room for.
+// A ShardedIndex is read into by a pool of threads as well, each reading
+// a chunk into a ChunkWriter of its own and adding it to the shards of
+// the one index itself, which takes each chunk's keywords in order, so
+// the threads add to the index at once and nothing is merged afterwards.
 // 
 // Inputs: 
-// -- An in file stream
+// -- A Corpus
 //
 // Outputs:
-// -- A BST containing all keywords and their concordances
+// -- A BST, RadixTree or ShardedIndex containing all keywords and where
+//    they occur, or a KeywordCounter of how often they occur, or a
+//    KeywordSorter of where they occur to be sorted
 //
 // Assumptions:
-// -- File to be read in can only have ASCII characters, will have issues with
-//    non-ASCII charaters
+// -- Files are UTF-8, of which ASCII is a part
+// -- The Corpus stays open for as long as the BST is displayed
 // 
 // Major algorithms & key variables:
-// Algorithms: None
-// Key Variables: ifstream inFile; LinkedList<ReadInto> pre, post, all;
-//                BST stopWords, int WORDS_IN_CONCORD
+// Algorithms: Worker pool over chunks of the Corpus, merging BSTs, or a
+// pipeline of stages joined by ring queues
+// Key Variables: Corpus corpus; string key; StopWords stopWords
 
 #pragma once
 
 #include <iostream>
 #include <string>
-#include <fstream>
-#include "LinkedList.h"
 #include "BST.h"
+#include "RadixTree.h"
+#include "KeywordCounter.h"
+#include "KeywordSorter.h"
+#include "ShardedIndex.h"
+#include "Corpus.h"
+#include "Tokenizer.h"
+#include "StopWords.h"
+#include "RunStats.h"
+#include "RingQueue.h"
+#include <vector>
 using namespace std;
 
 class ReadIn {
 
 private:
-   struct ReadInto {
-      string wordUntrimmed;
-   };
    string key;
-   string preAssembled;
-   string postAssembled;
-   LinkedList<ReadInto> pre;
-   LinkedList<ReadInto> post;
-   LinkedList <ReadInto> all;
-   BST stopWords;
+   const StopWords& stopWords;
+   // words read and how many were stop words, kept by each ReadIn
+   size_t numTokens;
+   size_t numStopWords;
+   // whether buildTree runs as a pipeline, and what the last one did
+   bool pipelined;
+   size_t numPipelineChunks;
+   size_t numReaderWaits;
+   size_t numTokenizerWaits;
+   size_t numIndexerWaits;
+
+   // the keywords of part of a chunk, one after another in characters,
+   // each ending at its entry of ends and occurring at that of offsets
+   struct KeywordBatch {
+      string characters;
+      vector<size_t> ends;
+      vector<size_t> offsets;
+      // true on the last batch of a chunk
+      bool endsChunk;
+   };
+
+   // A BatchWriter is read into by buildRange as if it were a tree, and
+   // writes the keywords into KeywordBatches from one queue, sending each
+   // on through another once it is full or its chunk is done.
+   class BatchWriter {
+
+   private:
+      RingQueue<KeywordBatch*>& freeBatches;
+      RingQueue<KeywordBatch*>& fullBatches;
+      KeywordBatch* batch;
+
+      //-----------------------------------------------------------------------
+      // void send(bool endsChunk);
+      // Sends the batch being written, taking one if there is none
+      // Preconditions: None
+      // Postconditions: No batch is being written
+      // Return value: None
+      // Functions called: pop, push
+      void send(bool endsChunk);
+
+   public:
+
+      //-----------------------------------------------------------------------
+      // BatchWriter(RingQueue<KeywordBatch*>& freeQueue,
+      //             RingQueue<KeywordBatch*>& fullQueue);
+      // Constructor for a BatchWriter
+      // Preconditions: None
+      // Postconditions: Batches will be taken from freeQueue and sent
+      //                 through fullQueue
+      // Return value: None
+      // Functions called: None
+      BatchWriter(RingQueue<KeywordBatch*>& freeQueue,
+                  RingQueue<KeywordBatch*>& fullQueue);
+
+      //-----------------------------------------------------------------------
+      // void addKeyword(const string& toAdd, size_t offset);
+      // Writes toAdd and offset into the batch, taking an empty one if
+      // there is none and sending it once it holds BATCH_KEYWORDS
+      // Preconditions: None
+      // Postconditions: toAdd written
+      // Return value: None
+      // Functions called: pop, send
+      void addKeyword(const string& toAdd, size_t offset);
+
+      //-----------------------------------------------------------------------
+      // void endChunk();
+      // Sends the last batch of a chunk, empty if it has no keywords left
+      // Preconditions: None
+      // Postconditions: Every keyword written has been sent
+      // Return value: None
+      // Functions called: send
+      void endChunk();
+   };
+
+   //--------------------------------------------------------------------------
+   // static size_t wordBoundary(const Corpus& corpus, size_t offset);
+   // Preconditions: offset <= corpus.totalLength()
+   // Postconditions: None
+   // Return value: offset, moved forward past the end of any word it lands
+   //               in, so that no word starts before it and ends after it
+   // Functions called: findDocument, isSpace
+   static size_t wordBoundary(const Corpus& corpus, size_t offset);
+
+   //--------------------------------------------------------------------------
+   // static void chunkBounds(const Corpus& corpus, size_t numChunks,
+   //                         vector<size_t>& bounds);
+   // Cuts the corpus at evenly spaced offsets, each moved forward past the
+   // end of any word it lands in so that every word belongs to exactly one
+   // chunk
+   // Preconditions: numChunks > 0
+   // Postconditions: bounds holds numChunks + 1 offsets, chunk i running
+   //                 from bounds[i] to bounds[i + 1]
+   // Return value: None
+   // Functions called: wordBoundary
+   static void chunkBounds(const Corpus& corpus, size_t numChunks,
+                           vector<size_t>& bounds);
+
+   //--------------------------------------------------------------------------
+   // static void touchRange(const Corpus& corpus, size_t from, size_t to);
+   // Reads a byte of every page of the documents between offsets from and
+   // to of the corpus, so that the pages are read from disk now rather than
+   // when the words on them are
+   // Preconditions: from <= to <= corpus.totalLength()
+   // Postconditions: Corpus unchanged
+   // Return value: None
+   // Functions called: findDocument
+   static void touchRange(const Corpus& corpus, size_t from, size_t to);
+
+   //--------------------------------------------------------------------------
+   // void buildPipelined(const Corpus& corpus, Tree& theTree,
+   //                     int numThreads);
+   // Builds theTree as buildTree does, with a reader thread paging in the
+   // chunks of the corpus, numThreads tokenizer threads reading the
+   // keywords of every numThreads-th chunk into KeywordBatches, and this
+   // thread adding the keywords of each chunk's batches to theTree in order
+   // Preconditions: corpus is open, theTree exists, is empty and has the
+   //                corpus set
+   // Postconditions: theTree the same as built by a single thread
+   // Return value: None
+   // Functions called: chunkBounds, touchRange, buildRange, endChunk, push,
+   //                   pop, addKeyword, pushWaits, popWaits
+   template <class Tree>
+   void buildPipelined(const Corpus& corpus, Tree& theTree, int numThreads);
 
 public:
-   static const int WORDS_IN_CONCORD = 5;
+   // chunks read for each thread, so that a thread given short chunks
+   // takes more of them, and the shortest chunk worth a BST of its own
+   static const int CHUNKS_PER_THREAD = 4;
+   static const size_t MIN_CHUNK_LENGTH = 1 << 16;
+   // the length of the chunks of a pipelined build, the most keywords in
+   // one of its batches, and how many batches each tokenizer may fill
+   // before the indexing thread hands one back
+   static const size_t PIPELINE_CHUNK_LENGTH = 1 << 20;
+   static const size_t BATCH_KEYWORDS = 4096;
+   static const size_t BATCHES_PER_TOKENIZER = 8;
 
    //--------------------------------------------------------------------------
-   // ReadIn();
+   // ReadIn(const StopWords& stopList);
    // Constructor for ReadIn
-   // Preconditions: Memory available
-   // Postconditions: All LinkedLists constructed and strings initialized to ""
+   // Preconditions: Memory available, stopList loaded
+   // Postconditions: key initialized to "", keywords will be checked against
+   //                 stopList
    // Return value: None
    // Functions called: None
-   ReadIn();
+   ReadIn(const StopWords& stopList);
+
+   //--------------------------------------------------------------------------
+   // void trimWord(const Token& toTrim, string& trimmed);
+   // Takes an untrimmed word and removes all non-alphanumeric characters from
+   // the end of the word. If the word is only non-alphanumeric, will remove
+   // word entirely. The trailing punctuation is skipped in place and only
+   // the remaining characters are lowercased into trimmed, whose storage is
+   // reused between calls. ASCII is tested a byte at a time; other UTF-8
+   // characters are decoded whole, so a word ending in a letter such as e
+   // with acute keeps every byte of it.
+   // Preconditions: Token refers to a word
+   // Postconditions: toTrim unchanged, trimmed holds the lowercase keyword
+   // Return value: None
+   // Functions called: isAlphanumeric, characterBefore, isWordCharacter, 
+   //                   lowerCase
+   void trimWord(const Token& toTrim, string& trimmed);
 
    //--------------------------------------------------------------------------
-   // string generateCon(const LinkedList<ReadInto>& toAssemble);
-   // Generates a single string from a LinkedList<ReadInto>. Separates them
-   // with a single space.
-   // Preconditions: LinkedList exists
-   // Postconditions: LinkedList unchanged
-   // Return value: A string of the concatenated word set
+   // void setPipelined(bool isPipelined);
+   // Sets whether buildTree reads through a pipeline of stages on threads
+   // of their own rather than a pool of threads building trees of their own
+   // Preconditions: None
+   // Postconditions: buildTree builds as set
+   // Return value: None
    // Functions called: None
-   string generateCon(const LinkedList<ReadInto>& toAssemble);
+   void setPipelined(bool isPipelined);
 
    //--------------------------------------------------------------------------
-   // bool isStopWord(const string toCheck);
-   // When the BST stopWords does not exist, will assemble it. Then will 
-   // search the BST for the word.
-   // Preconditions: Memory exists for the BST, stopwords.txt available
-   // Postconditions: BST stopWords exist
-   // Return value: True if toCheck is a stopWord, false if not
-   // Functions called: searchBST
-   bool isStopWord(const string toCheck);
+   // void addStats(RunStats& stats) const;
+   // Adds the number of words read and of stop words skipped to stats,
+   // and after a pipelined build how many chunks it read and how often
+   // each stage waited on another
+   // Preconditions: None
+   // Postconditions: ReadIn unchanged
+   // Return value: None
+   // Functions called: addCount
+   void addStats(RunStats& stats) const;
 
    //--------------------------------------------------------------------------
-   // string trimWord(const string toTrim);
-   // Takes an untrimmed word and removes all non-alphanumeric characters from
-   // the end of the word. If the word is only non-alphanumeric, will remove
-   // word entirely.
-   // Preconditions: String exists
-   // Postconditions: toTrim unchanged
-   // Return value: Trimmed string
-   // Functions called: None
-   string trimWord(const string toTrim);
+   // void buildSharded(const Corpus& corpus, ShardedIndex& theIndex,
+   //                   int numThreads);
+   // Reads the keywords of the corpus into theIndex as buildTree reads
+   // them into a BST, with numThreads threads that each take the next
+   // unread chunk, read it into a ChunkWriter and add it to theIndex
+   // Preconditions: corpus is open, theIndex exists and is empty
+   // Postconditions: theIndex holds every keyword of the corpus, the same
+   //                 as built by a single thread
+   // Return value: None
+   // Functions called: setCorpus, chunkBounds, buildRange, addChunk
+   void buildSharded(const Corpus& corpus, ShardedIndex& theIndex,
+                     int numThreads);
+
+   // The buildTree and buildRange templates are defined in ReadIn.cpp for
+   // Tree of BST, RadixTree, KeywordCounter and KeywordSorter.
 
    //--------------------------------------------------------------------------
-   // void getWords(ifstream & inFile);
-   // Retrieves all of the words from inFile delimited by whitespace. Makes a
-   // new ReadInto for all words in the file and places into LinkedList all.
-   // Preconditions: LinkedList all is empty
-   // Postconditions: LinkedList all contains all words in file
+   // void buildTree(const Corpus& corpus, Tree& theTree, int numThreads);
+   // Reads each word of each document of the corpus in order and trims it
+   // of all excess punctuation. Unless it is a stop word, adds the keyword
+   // to the given BST along with the offset of the word in the corpus, from
+   // which the BST can later find its pre- and post-keyword concordance.
+   // With more than one thread, the corpus is split into chunks that
+   // numThreads threads read into BSTs of their own, which are then merged
+   // in order into the given BST. A pipelined build reads the chunks
+   // through buildPipelined instead.
+   // Preconditions: corpus is open, BST exists and is empty
+   // Postconditions: BST has BSTNodes corresponding to the words in the 
+   //                 corpus, the same as built by a single thread
    // Return value: None
-   // Functions called: None
-   void getWords(ifstream & inFile);
+   // Functions called: setCorpus, buildPipelined, chunkBounds, copySettings,
+   //                   buildRange, mergeTree
+   template <class Tree>
+   void buildTree(const Corpus& corpus, Tree& theTree, int numThreads);
 
    //--------------------------------------------------------------------------
-   // void buildTree(ifstream & inFile, BST& theTree);
-   // Builds the LinkedLists pre, post, all containing the words within the
-   // inFile. For each word, create a pre- and post-keyword concordance and 
-   // trim the keyword of all excess punctuation. Then adds a BSTNode to the
-   // given BST.
-   // Preconditions: inFile has text, BST exists
-   // Postconditions: BST has BSTNodes corresponding to the words in the file
+   // void buildRange(const Corpus& corpus, size_t from, size_t to, 
+   //                 Tree& theTree);
+   // Adds the keywords of the words starting between offsets from and to of
+   // the corpus to the given BST, reading each document the range covers.
+   // Preconditions: from <= to <= corpus.totalLength(), from and to are not
+   //                inside a word
+   // Postconditions: BST has BSTNodes corresponding to the words in range
    // Return value: None
-   // Functions called: getWords, addLast, addLastNode, trimWord, isStopWord
-   //                   removeFirst
-   void buildTree(ifstream & inFile, BST& theTree);
+   // Functions called: findDocument, nextToken, trimWord, isStopWord, 
+   //                   addKeyword
+   template <class Tree>
+   void buildRange(const Corpus& corpus, size_t from, size_t to, 
+                   Tree& theTree);
+
 };
@@ -0,0 +1,245 @@
+// RingQueue.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A RingQueue passes Items from one thread to another, first in, first
+// out, without locks. The Items are kept in a ring of fixed size: the
+// producing thread writes at the tail and the consuming thread reads at the
+// head, each position an atomic count that only its own thread changes, so
+// an Item is handed over by one store that the other thread sees with its
+// next load. The head and tail are kept on cache lines of their own so the
+// two threads do not slow each other down by sharing one. A full ring makes
+// the producer wait for the consumer to catch up, so no more Items are ever
+// in flight than the ring holds however far apart the threads' speeds are.
+// Waiting threads yield their processor, and how often each side had to
+// wait is counted, which shows which of the two threads is the slower.
+//
+// Inputs:
+// -- Items from the producing thread
+//
+// Outputs:
+// -- The same Items, in order, to the consuming thread
+// -- The number of times each thread had to wait
+//
+// Assumptions:
+// -- Exactly one thread pushes and exactly one thread pops
+// -- Items are cheap to copy, such as pointers or numbers
+//
+// Major algorithms & key variables:
+// Algorithms: Single producer, single consumer ring buffer with acquire and
+// release ordering
+// Key Variables: vector<Item> items; atomic<size_t> head, tail
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+using namespace std;
+
+template <typename Item>
+class RingQueue {
+
+private:
+   static const size_t CACHE_LINE = 64;
+
+   vector<Item> items;
+   // capacity - 1, as the capacity is a power of two
+   size_t mask;
+   char beforeHead[CACHE_LINE];
+   // the number of Items ever popped, changed only by the consumer, and
+   // the number of times it waited
+   atomic<size_t> head;
+   size_t numPopWaits;
+   char beforeTail[CACHE_LINE];
+   // the number of Items ever pushed, changed only by the producer, and
+   // the number of times it waited
+   atomic<size_t> tail;
+   size_t numPushWaits;
+   char afterTail[CACHE_LINE];
+
+   // a RingQueue is shared between threads in place and is never copied
+   RingQueue(const RingQueue&);
+   RingQueue& operator=(const RingQueue&);
+
+public:
+
+   //--------------------------------------------------------------------------
+   // RingQueue(size_t capacity);
+   // Constructor for a RingQueue
+   // Preconditions: capacity > 0
+   // Postconditions: Empty RingQueue holding up to capacity rounded up to a
+   //                 power of two Items
+   // Return value: None
+   // Functions called: None
+   RingQueue(size_t capacity);
+
+   //--------------------------------------------------------------------------
+   // bool tryPush(const Item& item);
+   // Adds item at the tail if there is room
+   // Preconditions: Called only by the producing thread
+   // Postconditions: item will be popped after every Item pushed before it
+   // Return value: True if pushed, false if the RingQueue is full
+   // Functions called: None
+   bool tryPush(const Item& item);
+
+   //--------------------------------------------------------------------------
+   // bool tryPop(Item& item);
+   // Removes the Item at the head if there is one
+   // Preconditions: Called only by the consuming thread
+   // Postconditions: item is the oldest Item pushed and not yet popped
+   // Return value: True if popped, false if the RingQueue is empty
+   // Functions called: None
+   bool tryPop(Item& item);
+
+   //--------------------------------------------------------------------------
+   // void push(const Item& item);
+   // Adds item at the tail, waiting for room if the RingQueue is full
+   // Preconditions: Called only by the producing thread
+   // Postconditions: item pushed
+   // Return value: None
+   // Functions called: tryPush, yield
+   void push(const Item& item);
+
+   //--------------------------------------------------------------------------
+   // void pop(Item& item);
+   // Removes the Item at the head, waiting for one if the RingQueue is empty
+   // Preconditions: Called only by the consuming thread
+   // Postconditions: item popped
+   // Return value: None
+   // Functions called: tryPop, yield
+   void pop(Item& item);
+
+   //--------------------------------------------------------------------------
+   // size_t pushWaits() const;
+   // Preconditions: The producing thread has finished
+   // Postconditions: RingQueue unchanged
+   // Return value: The number of pushes that had to wait for room
+   // Functions called: None
+   size_t pushWaits() const;
+
+   //--------------------------------------------------------------------------
+   // size_t popWaits() const;
+   // Preconditions: The consuming thread has finished
+   // Postconditions: RingQueue unchanged
+   // Return value: The number of pops that had to wait for an Item
+   // Functions called: None
+   size_t popWaits() const;
+};
+
+//--------------------------------------------------------------------------
+// RingQueue(size_t capacity);
+// Constructor for a RingQueue
+// Preconditions: capacity > 0
+// Postconditions: Empty RingQueue holding up to capacity rounded up to a
+//                 power of two Items
+// Return value: None
+// Functions called: None
+template <typename Item>
+RingQueue<Item>::RingQueue(size_t capacity) : head(0), tail(0) {
+   size_t size = 1;
+   while (size < capacity) {
+      size *= 2;
+   }
+   items.resize(size);
+   mask = size - 1;
+   numPushWaits = 0;
+   numPopWaits = 0;
+}
+
+//--------------------------------------------------------------------------
+// bool tryPush(const Item& item);
+// Adds item at the tail if there is room
+// Preconditions: Called only by the producing thread
+// Postconditions: item will be popped after every Item pushed before it
+// Return value: True if pushed, false if the RingQueue is full
+// Functions called: None
+template <typename Item>
+bool RingQueue<Item>::tryPush(const Item& item) {
+   size_t at = tail.load(memory_order_relaxed);
+   // acquire, so the consumer is done with the slot before it is reused
+   if (at - head.load(memory_order_acquire) == items.size()) {
+      return false;
+   }
+   items[at & mask] = item;
+   // release, so the consumer sees the Item once it sees the new tail
+   tail.store(at + 1, memory_order_release);
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// bool tryPop(Item& item);
+// Removes the Item at the head if there is one
+// Preconditions: Called only by the consuming thread
+// Postconditions: item is the oldest Item pushed and not yet popped
+// Return value: True if popped, false if the RingQueue is empty
+// Functions called: None
+template <typename Item>
+bool RingQueue<Item>::tryPop(Item& item) {
+   size_t at = head.load(memory_order_relaxed);
+   if (at == tail.load(memory_order_acquire)) {
+      return false;
+   }
+   item = items[at & mask];
+   head.store(at + 1, memory_order_release);
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// void push(const Item& item);
+// Adds item at the tail, waiting for room if the RingQueue is full
+// Preconditions: Called only by the producing thread
+// Postconditions: item pushed
+// Return value: None
+// Functions called: tryPush, yield
+template <typename Item>
+void RingQueue<Item>::push(const Item& item) {
+   if (tryPush(item)) {
+      return;
+   }
+   numPushWaits++;
+   while (!tryPush(item)) {
+      this_thread::yield();
+   }
+}
+
+//--------------------------------------------------------------------------
+// void pop(Item& item);
+// Removes the Item at the head, waiting for one if the RingQueue is empty
+// Preconditions: Called only by the consuming thread
+// Postconditions: item popped
+// Return value: None
+// Functions called: tryPop, yield
+template <typename Item>
+void RingQueue<Item>::pop(Item& item) {
+   if (tryPop(item)) {
+      return;
+   }
+   numPopWaits++;
+   while (!tryPop(item)) {
+      this_thread::yield();
+   }
+}
+
+//--------------------------------------------------------------------------
+// size_t pushWaits() const;
+// Preconditions: The producing thread has finished
+// Postconditions: RingQueue unchanged
+// Return value: The number of pushes that had to wait for room
+// Functions called: None
+template <typename Item>
+size_t RingQueue<Item>::pushWaits() const {
+   return numPushWaits;
+}
+
+//--------------------------------------------------------------------------
+// size_t popWaits() const;
+// Preconditions: The consuming thread has finished
+// Postconditions: RingQueue unchanged
+// Return value: The number of pops that had to wait for an Item
+// Functions called: None
+template <typename Item>
+size_t RingQueue<Item>::popWaits() const {
+   return numPopWaits;
+}
@@ -0,0 +1,213 @@
+// RunStats.cpp
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// RunStats records where the time of a concordance run went and what it
+// counted along the way. The driver times each phase of the run, such as
+// reading the text, building the BST and displaying it, and the parts of
+// the program that did the work add their counts afterward: ReadIn its
+// words and stop words, the BST its comparisons, BSTNodes, height and
+// Arena, and so on. Nothing is counted through RunStats while the work is
+// being done; each part keeps plain counts of its own, one set for each
+// thread, and only hands them over once it is finished, so a run costs the
+// same whether or not its RunStats are shown. The phases and counts are
+// written in the order they were recorded, either as a summary to read or
+// as a JSON object for other programs.
+//
+// Inputs:
+// -- The start and end of each phase
+// -- Named counts from the parts of the run
+//
+// Outputs:
+// -- A summary or JSON object of every phase and count
+//
+// Assumptions:
+// -- Phases are not nested
+//
+// Major algorithms & key variables:
+// Algorithms: None
+// Key Variables: vector<Phase> phases; vector<Count> counts; bool enabled
+
+#include "RunStats.h"
+#include <chrono>
+#include <iomanip>
+
+//--------------------------------------------------------------------------
+// RunStats();
+// Constructor for RunStats
+// Preconditions: None
+// Postconditions: RunStats disabled, with no phases or counts
+// Return value: None
+// Functions called: None
+RunStats::RunStats() {
+   enabled = false;
+   phaseStarted = 0;
+}
+
+//--------------------------------------------------------------------------
+// static double now();
+// Preconditions: None
+// Postconditions: None
+// Return value: Seconds on a clock that never goes backwards
+// Functions called: now
+double RunStats::now() {
+   return chrono::duration<double>(
+      chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//--------------------------------------------------------------------------
+// void setEnabled(bool enable);
+// Preconditions: None
+// Postconditions: Phases are timed from now on if enable, and not at all
+//                 otherwise
+// Return value: None
+// Functions called: None
+void RunStats::setEnabled(bool enable) {
+   enabled = enable;
+}
+
+//--------------------------------------------------------------------------
+// bool isEnabled() const;
+// Preconditions: None
+// Postconditions: RunStats unchanged
+// Return value: True if phases are being timed, false otherwise
+// Functions called: None
+bool RunStats::isEnabled() const {
+   return enabled;
+}
+
+//--------------------------------------------------------------------------
+// void startPhase(const string& name);
+// Starts timing the phase name
+// Preconditions: No phase is being timed
+// Postconditions: The phase is being timed, if enabled
+// Return value: None
+// Functions called: now
+void RunStats::startPhase(const string& name) {
+   if (!enabled) {
+      return;
+   }
+   Phase phase;
+   phase.name = name;
+   phase.seconds = 0;
+   phases.push_back(phase);
+   phaseStarted = now();
+}
+
+//--------------------------------------------------------------------------
+// void endPhase();
+// Stops timing the phase last started and records its time
+// Preconditions: startPhase called
+// Postconditions: The phase's time is recorded, if enabled
+// Return value: None
+// Functions called: now
+void RunStats::endPhase() {
+   if (!enabled || phases.empty()) {
+      return;
+   }
+   phases.back().seconds = now() - phaseStarted;
+}
+
+//--------------------------------------------------------------------------
+// void addCount(const string& name, size_t value);
+// Adds value to the count name, recording it if there is none yet
+// Preconditions: None
+// Postconditions: The count name is increased by value
+// Return value: None
+// Functions called: None
+void RunStats::addCount(const string& name, size_t value) {
+   for (size_t i = 0; i < counts.size(); i++) {
+      if (counts[i].name == name) {
+         counts[i].value += value;
+         return;
+      }
+   }
+   Count count;
+   count.name = name;
+   count.value = value;
+   counts.push_back(count);
+}
+
+//--------------------------------------------------------------------------
+// void writeSummary(ostream& out) const;
+// Writes one line for each phase and each count
+// Preconditions: out is open
+// Postconditions: Summary written
+// Return value: None
+// Functions called: None
+void RunStats::writeSummary(ostream& out) const {
+   double total = 0;
+   for (size_t i = 0; i < phases.size(); i++) {
+      total += phases[i].seconds;
+   }
+   out << "Phases:\n";
+   for (size_t i = 0; i < phases.size(); i++) {
+      out << "   " << left << setw(24) << phases[i].name << right << fixed
+          << setprecision(6) << setw(12) << phases[i].seconds << " s";
+      if (total > 0) {
+         out << setprecision(1) << setw(8)
+             << phases[i].seconds * 100 / total << "%";
+      }
+      out << "\n";
+   }
+   out << "Counts:\n";
+   for (size_t i = 0; i < counts.size(); i++) {
+      out << "   " << left << setw(24) << counts[i].name << right
+          << setw(14) << counts[i].value << "\n";
+   }
+   out.unsetf(ios::floatfield | ios::adjustfield);
+}
+
+//--------------------------------------------------------------------------
+// void writeJson(ostream& out) const;
+// Writes the phases and counts as a JSON object on one line:
+// {"phases":{"name":seconds,...},"counts":{"name":value,...}}
+// Preconditions: out is open
+// Postconditions: JSON written
+// Return value: None
+// Functions called: writeJsonString
+void RunStats::writeJson(ostream& out) const {
+   out << "{\"phases\":{";
+   for (size_t i = 0; i < phases.size(); i++) {
+      if (i > 0) {
+         out << ",";
+      }
+      writeJsonString(out, phases[i].name);
+      out << ":" << fixed << setprecision(6) << phases[i].seconds;
+   }
+   out << "},\"counts\":{";
+   for (size_t i = 0; i < counts.size(); i++) {
+      if (i > 0) {
+         out << ",";
+      }
+      writeJsonString(out, counts[i].name);
+      out << ":" << counts[i].value;
+   }
+   out << "}}\n";
+   out.unsetf(ios::floatfield);
+}
+
+//--------------------------------------------------------------------------
+// static void writeJsonString(ostream& out, const string& text);
+// Writes text as a quoted JSON string
+// Preconditions: out is open
+// Postconditions: text written with quotes and escapes
+// Return value: None
+// Functions called: None
+void RunStats::writeJsonString(ostream& out, const string& text) {
+   out << '"';
+   for (size_t i = 0; i < text.length(); i++) {
+      unsigned char character = (unsigned char)text[i];
+      if (character == '"' || character == '\\') {
+         out << '\\' << text[i];
+      }
+      else if (character < 0x20) {
+         const char* hex = "0123456789abcdef";
+         out << "\\u00" << hex[character >> 4] << hex[character & 15];
+      }
+      else {
+         out << text[i];
+      }
+   }
+   out << '"';
+}
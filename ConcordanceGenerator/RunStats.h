@@ -0,0 +1,146 @@
+// RunStats.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// RunStats records where the time of a concordance run went and what it
+// counted along the way. The driver times each phase of the run, such as
+// reading the text, building the BST and displaying it, and the parts of
+// the program that did the work add their counts afterward: ReadIn its
+// words and stop words, the BST its comparisons, BSTNodes, height and
+// Arena, and so on. Nothing is counted through RunStats while the work is
+// being done; each part keeps plain counts of its own, one set for each
+// thread, and only hands them over once it is finished, so a run costs the
+// same whether or not its RunStats are shown. The phases and counts are
+// written in the order they were recorded, either as a summary to read or
+// as a JSON object for other programs.
+//
+// Inputs:
+// -- The start and end of each phase
+// -- Named counts from the parts of the run
+//
+// Outputs:
+// -- A summary or JSON object of every phase and count
+//
+// Assumptions:
+// -- Phases are not nested
+//
+// Major algorithms & key variables:
+// Algorithms: None
+// Key Variables: vector<Phase> phases; vector<Count> counts; bool enabled
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstddef>
+using namespace std;
+
+class RunStats {
+
+private:
+   struct Phase {
+      string name;
+      double seconds;
+   };
+   struct Count {
+      string name;
+      size_t value;
+   };
+
+   bool enabled;
+   vector<Phase> phases;
+   vector<Count> counts;
+   double phaseStarted;
+
+   //--------------------------------------------------------------------------
+   // static double now();
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: Seconds on a clock that never goes backwards
+   // Functions called: now
+   static double now();
+
+   //--------------------------------------------------------------------------
+   // static void writeJsonString(ostream& out, const string& text);
+   // Writes text as a quoted JSON string
+   // Preconditions: out is open
+   // Postconditions: text written with quotes and escapes
+   // Return value: None
+   // Functions called: None
+   static void writeJsonString(ostream& out, const string& text);
+
+public:
+
+   //--------------------------------------------------------------------------
+   // RunStats();
+   // Constructor for RunStats
+   // Preconditions: None
+   // Postconditions: RunStats disabled, with no phases or counts
+   // Return value: None
+   // Functions called: None
+   RunStats();
+
+   //--------------------------------------------------------------------------
+   // void setEnabled(bool enable);
+   // Preconditions: None
+   // Postconditions: Phases are timed from now on if enable, and not at all
+   //                 otherwise
+   // Return value: None
+   // Functions called: None
+   void setEnabled(bool enable);
+
+   //--------------------------------------------------------------------------
+   // bool isEnabled() const;
+   // Preconditions: None
+   // Postconditions: RunStats unchanged
+   // Return value: True if phases are being timed, false otherwise
+   // Functions called: None
+   bool isEnabled() const;
+
+   //--------------------------------------------------------------------------
+   // void startPhase(const string& name);
+   // Starts timing the phase name
+   // Preconditions: No phase is being timed
+   // Postconditions: The phase is being timed, if enabled
+   // Return value: None
+   // Functions called: now
+   void startPhase(const string& name);
+
+   //--------------------------------------------------------------------------
+   // void endPhase();
+   // Stops timing the phase last started and records its time
+   // Preconditions: startPhase called
+   // Postconditions: The phase's time is recorded, if enabled
+   // Return value: None
+   // Functions called: now
+   void endPhase();
+
+   //--------------------------------------------------------------------------
+   // void addCount(const string& name, size_t value);
+   // Adds value to the count name, recording it if there is none yet
+   // Preconditions: None
+   // Postconditions: The count name is increased by value
+   // Return value: None
+   // Functions called: None
+   void addCount(const string& name, size_t value);
+
+   //--------------------------------------------------------------------------
+   // void writeSummary(ostream& out) const;
+   // Writes one line for each phase and each count
+   // Preconditions: out is open
+   // Postconditions: Summary written
+   // Return value: None
+   // Functions called: None
+   void writeSummary(ostream& out) const;
+
+   //--------------------------------------------------------------------------
+   // void writeJson(ostream& out) const;
+   // Writes the phases and counts as a JSON object on one line:
+   // {"phases":{"name":seconds,...},"counts":{"name":value,...}}
+   // Preconditions: out is open
+   // Postconditions: JSON written
+   // Return value: None
+   // Functions called: writeJsonString
+   void writeJson(ostream& out) const;
+};
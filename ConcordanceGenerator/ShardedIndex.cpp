@@ -0,0 +1,330 @@
+// ShardedIndex.cpp
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A ShardedIndex holds the same concordance as a BST, split into shards
+// that many threads can add keywords to at once. Every keyword goes to the
+// shard of its first byte, and each shard is a BST of its own behind a lock
+// of its own, so threads adding keywords that start differently never wait
+// on each other. Shards are in the order of their first bytes, which is
+// the order the BST compares keywords in, so walking the shards in turn
+// and each shard's BST in order visits every keyword in sorted order, and
+// the concordance is displayed and queried just as from one BST.
+// Each thread reads a chunk of the text into a ChunkWriter, which keeps
+// the chunk's keywords apart by shard, and then adds them to every shard.
+// A keyword's Postings must be added to in order of offset, so the chunks
+// are numbered in order and a shard takes a chunk's keywords only once it
+// has taken those of every chunk before it; a thread whose chunk's turn
+// has not yet come waits on that shard. While it does, the threads of
+// earlier chunks are adding to the shards ahead of it, so each shard is
+// added to by one thread at a time but every shard can be busy at once.
+// The concordance is the same as read on one thread into one BST.
+//
+// Inputs:
+// -- The Corpus the keywords were read from
+// -- The keywords of each chunk of the Corpus and the offset of each
+//    occurrence, from any number of threads at once
+//
+// Outputs:
+// -- Displaying the concordance of every keyword, or of the keywords
+//    matching a KeywordQuery
+//
+// Assumptions:
+// -- Chunks are numbered from 0 in order of offset, and every chunk is
+//    added exactly once
+//
+// Major algorithms & key variables:
+// Algorithms: Range partitioning by first byte, a lock and ticket for each
+// shard, merging sorted shards by concatenation
+// Key Variables: unique_ptr<Shard[]> shards; size_t nextChunk
+
+
+#include "ShardedIndex.h"
+#include "KeywordQuery.h"
+#include "Corpus.h"
+#include "RunStats.h"
+
+//--------------------------------------------------------------------------
+// ShardedIndex();
+// Constructor for ShardedIndex
+// Preconditions: Memory available
+// Postconditions: ShardedIndex with NUM_SHARDS empty shards, waiting
+//                 for chunk 0
+// Return value: None
+// Functions called: None
+ShardedIndex::ShardedIndex() : shards(new Shard[NUM_SHARDS]) {
+   corpus = nullptr;
+   showSources = false;
+}
+
+//--------------------------------------------------------------------------
+// static size_t shardOf(const string& keyword);
+// Preconditions: None
+// Postconditions: None
+// Return value: The shard keyword belongs in, which is its first byte,
+//               or 0 for an empty keyword as it comes before every other
+// Functions called: None
+size_t ShardedIndex::shardOf(const string& keyword) {
+   return keyword.empty() ? 0 : size_t((unsigned char)keyword[0]);
+}
+
+//--------------------------------------------------------------------------
+// void addBatch(size_t shard, size_t chunk, Batch& batch);
+// Waits for the chunk's turn at shard, adds the keywords of batch to its
+// BST and passes the turn on to the next chunk
+// Preconditions: Every chunk before chunk is or will be added to shard
+// Postconditions: batch is empty, its keywords added to shard
+// Return value: None
+// Functions called: addKeyword
+void ShardedIndex::addBatch(size_t shard, size_t chunk, Batch& batch) {
+   Shard& to = shards[shard];
+   unique_lock<mutex> held(to.lock);
+   if (to.nextChunk != chunk) {
+      to.numWaits++;
+      while (to.nextChunk != chunk) {
+         to.turn.wait(held);
+      }
+   }
+   string keyword;
+   size_t start = 0;
+   for (size_t i = 0; i < batch.offsets.size(); i++) {
+      keyword.assign(batch.characters, start, batch.ends[i] - start);
+      to.tree.addKeyword(keyword, batch.offsets[i]);
+      start = batch.ends[i];
+   }
+   to.nextChunk++;
+   held.unlock();
+   // every thread waiting at the shard checks whether its turn has come
+   to.turn.notify_all();
+   batch.characters.clear();
+   batch.ends.clear();
+   batch.offsets.clear();
+}
+
+//--------------------------------------------------------------------------
+// ChunkWriter(ShardedIndex& theIndex);
+// Constructor for a ChunkWriter
+// Preconditions: None
+// Postconditions: ChunkWriter with no keywords, adding to theIndex
+// Return value: None
+// Functions called: None
+ShardedIndex::ChunkWriter::ChunkWriter(ShardedIndex& theIndex) 
+   : index(theIndex), batches(NUM_SHARDS) {
+}
+
+//--------------------------------------------------------------------------
+// void addKeyword(const string& toAdd, size_t offset);
+// Writes toAdd and offset into the batch of toAdd's shard
+// Preconditions: offset is after every offset already written
+// Postconditions: toAdd written
+// Return value: None
+// Functions called: shardOf
+void ShardedIndex::ChunkWriter::addKeyword(const string& toAdd, 
+                                           size_t offset) {
+   Batch& batch = batches[shardOf(toAdd)];
+   batch.characters += toAdd;
+   batch.ends.push_back(batch.characters.length());
+   batch.offsets.push_back(offset);
+}
+
+//--------------------------------------------------------------------------
+// void addChunk(size_t chunk);
+// Adds the keywords written to every shard of the ShardedIndex as
+// those of chunk, waiting at each shard for chunk's turn
+// Preconditions: The keywords written are those of chunk
+// Postconditions: ChunkWriter empty, ready for another chunk
+// Return value: None
+// Functions called: addBatch
+void ShardedIndex::ChunkWriter::addChunk(size_t chunk) {
+   // a shard the chunk has no keywords for still takes its turn, so that
+   // the chunks after it are not kept waiting
+   for (size_t i = 0; i < NUM_SHARDS; i++) {
+      index.addBatch(i, chunk, batches[i]);
+   }
+}
+
+//--------------------------------------------------------------------------
+// void setCorpus(const Corpus* theCorpus);
+// Sets the Corpus that keyword offsets refer into
+// Preconditions: theCorpus stays open while displayed
+// Postconditions: Concordances are read from theCorpus
+// Return value: None
+// Functions called: None
+void ShardedIndex::setCorpus(const Corpus* theCorpus) {
+   corpus = theCorpus;
+}
+
+//--------------------------------------------------------------------------
+// void setShowSources(bool show);
+// Sets whether each concordance is followed by the name of its source
+// file and the position of the keyword in it
+// Preconditions: None
+// Postconditions: Concordances displayed from now on show their source
+//                 if show
+// Return value: None
+// Functions called: None
+void ShardedIndex::setShowSources(bool show) {
+   showSources = show;
+}
+
+//--------------------------------------------------------------------------
+// void setLayout(const ConcordWriter::Layout& newLayout);
+// Sets how many words are shown either side of each keyword and how wide
+// the concordances and keyword are
+// Preconditions: Every number of newLayout is at least 1
+// Postconditions: Concordances displayed from now on follow newLayout
+// Return value: None
+// Functions called: None
+void ShardedIndex::setLayout(const ConcordWriter::Layout& newLayout) {
+   layout = newLayout;
+}
+
+//--------------------------------------------------------------------------
+// void setArenaBlockSize(size_t bytes);
+// Sets the largest block the Arena of each shard will grow to
+// Preconditions: None
+// Postconditions: Arena blocks allocated from now on are at most bytes
+// Return value: None
+// Functions called: setArenaBlockSize
+void ShardedIndex::setArenaBlockSize(size_t bytes) {
+   for (size_t i = 0; i < NUM_SHARDS; i++) {
+      shards[i].tree.setArenaBlockSize(bytes);
+   }
+}
+
+//--------------------------------------------------------------------------
+// void displayTree();
+// Displays the concordance of every keyword, shard by shard in order,
+// through one ConcordWriter
+// Preconditions: Every chunk added
+// Postconditions: ShardedIndex unchanged
+// Return value: Outputs the entire concordance
+// Functions called: next, displayNode
+void ShardedIndex::displayTree() {
+   ConcordWriter writer(cout);
+   writer.setCorpus(corpus);
+   writer.setShowSources(showSources);
+   writer.setLayout(layout);
+   for (size_t i = 0; i < NUM_SHARDS; i++) {
+      for (BST::Iterator at(shards[i].tree); at.isValid(); at.next()) {
+         BST::displayNode(at.node(), writer);
+      }
+   }
+}
+
+//--------------------------------------------------------------------------
+// size_t displayQuery(const KeywordQuery& query, string& next);
+// Displays the concordances of the keywords matching query, from the
+// shard its first keyword would be in onwards, up to the query's limit
+// Preconditions: Every chunk added
+// Postconditions: ShardedIndex unchanged, next is the first matching
+//                 keyword left undisplayed by the limit, or empty if
+//                 there is none
+// Return value: Number of keywords displayed
+// Functions called: shardOf, seek, isPastEnd, next, displayNode
+size_t ShardedIndex::displayQuery(const KeywordQuery& query, string& next) {
+   ConcordWriter writer(cout);
+   writer.setCorpus(corpus);
+   writer.setShowSources(showSources);
+   writer.setLayout(layout);
+   size_t displayed = 0;
+   next.clear();
+   // only the first shard searched can hold keywords before the start
+   for (size_t i = shardOf(query.start()); i < NUM_SHARDS; i++) {
+      BST::Iterator at(shards[i].tree);
+      at.seek(query.start().data(), query.start().length());
+      while (at.isValid() && 
+             !query.isPastEnd(at.keyword(), at.keyLength())) {
+         if (displayed == query.getLimit()) {
+            next.assign(at.keyword(), at.keyLength());
+            return displayed;
+         }
+         BST::displayNode(at.node(), writer);
+         displayed++;
+         at.next();
+      }
+   }
+   return displayed;
+}
+
+//--------------------------------------------------------------------------
+// bool isEmpty();
+// Preconditions: None
+// Postconditions: ShardedIndex unchanged
+// Return value: True if no shard has a keyword, false otherwise
+// Functions called: isEmpty
+bool ShardedIndex::isEmpty() {
+   for (size_t i = 0; i < NUM_SHARDS; i++) {
+      if (!shards[i].tree.isEmpty()) {
+         return false;
+      }
+   }
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// Arena::Stats getArenaStats() const;
+// Preconditions: None
+// Postconditions: ShardedIndex unchanged
+// Return value: Stats of the Arenas of every shard, added together
+// Functions called: getArenaStats
+Arena::Stats ShardedIndex::getArenaStats() const {
+   Arena::Stats total = Arena::Stats();
+   for (size_t i = 0; i < NUM_SHARDS; i++) {
+      Arena::Stats stats = shards[i].tree.getArenaStats();
+      total.bytesAllocated += stats.bytesAllocated;
+      total.bytesReserved += stats.bytesReserved;
+      total.numAllocations += stats.numAllocations;
+      total.numBlocks += stats.numBlocks;
+   }
+   return total;
+}
+
+//--------------------------------------------------------------------------
+// void addStats(RunStats& stats) const;
+// Adds the number of shards holding keywords and how often a thread
+// waited for its chunk's turn at a shard to stats, along with the
+// BSTNodes, comparisons, occurrences, posting bytes and Arenas of every
+// shard added together and the height of the tallest shard
+// Preconditions: None
+// Postconditions: ShardedIndex unchanged
+// Return value: None
+// Functions called: addCount, getStats, height, size, numBytes
+void ShardedIndex::addStats(RunStats& stats) const {
+   size_t numUsed = 0;
+   size_t numWaits = 0;
+   size_t numNodes = 0;
+   int tallest = 0;
+   size_t numComparisons = 0;
+   size_t numOccurrences = 0;
+   size_t postingBytes = 0;
+   for (size_t i = 0; i < NUM_SHARDS; i++) {
+      const BST& tree = shards[i].tree;
+      numWaits += shards[i].numWaits;
+      if (tree.root == nullptr) {
+         continue;
+      }
+      numUsed++;
+      numNodes += tree.numNodes;
+      numComparisons += tree.numComparisons;
+      if (BST::height(tree.root) > tallest) {
+         tallest = BST::height(tree.root);
+      }
+      for (BST::Iterator at(tree); at.isValid(); at.next()) {
+         numOccurrences += at.node()->concord.size();
+         postingBytes += at.node()->concord.numBytes();
+      }
+   }
+   Arena::Stats arenaStats = getArenaStats();
+   stats.addCount("index shards", numUsed);
+   stats.addCount("shard waits", numWaits);
+   stats.addCount("tree nodes", numNodes);
+   stats.addCount("tree height", size_t(tallest));
+   stats.addCount("key comparisons", numComparisons);
+   stats.addCount("occurrences", numOccurrences);
+   stats.addCount("posting bytes", postingBytes);
+   stats.addCount("arena allocations", arenaStats.numAllocations);
+   stats.addCount("arena bytes allocated", arenaStats.bytesAllocated);
+   stats.addCount("arena bytes reserved", arenaStats.bytesReserved);
+   stats.addCount("arena blocks", arenaStats.numBlocks);
+}
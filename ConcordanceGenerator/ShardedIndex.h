@@ -0,0 +1,252 @@
+// ShardedIndex.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// A ShardedIndex holds the same concordance as a BST, split into shards
+// that many threads can add keywords to at once. Every keyword goes to the
+// shard of its first byte, and each shard is a BST of its own behind a lock
+// of its own, so threads adding keywords that start differently never wait
+// on each other. Shards are in the order of their first bytes, which is
+// the order the BST compares keywords in, so walking the shards in turn
+// and each shard's BST in order visits every keyword in sorted order, and
+// the concordance is displayed and queried just as from one BST.
+// Each thread reads a chunk of the text into a ChunkWriter, which keeps
+// the chunk's keywords apart by shard, and then adds them to every shard.
+// A keyword's Postings must be added to in order of offset, so the chunks
+// are numbered in order and a shard takes a chunk's keywords only once it
+// has taken those of every chunk before it; a thread whose chunk's turn
+// has not yet come waits on that shard. While it does, the threads of
+// earlier chunks are adding to the shards ahead of it, so each shard is
+// added to by one thread at a time but every shard can be busy at once.
+// The concordance is the same as read on one thread into one BST.
+//
+// Inputs:
+// -- The Corpus the keywords were read from
+// -- The keywords of each chunk of the Corpus and the offset of each
+//    occurrence, from any number of threads at once
+//
+// Outputs:
+// -- Displaying the concordance of every keyword, or of the keywords
+//    matching a KeywordQuery
+//
+// Assumptions:
+// -- Chunks are numbered from 0 in order of offset, and every chunk is
+//    added exactly once
+//
+// Major algorithms & key variables:
+// Algorithms: Range partitioning by first byte, a lock and ticket for each
+// shard, merging sorted shards by concatenation
+// Key Variables: unique_ptr<Shard[]> shards; size_t nextChunk
+
+#pragma once
+#include "BST.h"
+#include "Arena.h"
+#include "ConcordWriter.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+using namespace std;
+
+class Corpus;
+class KeywordQuery;
+class RunStats;
+
+class ShardedIndex {
+
+private:
+   // the same for every shard, kept here to display them with one writer
+   const Corpus* corpus;
+   bool showSources;
+   ConcordWriter::Layout layout;
+
+   // a BST for the keywords starting with one byte, the number of the
+   // next chunk it takes keywords from, and how often a thread waited for
+   // its chunk's turn; nextChunk and numWaits are only used under lock
+   struct Shard {
+      BST tree;
+      mutex lock;
+      condition_variable turn;
+      size_t nextChunk = 0;
+      size_t numWaits = 0;
+   };
+
+   // the keywords of one chunk for one shard, one after another in
+   // characters, each ending at its entry of ends and occurring at that of
+   // offsets
+   struct Batch {
+      string characters;
+      vector<size_t> ends;
+      vector<size_t> offsets;
+   };
+
+   unique_ptr<Shard[]> shards;
+
+   //--------------------------------------------------------------------------
+   // static size_t shardOf(const string& keyword);
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: The shard keyword belongs in, which is its first byte,
+   //               or 0 for an empty keyword as it comes before every other
+   // Functions called: None
+   static size_t shardOf(const string& keyword);
+
+   //--------------------------------------------------------------------------
+   // void addBatch(size_t shard, size_t chunk, Batch& batch);
+   // Waits for the chunk's turn at shard, adds the keywords of batch to its
+   // BST and passes the turn on to the next chunk
+   // Preconditions: Every chunk before chunk is or will be added to shard
+   // Postconditions: batch is empty, its keywords added to shard
+   // Return value: None
+   // Functions called: addKeyword
+   void addBatch(size_t shard, size_t chunk, Batch& batch);
+
+   // a ShardedIndex is shared between threads in place and is never copied
+   ShardedIndex(const ShardedIndex&);
+   ShardedIndex& operator=(const ShardedIndex&);
+
+public:
+   // one shard for each value of a keyword's first byte
+   static const size_t NUM_SHARDS = 256;
+
+   // A ChunkWriter is read into by ReadIn as if it were a tree, and keeps
+   // the keywords of a chunk by shard until the chunk is added to the
+   // ShardedIndex. Each thread adding to a ShardedIndex has one of its own.
+   class ChunkWriter {
+
+   private:
+      ShardedIndex& index;
+      vector<Batch> batches;
+
+   public:
+
+      //-----------------------------------------------------------------------
+      // ChunkWriter(ShardedIndex& theIndex);
+      // Constructor for a ChunkWriter
+      // Preconditions: None
+      // Postconditions: ChunkWriter with no keywords, adding to theIndex
+      // Return value: None
+      // Functions called: None
+      ChunkWriter(ShardedIndex& theIndex);
+
+      //-----------------------------------------------------------------------
+      // void addKeyword(const string& toAdd, size_t offset);
+      // Writes toAdd and offset into the batch of toAdd's shard
+      // Preconditions: offset is after every offset already written
+      // Postconditions: toAdd written
+      // Return value: None
+      // Functions called: shardOf
+      void addKeyword(const string& toAdd, size_t offset);
+
+      //-----------------------------------------------------------------------
+      // void addChunk(size_t chunk);
+      // Adds the keywords written to every shard of the ShardedIndex as
+      // those of chunk, waiting at each shard for chunk's turn
+      // Preconditions: The keywords written are those of chunk
+      // Postconditions: ChunkWriter empty, ready for another chunk
+      // Return value: None
+      // Functions called: addBatch
+      void addChunk(size_t chunk);
+   };
+
+   //--------------------------------------------------------------------------
+   // ShardedIndex();
+   // Constructor for ShardedIndex
+   // Preconditions: Memory available
+   // Postconditions: ShardedIndex with NUM_SHARDS empty shards, waiting
+   //                 for chunk 0
+   // Return value: None
+   // Functions called: None
+   ShardedIndex();
+
+   //--------------------------------------------------------------------------
+   // void setCorpus(const Corpus* theCorpus);
+   // Sets the Corpus that keyword offsets refer into
+   // Preconditions: theCorpus stays open while displayed
+   // Postconditions: Concordances are read from theCorpus
+   // Return value: None
+   // Functions called: None
+   void setCorpus(const Corpus* theCorpus);
+
+   //--------------------------------------------------------------------------
+   // void setShowSources(bool show);
+   // Sets whether each concordance is followed by the name of its source
+   // file and the position of the keyword in it
+   // Preconditions: None
+   // Postconditions: Concordances displayed from now on show their source
+   //                 if show
+   // Return value: None
+   // Functions called: None
+   void setShowSources(bool show);
+
+   //--------------------------------------------------------------------------
+   // void setLayout(const ConcordWriter::Layout& newLayout);
+   // Sets how many words are shown either side of each keyword and how wide
+   // the concordances and keyword are
+   // Preconditions: Every number of newLayout is at least 1
+   // Postconditions: Concordances displayed from now on follow newLayout
+   // Return value: None
+   // Functions called: None
+   void setLayout(const ConcordWriter::Layout& newLayout);
+
+   //--------------------------------------------------------------------------
+   // void setArenaBlockSize(size_t bytes);
+   // Sets the largest block the Arena of each shard will grow to
+   // Preconditions: None
+   // Postconditions: Arena blocks allocated from now on are at most bytes
+   // Return value: None
+   // Functions called: setArenaBlockSize
+   void setArenaBlockSize(size_t bytes);
+
+   //--------------------------------------------------------------------------
+   // void displayTree();
+   // Displays the concordance of every keyword, shard by shard in order,
+   // through one ConcordWriter
+   // Preconditions: Every chunk added
+   // Postconditions: ShardedIndex unchanged
+   // Return value: Outputs the entire concordance
+   // Functions called: next, displayNode
+   void displayTree();
+
+   //--------------------------------------------------------------------------
+   // size_t displayQuery(const KeywordQuery& query, string& next);
+   // Displays the concordances of the keywords matching query, from the
+   // shard its first keyword would be in onwards, up to the query's limit
+   // Preconditions: Every chunk added
+   // Postconditions: ShardedIndex unchanged, next is the first matching
+   //                 keyword left undisplayed by the limit, or empty if
+   //                 there is none
+   // Return value: Number of keywords displayed
+   // Functions called: shardOf, seek, isPastEnd, next, displayNode
+   size_t displayQuery(const KeywordQuery& query, string& next);
+
+   //--------------------------------------------------------------------------
+   // bool isEmpty();
+   // Preconditions: None
+   // Postconditions: ShardedIndex unchanged
+   // Return value: True if no shard has a keyword, false otherwise
+   // Functions called: isEmpty
+   bool isEmpty();
+
+   //--------------------------------------------------------------------------
+   // Arena::Stats getArenaStats() const;
+   // Preconditions: None
+   // Postconditions: ShardedIndex unchanged
+   // Return value: Stats of the Arenas of every shard, added together
+   // Functions called: getArenaStats
+   Arena::Stats getArenaStats() const;
+
+   //--------------------------------------------------------------------------
+   // void addStats(RunStats& stats) const;
+   // Adds the number of shards holding keywords and how often a thread
+   // waited for its chunk's turn at a shard to stats, along with the
+   // BSTNodes, comparisons, occurrences, posting bytes and Arenas of every
+   // shard added together and the height of the tallest shard
+   // Preconditions: None
+   // Postconditions: ShardedIndex unchanged
+   // Return value: None
+   // Functions called: addCount, getStats, height, size, numBytes
+   void addStats(RunStats& stats) const;
+};
@@ -0,0 +1,207 @@
+// StopWords.cpp
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// StopWords is the set of words that are never made keywords. It is loaded
+// once at startup, either from a file of whitespace delimited words or 
+// from the default list compiled into the program (the same words as the
+// stopwords.txt shipped alongside it). Words are lowercased as they are
+// added. Lookups hash the word and probe an open addressing table, so each
+// check costs one hash of the word and usually a single comparison. The
+// empty word is always a stop word so that punctuation-only words, which
+// trim to nothing, never become keywords.
+// 
+// Inputs: 
+// -- The name of a stop word file, or nothing for the default list
+//
+// Outputs:
+// -- Whether a given word is a stop word
+//
+// Assumptions:
+// -- Stop words are ASCII
+// 
+// Major algorithms & key variables:
+// Algorithms: Open addressing hash table with linear probing, FNV-1a hash
+// Key Variables: vector<Slot> slots; string pool
+
+#include "StopWords.h"
+#include "MappedFile.h"
+#include "Tokenizer.h"
+#include "WordHash.h"
+#include <cstring>
+
+// same words as stopwords.txt
+static const char* const DEFAULT_STOP_WORDS[] = {
+   "a", "about", "above", "after", "again", "against", "all", "am", "an",
+   "and", "any", "are", "aren't", "as", "at", "be", "because", "been",
+   "before", "being", "below", "between", "both", "but", "by", "can't",
+   "cannot", "could", "couldn't", "did", "didn't", "do", "does", "doesn't",
+   "doing", "don't", "down", "during", "each", "few", "for", "from", "further",
+   "had", "hadn't", "has", "hasn't", "have", "haven't", "having", "he", "he'd",
+   "he'll", "he's", "her", "here", "here's", "hers", "herself", "him",
+   "himself", "his", "how", "how's", "i", "i'd", "i'll", "i'm", "i've", "if",
+   "in", "into", "is", "isn't", "it", "it's", "its", "itself", "let's", "me",
+   "more", "most", "mustn't", "my", "myself", "no", "nor", "not", "of", "off",
+   "on", "once", "only", "or", "other", "ought", "our", "ours", "ourselves",
+   "out", "over", "own", "same", "shan't", "she", "she'd", "she'll", "she's",
+   "should", "shouldn't", "so", "some", "such", "than", "that", "that's",
+   "the", "their", "theirs", "them", "themselves", "then", "there", "there's",
+   "these", "they", "they'd", "they'll", "they're", "they've", "this", "those",
+   "through", "to", "too", "under", "until", "up", "very", "was", "wasn't",
+   "we", "we'd", "we'll", "we're", "we've", "were", "weren't", "what",
+   "what's", "when", "when's", "where", "where's", "which", "while", "who",
+   "who's", "whom", "why", "why's", "with", "won't", "would", "wouldn't",
+   "you", "you'd", "you'll", "you're", "you've", "your", "yours", "yourself",
+   "yourselves"
+};
+
+// the table is kept at most half full so probe sequences stay short
+static const size_t INITIAL_SLOTS = 512;
+
+//--------------------------------------------------------------------------
+// StopWords();
+// Constructor for StopWords
+// Preconditions: Memory available
+// Postconditions: Set contains only the empty word
+// Return value: None
+// Functions called: addWord
+StopWords::StopWords() {
+   numWords = 0;
+   slots.resize(INITIAL_SLOTS);
+   // in the event that there is no data, no file and empty word once
+   // trimming is complete
+   addWord("", 0);
+}
+
+//--------------------------------------------------------------------------
+// bool loadFile(const string& fileName);
+// Adds every whitespace delimited word in fileName to the set
+// Preconditions: StopWords exists
+// Postconditions: Words in fileName are stop words
+// Return value: True if the file could be opened, false otherwise
+// Functions called: addWord, nextToken
+bool StopWords::loadFile(const string& fileName) {
+   MappedFile stopWordFile;
+   if (!stopWordFile.open(fileName)) {
+      return false;
+   }
+   Tokenizer words(stopWordFile.begin(), stopWordFile.end());
+   Token word;
+   while (words.nextToken(word)) {
+      addWord(word.start, word.length);
+   }
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// void loadDefault();
+// Adds the default list of stop words compiled into the program
+// Preconditions: StopWords exists
+// Postconditions: Default words are stop words
+// Return value: None
+// Functions called: addWord
+void StopWords::loadDefault() {
+   size_t count = sizeof(DEFAULT_STOP_WORDS) / sizeof(DEFAULT_STOP_WORDS[0]);
+   for (size_t i = 0; i < count; i++) {
+      addWord(DEFAULT_STOP_WORDS[i], strlen(DEFAULT_STOP_WORDS[i]));
+   }
+}
+
+//--------------------------------------------------------------------------
+// void addWord(const char* word, size_t length);
+// Lowercases the word and adds it to the set if it is not already there
+// Preconditions: word has length characters
+// Postconditions: word is a stop word
+// Return value: None
+// Functions called: lowerCase, hashWord, grow
+void StopWords::addWord(const char* word, size_t length) {
+   string lowered(word, length);
+   if (length > 0) {
+      Tokenizer::lowerCase(&lowered[0], word, length);
+   }
+   if (isStopWord(lowered)) {
+      return;
+   }
+   if ((numWords + 1) * 2 > slots.size()) {
+      grow();
+   }
+   uint32_t hash = hashWord(lowered.data(), length);
+   size_t mask = slots.size() - 1;
+   size_t index = hash & mask;
+   while (slots[index].used) {
+      index = (index + 1) & mask;
+   }
+   slots[index].hash = hash;
+   slots[index].offset = uint32_t(pool.length());
+   slots[index].length = uint32_t(length);
+   slots[index].used = true;
+   pool.append(lowered);
+   numWords++;
+}
+
+//--------------------------------------------------------------------------
+// bool isStopWord(const char* word, size_t length) const;
+// Checks the set for an already lowercased word
+// Preconditions: word has length characters
+// Postconditions: StopWords unchanged
+// Return value: True if word is a stop word, false if not
+// Functions called: hashWord
+bool StopWords::isStopWord(const char* word, size_t length) const {
+   uint32_t hash = hashWord(word, length);
+   size_t mask = slots.size() - 1;
+   size_t index = hash & mask;
+   // an empty Slot ends the probe sequence; the table is never full
+   while (slots[index].used) {
+      const Slot& current = slots[index];
+      if (current.hash == hash && current.length == length &&
+          memcmp(pool.data() + current.offset, word, length) == 0) {
+         return true;
+      }
+      index = (index + 1) & mask;
+   }
+   return false;
+}
+
+//--------------------------------------------------------------------------
+// bool isStopWord(const string& toCheck) const;
+// Checks the set for an already lowercased word
+// Preconditions: StopWords exists
+// Postconditions: StopWords unchanged
+// Return value: True if toCheck is a stop word, false if not
+// Functions called: isStopWord
+bool StopWords::isStopWord(const string& toCheck) const {
+   return isStopWord(toCheck.data(), toCheck.length());
+}
+
+//--------------------------------------------------------------------------
+// size_t size() const;
+// Preconditions: StopWords exists
+// Postconditions: StopWords unchanged
+// Return value: Number of stop words, counting the empty word
+// Functions called: None
+size_t StopWords::size() const {
+   return numWords;
+}
+
+//--------------------------------------------------------------------------
+// void grow();
+// Doubles the number of Slots and reinserts every word
+// Preconditions: StopWords exists
+// Postconditions: Table has room for at least twice as many words
+// Return value: None
+// Functions called: None
+void StopWords::grow() {
+   vector<Slot> oldSlots;
+   oldSlots.swap(slots);
+   slots.resize(oldSlots.size() * 2);
+   size_t mask = slots.size() - 1;
+   for (size_t i = 0; i < oldSlots.size(); i++) {
+      if (oldSlots[i].used) {
+         size_t index = oldSlots[i].hash & mask;
+         while (slots[index].used) {
+            index = (index + 1) & mask;
+         }
+         slots[index] = oldSlots[i];
+      }
+   }
+}
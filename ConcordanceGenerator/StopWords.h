@@ -0,0 +1,121 @@
+// StopWords.h
+// Author: Kelsey Stemm
+// Date: 
+// Description:
+// StopWords is the set of words that are never made keywords. It is loaded
+// once at startup, either from a file of whitespace delimited words or 
+// from the default list compiled into the program (the same words as the
+// stopwords.txt shipped alongside it). Words are lowercased as they are
+// added. Lookups hash the word and probe an open addressing table, so each
+// check costs one hash of the word and usually a single comparison. The
+// empty word is always a stop word so that punctuation-only words, which
+// trim to nothing, never become keywords.
+// 
+// Inputs: 
+// -- The name of a stop word file, or nothing for the default list
+//
+// Outputs:
+// -- Whether a given word is a stop word
+//
+// Assumptions:
+// -- Stop words are UTF-8
+// 
+// Major algorithms & key variables:
+// Algorithms: Open addressing hash table with linear probing, FNV-1a hash
+// Key Variables: vector<Slot> slots; string pool
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class StopWords {
+
+private:
+   struct Slot {
+      uint32_t hash = 0;
+      uint32_t offset = 0;
+      uint32_t length = 0;
+      bool used = false;
+   };
+   // every word added, back to back; Slots refer into it by offset
+   string pool;
+   vector<Slot> slots;
+   size_t numWords;
+
+   //--------------------------------------------------------------------------
+   // void grow();
+   // Doubles the number of Slots and reinserts every word
+   // Preconditions: StopWords exists
+   // Postconditions: Table has room for at least twice as many words
+   // Return value: None
+   // Functions called: None
+   void grow();
+
+public:
+
+   //--------------------------------------------------------------------------
+   // StopWords();
+   // Constructor for StopWords
+   // Preconditions: Memory available
+   // Postconditions: Set contains only the empty word
+   // Return value: None
+   // Functions called: addWord
+   StopWords();
+
+   //--------------------------------------------------------------------------
+   // bool loadFile(const string& fileName);
+   // Adds every whitespace delimited word in fileName to the set
+   // Preconditions: StopWords exists
+   // Postconditions: Words in fileName are stop words
+   // Return value: True if the file could be opened, false otherwise
+   // Functions called: addWord, nextToken
+   bool loadFile(const string& fileName);
+
+   //--------------------------------------------------------------------------
+   // void loadDefault();
+   // Adds the default list of stop words compiled into the program
+   // Preconditions: StopWords exists
+   // Postconditions: Default words are stop words
+   // Return value: None
+   // Functions called: addWord
+   void loadDefault();
+
+   //--------------------------------------------------------------------------
+   // void addWord(const char* word, size_t length);
+   // Lowercases the word and adds it to the set if it is not already there
+   // Preconditions: word has length characters
+   // Postconditions: word is a stop word
+   // Return value: None
+   // Functions called: lowerCase, hashWord, grow
+   void addWord(const char* word, size_t length);
+
+   //--------------------------------------------------------------------------
+   // bool isStopWord(const char* word, size_t length) const;
+   // Checks the set for an already lowercased word
+   // Preconditions: word has length characters
+   // Postconditions: StopWords unchanged
+   // Return value: True if word is a stop word, false if not
+   // Functions called: hashWord
+   bool isStopWord(const char* word, size_t length) const;
+
+   //--------------------------------------------------------------------------
+   // bool isStopWord(const string& toCheck) const;
+   // Checks the set for an already lowercased word
+   // Preconditions: StopWords exists
+   // Postconditions: StopWords unchanged
+   // Return value: True if toCheck is a stop word, false if not
+   // Functions called: isStopWord
+   bool isStopWord(const string& toCheck) const;
+
+   //--------------------------------------------------------------------------
+   // size_t size() const;
+   // Preconditions: StopWords exists
+   // Postconditions: StopWords unchanged
+   // Return value: Number of stop words, counting the empty word
+   // Functions called: None
+   size_t size() const;
+};
@@ -0,0 +1,630 @@
+// Tokenizer.cpp
+// Date: 
+// Description:
+// Tokenizer splits a buffer of UTF-8 text into words delimited by
+// whitespace. Each word is handed back as a Token, a pointer and length
+// into the buffer, so no word is ever copied while tokenizing. Whitespace
+// is the same set the stream extraction operator skips: spaces, tabs, end
+// lines, vertical tabs, form feeds and carriage returns, along with the
+// Unicode spaces such as the no-break and ideographic spaces. Going 
+// forward, the Tokenizer classifies BLOCK_SIZE bytes at once into a mask
+// with one bit for each byte that is whitespace, using AVX2 or SSE2 where
+// the compiler targets them and a byte at a time otherwise, and then moves
+// from word to word by counting the zero bits of the mask rather than
+// testing each byte. The same pass notes whether any byte of the block is
+// not ASCII, and only those blocks are decoded a character at a time to
+// find the Unicode spaces in them, so ASCII text never leaves the fast
+// path. Keywords are lowercased the same way, 16 or 32 bytes at once until
+// a byte that is not ASCII, after which each character is decoded and
+// folded to lowercase where its lowercase is the same number of bytes. A
+// Tokenizer may also be started part way into the buffer and walked 
+// backwards, which is how the words around a keyword are found again when
+// it is displayed; going backwards only ever passes a few words and tests
+// one character at a time.
+// 
+// Inputs: 
+// -- A buffer of text, such as a MappedFile
+//
+// Outputs:
+// -- Tokens for each word in the buffer, in order
+//
+// Assumptions:
+// -- The buffer outlives every Token taken from it
+// -- Bytes that are not well formed UTF-8 are taken one at a time as
+//    punctuation
+// -- Defining CONGEN_NO_SIMD compiles only the byte at a time code
+// 
+// Major algorithms & key variables:
+// Algorithms: SIMD classification of bytes into bit masks, count trailing
+// zeros to find word boundaries, UTF-8 decoding
+// Key Variables: const char* first, current, last; uint64_t spaces
+
+#include "Tokenizer.h"
+#include <cstring>
+#if !defined(CONGEN_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define TOKENIZER_AVX2
+#elif !defined(CONGEN_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define TOKENIZER_SSE2
+#endif
+
+//--------------------------------------------------------------------------
+// Tokenizer(const char* begin, const char* end);
+// Constructor for a Tokenizer over the bytes from begin up to end
+// Preconditions: begin <= end, buffer exists
+// Postconditions: Tokenizer positioned at begin
+// Return value: None
+// Functions called: None
+Tokenizer::Tokenizer(const char* begin, const char* end) {
+   first = begin;
+   current = begin;
+   last = end;
+   blockStart = begin;
+   blockEnd = begin;
+   spaces = 0;
+}
+
+//--------------------------------------------------------------------------
+// Tokenizer(const char* begin, const char* end, const char* position);
+// Constructor for a Tokenizer over the bytes from begin up to end, 
+// starting at position
+// Preconditions: begin <= position <= end, buffer exists
+// Postconditions: Tokenizer positioned at position
+// Return value: None
+// Functions called: None
+Tokenizer::Tokenizer(const char* begin, const char* end, 
+                     const char* position) {
+   first = begin;
+   current = position;
+   last = end;
+   blockStart = position;
+   blockEnd = position;
+   spaces = 0;
+}
+
+//--------------------------------------------------------------------------
+// static uint64_t spaceMask(const char* block, bool& nonAscii);
+// Preconditions: block has BLOCK_SIZE readable bytes
+// Postconditions: nonAscii is true if any byte of block is not ASCII
+// Return value: Mask with bit i set if byte i of block is ASCII 
+//               whitespace
+// Functions called: isSpace
+inline uint64_t Tokenizer::spaceMask(const char* block, bool& nonAscii) {
+   // a byte is whitespace if it is a space, or if it is one of tab to 
+   // carriage return, that is at most 4 once tab is subtracted from it.
+   // A byte is not ASCII if its top bit is set, so the bytes are or'd
+   // together and only the top bits of the result are tested.
+#if defined(TOKENIZER_AVX2)
+   const __m256i space = _mm256_set1_epi8(' ');
+   const __m256i tab = _mm256_set1_epi8('\t');
+   const __m256i range = _mm256_set1_epi8('\r' - '\t');
+   uint64_t mask = 0;
+   __m256i anyBytes = _mm256_setzero_si256();
+   for (int i = 0; i < 2; i++) {
+      __m256i bytes = _mm256_loadu_si256(
+         reinterpret_cast<const __m256i*>(block + 32 * i));
+      __m256i fromTab = _mm256_sub_epi8(bytes, tab);
+      __m256i isSpace = _mm256_or_si256(
+         _mm256_cmpeq_epi8(bytes, space),
+         _mm256_cmpeq_epi8(_mm256_min_epu8(fromTab, range), fromTab));
+      mask |= uint64_t(uint32_t(_mm256_movemask_epi8(isSpace))) << (32 * i);
+      anyBytes = _mm256_or_si256(anyBytes, bytes);
+   }
+   nonAscii = _mm256_movemask_epi8(anyBytes) != 0;
+   return mask;
+#elif defined(TOKENIZER_SSE2)
+   const __m128i space = _mm_set1_epi8(' ');
+   const __m128i tab = _mm_set1_epi8('\t');
+   const __m128i range = _mm_set1_epi8('\r' - '\t');
+   uint64_t mask = 0;
+   __m128i anyBytes = _mm_setzero_si128();
+   for (int i = 0; i < 4; i++) {
+      __m128i bytes = _mm_loadu_si128(
+         reinterpret_cast<const __m128i*>(block + 16 * i));
+      __m128i fromTab = _mm_sub_epi8(bytes, tab);
+      __m128i isSpace = _mm_or_si128(
+         _mm_cmpeq_epi8(bytes, space),
+         _mm_cmpeq_epi8(_mm_min_epu8(fromTab, range), fromTab));
+      mask |= uint64_t(uint32_t(_mm_movemask_epi8(isSpace))) << (16 * i);
+      anyBytes = _mm_or_si128(anyBytes, bytes);
+   }
+   nonAscii = _mm_movemask_epi8(anyBytes) != 0;
+   return mask;
+#else
+   uint64_t mask = 0;
+   unsigned char anyBytes = 0;
+   for (size_t i = 0; i < BLOCK_SIZE; i++) {
+      mask |= uint64_t(isSpace(block[i])) << i;
+      anyBytes |= (unsigned char)block[i];
+   }
+   nonAscii = anyBytes >= 0x80;
+   return mask;
+#endif
+}
+
+//--------------------------------------------------------------------------
+// void loadBlock(const char* start);
+// Classifies the BLOCK_SIZE bytes from start
+// Preconditions: first <= start < last
+// Postconditions: blockStart is start, spaces holds its whitespace
+// Return value: None
+// Functions called: spaceMask, markSpaceCharacters
+void Tokenizer::loadBlock(const char* start) {
+   blockStart = start;
+   blockEnd = start + BLOCK_SIZE;
+   size_t remaining = size_t(last - start);
+   const char* block = start;
+   char padded[BLOCK_SIZE];
+   if (remaining < BLOCK_SIZE) {
+      // the buffer may end where its memory does, so the last bytes are
+      // copied into a block padded with spaces rather than read past the
+      // end
+      memcpy(padded, start, remaining);
+      memset(padded + remaining, ' ', BLOCK_SIZE - remaining);
+      block = padded;
+   }
+   bool nonAscii;
+   spaces = spaceMask(block, nonAscii);
+   if (nonAscii) {
+      markSpaceCharacters();
+   }
+}
+
+//--------------------------------------------------------------------------
+// void markSpaceCharacters();
+// Sets the bits of spaces for the bytes of each Unicode space in the
+// block, including one begun before it or ended after it
+// Preconditions: loadBlock has classified the block
+// Postconditions: spaces marks every whitespace byte of the block
+// Return value: None
+// Functions called: decodeCharacter, isSpaceCharacter
+void Tokenizer::markSpaceCharacters() {
+   // a character begun up to 3 bytes before the block may end in it
+   const char* at = blockStart - first < 3 ? first : blockStart - 3;
+   const char* end = blockEnd < last ? blockEnd : last;
+   while (at < end) {
+      uint32_t codePoint;
+      size_t length = 0;
+      if ((unsigned char)*at >= 0xC0) {
+         length = decodeCharacter(at, last, codePoint);
+      }
+      if (length == 0) {
+         at++;
+         continue;
+      }
+      if (isSpaceCharacter(codePoint)) {
+         for (const char* byte = at; byte < at + length; byte++) {
+            if (byte >= blockStart && byte < blockEnd) {
+               spaces |= uint64_t(1) << (byte - blockStart);
+            }
+         }
+      }
+      at += length;
+   }
+}
+
+//--------------------------------------------------------------------------
+// static int lowestBit(uint64_t bits);
+// Preconditions: bits is not 0
+// Postconditions: None
+// Return value: Position of the lowest set bit of bits
+// Functions called: None
+static inline int lowestBit(uint64_t bits) {
+#if defined(__GNUC__)
+   return __builtin_ctzll(bits);
+#else
+   int position = 0;
+   while ((bits & 1) == 0) {
+      bits >>= 1;
+      position++;
+   }
+   return position;
+#endif
+}
+
+//--------------------------------------------------------------------------
+// static size_t decodeCharacter(const char* at, const char* end,
+//                               uint32_t& codePoint);
+// Decodes the UTF-8 character starting at at
+// Preconditions: at < end
+// Postconditions: codePoint is the character decoded
+// Return value: Number of bytes of the character, 0 if the bytes from at
+//               are not a well formed character ending by end
+// Functions called: None
+size_t Tokenizer::decodeCharacter(const char* at, const char* end,
+                                  uint32_t& codePoint) {
+   const unsigned char* bytes = reinterpret_cast<const unsigned char*>(at);
+   size_t available = size_t(end - at);
+   unsigned char lead = bytes[0];
+   size_t length;
+   // the smallest code point each length may encode, so that no character
+   // is read from more bytes than it needs
+   uint32_t smallest;
+   if (lead < 0x80) {
+      codePoint = lead;
+      return 1;
+   }
+   else if (lead >= 0xC2 && lead <= 0xDF) {
+      length = 2;
+      codePoint = lead & 0x1F;
+      smallest = 0x80;
+   }
+   else if (lead >= 0xE0 && lead <= 0xEF) {
+      length = 3;
+      codePoint = lead & 0x0F;
+      smallest = 0x800;
+   }
+   else if (lead >= 0xF0 && lead <= 0xF4) {
+      length = 4;
+      codePoint = lead & 0x07;
+      smallest = 0x10000;
+   }
+   else {
+      return 0;
+   }
+   if (available < length) {
+      return 0;
+   }
+   for (size_t i = 1; i < length; i++) {
+      if ((bytes[i] & 0xC0) != 0x80) {
+         return 0;
+      }
+      codePoint = (codePoint << 6) | (bytes[i] & 0x3F);
+   }
+   // surrogates are only ever UTF-16, never characters of their own
+   if (codePoint < smallest || codePoint > 0x10FFFF ||
+       (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+      return 0;
+   }
+   return length;
+}
+
+//--------------------------------------------------------------------------
+// static size_t characterBefore(const char* begin, const char* at,
+//                               uint32_t& codePoint);
+// Decodes the UTF-8 character ending at at
+// Preconditions: begin < at
+// Postconditions: codePoint is the character decoded
+// Return value: Number of bytes of the character, 0 if the byte before
+//               at does not end a well formed character from begin
+// Functions called: decodeCharacter
+size_t Tokenizer::characterBefore(const char* begin, const char* at,
+                                  uint32_t& codePoint) {
+   unsigned char lastByte = (unsigned char)at[-1];
+   if (lastByte < 0x80) {
+      codePoint = lastByte;
+      return 1;
+   }
+   // back over at most 3 continuation bytes to the byte leading them
+   const char* lead = at - 1;
+   while (lead > begin && at - lead < 4 && 
+          ((unsigned char)*lead & 0xC0) == 0x80) {
+      lead--;
+   }
+   size_t length = decodeCharacter(lead, at, codePoint);
+   if (length != size_t(at - lead)) {
+      return 0;
+   }
+   return length;
+}
+
+//--------------------------------------------------------------------------
+// static bool isSpaceCharacter(uint32_t codePoint);
+// Preconditions: None
+// Postconditions: None
+// Return value: True if codePoint is ASCII or Unicode whitespace, false
+//               otherwise
+// Functions called: isSpace
+bool Tokenizer::isSpaceCharacter(uint32_t codePoint) {
+   if (codePoint < 0x80) {
+      return isSpace(char(codePoint));
+   }
+   return codePoint == 0x85 || codePoint == 0xA0 || codePoint == 0x1680 ||
+          (codePoint >= 0x2000 && codePoint <= 0x200A) ||
+          codePoint == 0x2028 || codePoint == 0x2029 || 
+          codePoint == 0x202F || codePoint == 0x205F || codePoint == 0x3000;
+}
+
+// the characters outside ASCII that are spaces, punctuation or symbols
+// rather than letters or digits, as ranges in order
+static const uint32_t NON_WORD_RANGES[][2] = {
+   {0x0080, 0x00A9}, {0x00AB, 0x00B1}, {0x00B4, 0x00B4}, {0x00B6, 0x00B8},
+   {0x00BB, 0x00BF}, {0x00D7, 0x00D7}, {0x00F7, 0x00F7}, {0x037E, 0x037E},
+   {0x0387, 0x0387}, {0x055A, 0x055F}, {0x0589, 0x058A}, {0x05BE, 0x05BE},
+   {0x05C0, 0x05C0}, {0x05C3, 0x05C3}, {0x05F3, 0x05F4}, {0x060C, 0x060D},
+   {0x061B, 0x061F}, {0x066A, 0x066D}, {0x06D4, 0x06D4}, {0x0964, 0x0965},
+   {0x0970, 0x0970}, {0x0E4F, 0x0E4F}, {0x0E5A, 0x0E5B}, {0x1680, 0x1680},
+   {0x2000, 0x206F}, {0x20A0, 0x20FF}, {0x2190, 0x2BFF}, {0x2E00, 0x2E7F},
+   {0x3000, 0x3004}, {0x3008, 0x3020}, {0x3030, 0x3030}, {0x303D, 0x303D},
+   {0x30FB, 0x30FB}, {0xFE10, 0xFE1F}, {0xFE30, 0xFE6F}, {0xFF00, 0xFF0F},
+   {0xFF1A, 0xFF20}, {0xFF3B, 0xFF40}, {0xFF5B, 0xFF65}, {0xFFF0, 0xFFFF},
+   {0x1F000, 0x1FAFF}
+};
+
+//--------------------------------------------------------------------------
+// static bool isWordCharacter(uint32_t codePoint);
+// Preconditions: None
+// Postconditions: None
+// Return value: True if codePoint is an ASCII letter or digit, or a
+//               character outside ASCII that is not a space, 
+//               punctuation or symbol, false otherwise
+// Functions called: isAlphanumeric
+bool Tokenizer::isWordCharacter(uint32_t codePoint) {
+   if (codePoint < 0x80) {
+      return isAlphanumeric(char(codePoint));
+   }
+   // binary search for the last range starting at or before codePoint
+   size_t low = 0;
+   size_t high = sizeof(NON_WORD_RANGES) / sizeof(NON_WORD_RANGES[0]);
+   while (low < high) {
+      size_t middle = (low + high) / 2;
+      if (NON_WORD_RANGES[middle][0] <= codePoint) {
+         low = middle + 1;
+      }
+      else {
+         high = middle;
+      }
+   }
+   return low == 0 || codePoint > NON_WORD_RANGES[low - 1][1];
+}
+
+//--------------------------------------------------------------------------
+// static uint32_t lowerCaseCharacter(uint32_t codePoint);
+// Preconditions: None
+// Postconditions: None
+// Return value: The lowercase of codePoint if it is an uppercase letter
+//               of the Latin, Greek, Cyrillic or Armenian alphabets or a
+//               fullwidth Latin letter, whose lowercase is always the 
+//               same number of bytes, codePoint otherwise
+// Functions called: None
+uint32_t Tokenizer::lowerCaseCharacter(uint32_t codePoint) {
+   if (codePoint < 0x80) {
+      if (codePoint - 'A' < 26) {
+         return codePoint + ('a' - 'A');
+      }
+      return codePoint;
+   }
+   // Latin-1 Supplement, but for the multiplication sign
+   if (codePoint >= 0xC0 && codePoint <= 0xDE && codePoint != 0xD7) {
+      return codePoint + 0x20;
+   }
+   // Latin Extended-A pairs its letters upper then lower, in two runs
+   // either side of the odd run from L with acute to n with caron. Capital
+   // I with dot above has no lowercase of the same length.
+   if ((codePoint >= 0x100 && codePoint <= 0x12F) ||
+       (codePoint >= 0x132 && codePoint <= 0x137) ||
+       (codePoint >= 0x14A && codePoint <= 0x177)) {
+      return codePoint | 1;
+   }
+   if ((codePoint >= 0x139 && codePoint <= 0x148) ||
+       (codePoint >= 0x179 && codePoint <= 0x17E)) {
+      return codePoint % 2 == 1 ? codePoint + 1 : codePoint;
+   }
+   if (codePoint == 0x178) {
+      return 0xFF;
+   }
+   // Greek
+   if (codePoint >= 0x391 && codePoint <= 0x3AB && codePoint != 0x3A2) {
+      return codePoint + 0x20;
+   }
+   if (codePoint == 0x386) {
+      return 0x3AC;
+   }
+   if (codePoint >= 0x388 && codePoint <= 0x38A) {
+      return codePoint + 0x25;
+   }
+   if (codePoint == 0x38C) {
+      return 0x3CC;
+   }
+   if (codePoint == 0x38E || codePoint == 0x38F) {
+      return codePoint + 0x3F;
+   }
+   // Cyrillic, then its letters paired upper then lower
+   if (codePoint >= 0x400 && codePoint <= 0x40F) {
+      return codePoint + 0x50;
+   }
+   if (codePoint >= 0x410 && codePoint <= 0x42F) {
+      return codePoint + 0x20;
+   }
+   if ((codePoint >= 0x460 && codePoint <= 0x481) ||
+       (codePoint >= 0x48A && codePoint <= 0x4BF) ||
+       (codePoint >= 0x4D0 && codePoint <= 0x52F)) {
+      return codePoint | 1;
+   }
+   if (codePoint >= 0x4C1 && codePoint <= 0x4CE) {
+      return codePoint % 2 == 1 ? codePoint + 1 : codePoint;
+   }
+   if (codePoint == 0x4C0) {
+      return 0x4CF;
+   }
+   // Armenian
+   if (codePoint >= 0x531 && codePoint <= 0x556) {
+      return codePoint + 0x30;
+   }
+   // Latin Extended Additional, paired upper then lower
+   if ((codePoint >= 0x1E00 && codePoint <= 0x1E95) ||
+       (codePoint >= 0x1EA0 && codePoint <= 0x1EFF)) {
+      return codePoint | 1;
+   }
+   // fullwidth Latin
+   if (codePoint >= 0xFF21 && codePoint <= 0xFF3A) {
+      return codePoint + 0x20;
+   }
+   return codePoint;
+}
+
+//--------------------------------------------------------------------------
+// static void encodeCharacter(uint32_t codePoint, char* to, 
+//                             size_t length);
+// Preconditions: codePoint is encoded in length bytes, to holds them
+// Postconditions: to holds the UTF-8 bytes of codePoint
+// Return value: None
+// Functions called: None
+static void encodeCharacter(uint32_t codePoint, char* to, size_t length) {
+   static const unsigned char LEADS[] = {0, 0, 0xC0, 0xE0, 0xF0};
+   for (size_t i = length - 1; i > 0; i--) {
+      to[i] = char(0x80 | (codePoint & 0x3F));
+      codePoint >>= 6;
+   }
+   to[0] = char(LEADS[length] | codePoint);
+}
+
+//--------------------------------------------------------------------------
+// static void lowerCase(char* to, const char* from, size_t length);
+// Copies length bytes from from to to with each letter lowercased by
+// lowerCaseCharacter, leaving the bytes the same length
+// Preconditions: Both hold length bytes, to is from or does not overlap
+//                it
+// Postconditions: to holds the lowercase bytes
+// Return value: None
+// Functions called: decodeCharacter, lowerCaseCharacter
+void Tokenizer::lowerCase(char* to, const char* from, size_t length) {
+   size_t i = 0;
+   // a byte is uppercase if it is at most 25 once 'A' is subtracted from
+   // it, and is then lowered by adding 32. The first bytes that are not
+   // ASCII end the fast path, and the rest are lowered a character at a
+   // time.
+#if defined(TOKENIZER_AVX2)
+   const __m256i upperA = _mm256_set1_epi8('A');
+   const __m256i range = _mm256_set1_epi8('Z' - 'A');
+   const __m256i toLower = _mm256_set1_epi8('a' - 'A');
+   for (; i + 32 <= length; i += 32) {
+      __m256i bytes = _mm256_loadu_si256(
+         reinterpret_cast<const __m256i*>(from + i));
+      if (_mm256_movemask_epi8(bytes) != 0) {
+         break;
+      }
+      __m256i fromA = _mm256_sub_epi8(bytes, upperA);
+      __m256i isUpper = _mm256_cmpeq_epi8(
+         _mm256_min_epu8(fromA, range), fromA);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(to + i),
+         _mm256_add_epi8(bytes, _mm256_and_si256(isUpper, toLower)));
+   }
+#elif defined(TOKENIZER_SSE2)
+   const __m128i upperA = _mm_set1_epi8('A');
+   const __m128i range = _mm_set1_epi8('Z' - 'A');
+   const __m128i toLower = _mm_set1_epi8('a' - 'A');
+   for (; i + 16 <= length; i += 16) {
+      __m128i bytes = _mm_loadu_si128(
+         reinterpret_cast<const __m128i*>(from + i));
+      if (_mm_movemask_epi8(bytes) != 0) {
+         break;
+      }
+      __m128i fromA = _mm_sub_epi8(bytes, upperA);
+      __m128i isUpper = _mm_cmpeq_epi8(_mm_min_epu8(fromA, range), fromA);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i),
+         _mm_add_epi8(bytes, _mm_and_si128(isUpper, toLower)));
+   }
+#endif
+   while (i < length) {
+      char letter = from[i];
+      if ((unsigned char)letter < 0x80) {
+         if ((unsigned char)(letter - 'A') < 26) {
+            letter = char(letter + ('a' - 'A'));
+         }
+         to[i] = letter;
+         i++;
+         continue;
+      }
+      uint32_t codePoint;
+      size_t characterLength = decodeCharacter(from + i, from + length, 
+                                               codePoint);
+      if (characterLength == 0) {
+         // not well formed, so copied as it is
+         to[i] = letter;
+         i++;
+         continue;
+      }
+      encodeCharacter(lowerCaseCharacter(codePoint), to + i, 
+                      characterLength);
+      i += characterLength;
+   }
+}
+
+//--------------------------------------------------------------------------
+// bool nextToken(Token& word);
+// Finds the next word in the buffer
+// Preconditions: Tokenizer exists
+// Postconditions: word refers to the next word, Tokenizer moved past it
+// Return value: True if a word was found, false at the end of the buffer
+// Functions called: loadBlock
+bool Tokenizer::nextToken(Token& word) {
+   // pass the whitespace: the first clear bit at or after current
+   for (;;) {
+      if (current >= last) {
+         current = last;
+         return false;
+      }
+      if (current < blockStart || current >= blockEnd) {
+         loadBlock(current);
+      }
+      uint64_t words = ~spaces >> (current - blockStart);
+      if (words != 0) {
+         current += lowestBit(words);
+         break;
+      }
+      current = blockEnd;
+   }
+   // then the word: the first set bit after its start, which is found
+   // before the end of the buffer as bits past the end are set
+   const char* wordStart = current;
+   for (;;) {
+      if (current >= blockEnd) {
+         loadBlock(current);
+      }
+      uint64_t ends = spaces >> (current - blockStart);
+      if (ends != 0) {
+         current += lowestBit(ends);
+         break;
+      }
+      current = blockEnd;
+   }
+   word.start = wordStart;
+   word.length = size_t(current - wordStart);
+   return true;
+}
+
+//--------------------------------------------------------------------------
+// size_t spaceBefore(const char* at) const;
+// Preconditions: first < at <= last
+// Postconditions: Tokenizer unchanged
+// Return value: Number of bytes of the whitespace character ending at
+//               at, 0 if the character there is not whitespace
+// Functions called: characterBefore, isSpaceCharacter
+size_t Tokenizer::spaceBefore(const char* at) const {
+   if ((unsigned char)at[-1] < 0x80) {
+      return isSpace(at[-1]) ? 1 : 0;
+   }
+   uint32_t codePoint;
+   size_t length = characterBefore(first, at, codePoint);
+   if (length == 0 || !isSpaceCharacter(codePoint)) {
+      return 0;
+   }
+   return length;
+}
+
+//--------------------------------------------------------------------------
+// bool previousToken(Token& word);
+// Finds the word before the current position in the buffer
+// Preconditions: Tokenizer exists
+// Postconditions: word refers to the previous word, Tokenizer moved to
+//                 the start of it
+// Return value: True if a word was found, false at the start of the buffer
+// Functions called: spaceBefore
+bool Tokenizer::previousToken(Token& word) {
+   size_t spaceLength;
+   while (current != first && (spaceLength = spaceBefore(current)) > 0) {
+      current -= spaceLength;
+   }
+   if (current == first) {
+      return false;
+   }
+   const char* wordEnd = current;
+   while (current != first && spaceBefore(current) == 0) {
+      current--;
+   }
+   word.start = current;
+   word.length = size_t(wordEnd - current);
+   return true;
+}
@@ -0,0 +1,229 @@
+// Tokenizer.h
+// Date: 
+// Description:
+// Tokenizer splits a buffer of UTF-8 text into words delimited by
+// whitespace. Each word is handed back as a Token, a pointer and length
+// into the buffer, so no word is ever copied while tokenizing. Whitespace
+// is the same set the stream extraction operator skips: spaces, tabs, end
+// lines, vertical tabs, form feeds and carriage returns, along with the
+// Unicode spaces such as the no-break and ideographic spaces. Going 
+// forward, the Tokenizer classifies BLOCK_SIZE bytes at once into a mask
+// with one bit for each byte that is whitespace, using AVX2 or SSE2 where
+// the compiler targets them and a byte at a time otherwise, and then moves
+// from word to word by counting the zero bits of the mask rather than
+// testing each byte. The same pass notes whether any byte of the block is
+// not ASCII, and only those blocks are decoded a character at a time to
+// find the Unicode spaces in them, so ASCII text never leaves the fast
+// path. Keywords are lowercased the same way, 16 or 32 bytes at once until
+// a byte that is not ASCII, after which each character is decoded and
+// folded to lowercase where its lowercase is the same number of bytes. A
+// Tokenizer may also be started part way into the buffer and walked 
+// backwards, which is how the words around a keyword are found again when
+// it is displayed; going backwards only ever passes a few words and tests
+// one character at a time.
+// 
+// Inputs: 
+// -- A buffer of text, such as a MappedFile
+//
+// Outputs:
+// -- Tokens for each word in the buffer, in order
+//
+// Assumptions:
+// -- The buffer outlives every Token taken from it
+// -- Bytes that are not well formed UTF-8 are taken one at a time as
+//    punctuation
+// -- Defining CONGEN_NO_SIMD compiles only the byte at a time code
+// 
+// Major algorithms & key variables:
+// Algorithms: SIMD classification of bytes into bit masks, count trailing
+// zeros to find word boundaries, UTF-8 decoding
+// Key Variables: const char* first, current, last; uint64_t spaces
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct Token {
+   const char* start = nullptr;
+   size_t length = 0;
+};
+
+class Tokenizer {
+
+private:
+   const char* first;
+   const char* current;
+   const char* last;
+   // the block of bytes classified last, with bit i of spaces set if byte
+   // i of it is whitespace or past the end of the buffer
+   const char* blockStart;
+   const char* blockEnd;
+   uint64_t spaces;
+
+   //--------------------------------------------------------------------------
+   // void loadBlock(const char* start);
+   // Classifies the BLOCK_SIZE bytes from start
+   // Preconditions: first <= start < last
+   // Postconditions: blockStart is start, spaces holds its whitespace
+   // Return value: None
+   // Functions called: spaceMask, markSpaceCharacters
+   void loadBlock(const char* start);
+
+   //--------------------------------------------------------------------------
+   // static uint64_t spaceMask(const char* block, bool& nonAscii);
+   // Preconditions: block has BLOCK_SIZE readable bytes
+   // Postconditions: nonAscii is true if any byte of block is not ASCII
+   // Return value: Mask with bit i set if byte i of block is ASCII 
+   //               whitespace
+   // Functions called: isSpace
+   static uint64_t spaceMask(const char* block, bool& nonAscii);
+
+   //--------------------------------------------------------------------------
+   // void markSpaceCharacters();
+   // Sets the bits of spaces for the bytes of each Unicode space in the
+   // block, including one begun before it or ended after it
+   // Preconditions: loadBlock has classified the block
+   // Postconditions: spaces marks every whitespace byte of the block
+   // Return value: None
+   // Functions called: decodeCharacter, isSpaceCharacter
+   void markSpaceCharacters();
+
+   //--------------------------------------------------------------------------
+   // size_t spaceBefore(const char* at) const;
+   // Preconditions: first < at <= last
+   // Postconditions: Tokenizer unchanged
+   // Return value: Number of bytes of the whitespace character ending at
+   //               at, 0 if the character there is not whitespace
+   // Functions called: characterBefore, isSpaceCharacter
+   size_t spaceBefore(const char* at) const;
+
+public:
+   static const size_t BLOCK_SIZE = 64;
+
+   //--------------------------------------------------------------------------
+   // Tokenizer(const char* begin, const char* end);
+   // Constructor for a Tokenizer over the bytes from begin up to end
+   // Preconditions: begin <= end, buffer exists
+   // Postconditions: Tokenizer positioned at begin
+   // Return value: None
+   // Functions called: None
+   Tokenizer(const char* begin, const char* end);
+
+   //--------------------------------------------------------------------------
+   // Tokenizer(const char* begin, const char* end, const char* position);
+   // Constructor for a Tokenizer over the bytes from begin up to end, 
+   // starting at position
+   // Preconditions: begin <= position <= end, buffer exists
+   // Postconditions: Tokenizer positioned at position
+   // Return value: None
+   // Functions called: None
+   Tokenizer(const char* begin, const char* end, const char* position);
+
+   //--------------------------------------------------------------------------
+   // static bool isSpace(char toCheck);
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: True if toCheck is ASCII whitespace, false otherwise
+   // Functions called: None
+   static bool isSpace(char toCheck) {
+      return toCheck == ' ' || (toCheck >= '\t' && toCheck <= '\r');
+   }
+
+   //--------------------------------------------------------------------------
+   // static bool isAlphanumeric(char toCheck);
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: True if toCheck is an ASCII letter or digit, as isalnum
+   //               is in the C locale, false otherwise
+   // Functions called: None
+   static bool isAlphanumeric(char toCheck) {
+      unsigned char letter = (unsigned char)(toCheck | 0x20);
+      return (unsigned char)(letter - 'a') < 26 || 
+             (unsigned char)(toCheck - '0') < 10;
+   }
+
+   //--------------------------------------------------------------------------
+   // static size_t decodeCharacter(const char* at, const char* end,
+   //                               uint32_t& codePoint);
+   // Decodes the UTF-8 character starting at at
+   // Preconditions: at < end
+   // Postconditions: codePoint is the character decoded
+   // Return value: Number of bytes of the character, 0 if the bytes from at
+   //               are not a well formed character ending by end
+   // Functions called: None
+   static size_t decodeCharacter(const char* at, const char* end,
+                                 uint32_t& codePoint);
+
+   //--------------------------------------------------------------------------
+   // static size_t characterBefore(const char* begin, const char* at,
+   //                               uint32_t& codePoint);
+   // Decodes the UTF-8 character ending at at
+   // Preconditions: begin < at
+   // Postconditions: codePoint is the character decoded
+   // Return value: Number of bytes of the character, 0 if the byte before
+   //               at does not end a well formed character from begin
+   // Functions called: decodeCharacter
+   static size_t characterBefore(const char* begin, const char* at,
+                                 uint32_t& codePoint);
+
+   //--------------------------------------------------------------------------
+   // static bool isSpaceCharacter(uint32_t codePoint);
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: True if codePoint is ASCII or Unicode whitespace, false
+   //               otherwise
+   // Functions called: isSpace
+   static bool isSpaceCharacter(uint32_t codePoint);
+
+   //--------------------------------------------------------------------------
+   // static bool isWordCharacter(uint32_t codePoint);
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: True if codePoint is an ASCII letter or digit, or a
+   //               character outside ASCII that is not a space, 
+   //               punctuation or symbol, false otherwise
+   // Functions called: isAlphanumeric
+   static bool isWordCharacter(uint32_t codePoint);
+
+   //--------------------------------------------------------------------------
+   // static uint32_t lowerCaseCharacter(uint32_t codePoint);
+   // Preconditions: None
+   // Postconditions: None
+   // Return value: The lowercase of codePoint if it is an uppercase letter
+   //               of the Latin, Greek, Cyrillic or Armenian alphabets or a
+   //               fullwidth Latin letter, whose lowercase is always the 
+   //               same number of bytes, codePoint otherwise
+   // Functions called: None
+   static uint32_t lowerCaseCharacter(uint32_t codePoint);
+
+   //--------------------------------------------------------------------------
+   // static void lowerCase(char* to, const char* from, size_t length);
+   // Copies length bytes from from to to with each letter lowercased by
+   // lowerCaseCharacter, leaving the bytes the same length
+   // Preconditions: Both hold length bytes, to is from or does not overlap
+   //                it
+   // Postconditions: to holds the lowercase bytes
+   // Return value: None
+   // Functions called: decodeCharacter, lowerCaseCharacter
+   static void lowerCase(char* to, const char* from, size_t length);
+
+   //--------------------------------------------------------------------------
+   // bool nextToken(Token& word);
+   // Finds the next word in the buffer
+   // Preconditions: Tokenizer exists
+   // Postconditions: word refers to the next word, Tokenizer moved past it
+   // Return value: True if a word was found, false at the end of the buffer
+   // Functions called: loadBlock
+   bool nextToken(Token& word);
+
+   //--------------------------------------------------------------------------
+   // bool previousToken(Token& word);
+   // Finds the word before the current position in the buffer
+   // Preconditions: Tokenizer exists
+   // Postconditions: word refers to the previous word, Tokenizer moved to
+   //                 the start of it
+   // Return value: True if a word was found, false at the start of the buffer
+   // Functions called: spaceBefore
+   bool previousToken(Token& word);
+};
@@ -0,0 +1,44 @@
+// WordHash.h
+// Author: Kelsey Stemm
+// Date:
+// Description:
+// The hash of a word used by every hash table of words, StopWords and
+// KeywordCounter alike. It is the FNV-1a hash: each byte of the word is
+// mixed in with an exclusive or and a multiplication by a prime, which is
+// quick for the short words of a text and spreads them evenly over a table
+// whose size is a power of two.
+//
+// Inputs:
+// -- The characters of a word
+//
+// Outputs:
+// -- The word's hash
+//
+// Assumptions:
+// -- None
+//
+// Major algorithms & key variables:
+// Algorithms: FNV-1a hash
+// Key Variables: uint32_t hash
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+//--------------------------------------------------------------------------
+// inline uint32_t hashWord(const char* word, size_t length);
+// FNV-1a hash of the word's characters
+// Preconditions: word has length characters
+// Postconditions: None
+// Return value: The hash of the word
+// Functions called: None
+inline uint32_t hashWord(const char* word, size_t length) {
+   uint32_t hash = 2166136261u;
+   for (size_t i = 0; i < length; i++) {
+      hash ^= (unsigned char)word[i];
+      hash *= 16777619u;
+   }
+   return hash;
+}